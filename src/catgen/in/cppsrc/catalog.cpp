@@ -82,11 +82,22 @@ void Catalog::purgeDeletions() {
 }
 
 void Catalog::execute(const string &stmts) {
+    // Payloads are decoded once per process; every engine
+    // then applies the shared commands to its own catalog.
+    boost::shared_ptr<const CatalogCommands> commands = CatalogCommands::parseShared(stmts);
+    execute(*commands);
+}
+
+void Catalog::execute(const CatalogCommands &commands) {
     cleanupExecutionBookkeeping();
 
-    vector<string> lines = MiscUtil::splitString(stmts, '\n');
-    for (int32_t i = 0; i < lines.size(); ++i) {
-        executeOne(lines[i]);
+    for (size_t i = 0; i < commands.size(); ++i) {
+        const CatalogCommands::Command &command = commands.at(i);
+        const string *ref = NULL;
+        if (command.ref != CatalogCommands::PREVIOUS_REF) {
+            ref = &commands.stringAt(command.ref);
+        }
+        executeOne(command.op, ref, commands.stringAt(command.coll), commands.stringAt(command.child));
     }
 
     if (m_unresolved.size() > 0) {
@@ -96,49 +107,13 @@ void Catalog::execute(const string &stmts) {
 }
 
 /*
- * Produce constituent elements of catalog command.
+ * Run one catalog command.  A NULL ref stands for "$PREV", the item of
+ * the previous command.
  */
-static void parse(const string &stmt,
-                  string &command,
-                  string &ref,
-                  string &coll,
-                  string &child)
-{
-    // stmt is formatted as one of:
-    // add ref collection name
-    // set ref fieldname value
-    // ref = path | guid
-    // parsed into strings: command ref coll child
-
-    size_t pos = 0;
-    size_t end = stmt.find(' ', pos);
-    command = stmt.substr(pos, end - pos);
-    pos = end + 1;
-    end = stmt.find(' ', pos);
-    ref = stmt.substr(pos, end - pos);
-    pos = end + 1;
-    end = stmt.find(' ', pos);
-    coll = stmt.substr(pos, end - pos);
-    pos = end + 1;
-    end = stmt.length() + 1;
-    child = stmt.substr(pos, end - pos);
-
-    // cout << std::endl << "Configuring catalog: " << std::endl;
-    // cout << "Command: " << command << endl;
-    // cout << "Ref: " << ref << endl;
-    // cout << "A: " << coll << endl;
-    // cout << "B: " << child << endl;
-}
-
-/*
- * Run one catalog command.
- */
-void Catalog::executeOne(const string &stmt) {
-    string command, ref, coll, child;
-    parse(stmt, command, ref, coll, child);
-
+void Catalog::executeOne(CatalogCommands::Operation op, const string *ref,
+                         const string &coll, const string &child) {
     CatalogType *item = NULL;
-    if (ref.compare("$PREV") == 0) {
+    if (ref == NULL) {
         if (!m_lastUsedPath) {
             // Silently ignore failures -- these are indicative of commands for types
             // that the EE doesn't need/support (hopefully).
@@ -149,7 +124,7 @@ void Catalog::executeOne(const string &stmt) {
         item = m_lastUsedPath;
     }
     else {
-        item = itemForRef(ref);
+        item = itemForRef(*ref);
         if (item == NULL) {
             // Silently ignore failures -- these are indicative of commands for types
             // that the EE doesn't need/support (hopefully).
@@ -162,7 +137,8 @@ void Catalog::executeOne(const string &stmt) {
     }
 
     // execute
-    if (command.compare("add") == 0) {
+    switch (op) {
+    case CatalogCommands::ADD: {
         CatalogType *type = item->addChild(coll, child);
         if (type == NULL) {
             // Silently ignore failures -- these are indicative of commands for types
@@ -173,16 +149,17 @@ void Catalog::executeOne(const string &stmt) {
         }
         type->added();
         resolveUnresolvedInfo(type->path());
+        break;
     }
-    else if (command.compare("set") == 0) {
+    case CatalogCommands::SET:
         item->set(coll, child);
         item->updated();
-    }
-    else if (command.compare("delete") == 0) {
+        break;
+    case CatalogCommands::DELETE:
         // remove from collection and hash path to the deletion tracker
         // throw if nothing was removed.
         if(item->removeChild(coll, child)) {
-            m_deletions.push_back(ref + "/" + coll + MAP_SEPARATOR + child);
+            m_deletions.push_back(item->path() + "/" + coll + MAP_SEPARATOR + child);
         }
         else {
             // Silently ignore failures -- these are indicative of commands for types
@@ -191,8 +168,8 @@ void Catalog::executeOne(const string &stmt) {
             // for memory usage and simpler code on the java side.
             return;
         }
-    }
-    else {
+        break;
+    default:
         throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
                                       "Invalid catalog command.");
     }
@@ -297,9 +274,8 @@ void Catalog::resolveUnresolvedInfo(string path) {
         std::list<UnresolvedInfo>::const_iterator iter;
         for (iter = lui.begin(); iter != lui.end(); iter++) {
             UnresolvedInfo ui = *iter;
-            std::string path2 = "set " + ui.type->path() + " "
-              + ui.field + " " + path;
-            executeOne(path2);
+            std::string typePath = ui.type->path();
+            executeOne(CatalogCommands::SET, &typePath, ui.field, path);
         }
     }
 }
@@ -29,6 +29,7 @@
 #include "boost/unordered_map.hpp"
 #include "catalogtype.h"
 #include "catalogmap.h"
+#include "catalogcommands.h"
 
 namespace catalog {
 
@@ -63,7 +64,8 @@ protected:
     //  paths of objects recently deleted from the catalog.
     std::vector<std::string> m_deletions;
 
-    void executeOne(const std::string &stmt);
+    void executeOne(CatalogCommands::Operation op, const std::string *ref,
+                    const std::string &coll, const std::string &child);
     CatalogType * itemForPath(const CatalogType *parent, const std::string &path);
     CatalogType * itemForPathPart(const CatalogType *parent, const std::string &pathPart) const;
 
@@ -98,6 +100,11 @@ public:
      */
     void execute(const std::string &stmts);
 
+    /**
+     * Run a decoded stream of catalog commands.
+     */
+    void execute(const CatalogCommands &commands);
+
     /** GETTER: The set of the clusters in this catalog */
     const CatalogMap<Cluster> & clusters() const;
 
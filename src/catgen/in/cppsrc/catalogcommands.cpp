@@ -0,0 +1,173 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* WARNING: THIS FILE IS AUTO-GENERATED
+            DO NOT MODIFY THIS SOURCE
+            ALL CHANGES MUST BE MADE IN THE CATALOG GENERATOR */
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include "catalogcommands.h"
+#include "common/SerializableEEException.h"
+#include "murmur3/MurmurHash3.h"
+
+using namespace voltdb;
+using namespace catalog;
+using namespace std;
+
+namespace {
+
+// Recently decoded payloads shared by all the engines of the process.  Two
+// entries cover the catalog and an update that the sites apply one by one.
+// Entries are looked up by the payload's length and hash, and a hit is
+// confirmed against the kept payload.  Payloads past SHARED_MAX_BYTES in
+// total are decoded but not kept.
+const size_t SHARED_ENTRIES = 2;
+const size_t SHARED_MAX_BYTES = 256 * 1024 * 1024;
+
+struct SharedKey {
+    size_t length;
+    int32_t hash;
+
+    explicit SharedKey(const string &payload)
+        : length(payload.size()),
+          hash(MurmurHash3_x64_128(payload.data(), static_cast<int>(length), 0)) {
+    }
+
+    bool operator==(const SharedKey &other) const {
+        return length == other.length && hash == other.hash;
+    }
+};
+
+struct SharedEntry {
+    SharedKey key;
+    string payload;
+    boost::shared_ptr<const CatalogCommands> commands;
+};
+
+std::mutex s_sharedMutex;
+std::deque<SharedEntry> s_shared;
+
+}
+
+const int32_t CatalogCommands::PREVIOUS_REF;
+
+CatalogCommands::CatalogCommands(const string &payload) {
+    parseText(payload);
+    m_stringIndexes.clear();
+}
+
+boost::shared_ptr<const CatalogCommands> CatalogCommands::parseShared(const string &payload) {
+    // Holding the lock while decoding makes the other engines wait for the
+    // one decode instead of each doing their own.
+    SharedKey key(payload);
+    std::lock_guard<std::mutex> guard(s_sharedMutex);
+    size_t sharedBytes = 0;
+    for (std::deque<SharedEntry>::iterator iter = s_shared.begin(); iter != s_shared.end(); iter++) {
+        if (iter->key == key && iter->payload == payload) {
+            return iter->commands;
+        }
+        sharedBytes += iter->key.length;
+    }
+    boost::shared_ptr<const CatalogCommands> commands(new CatalogCommands(payload));
+    if (key.length > SHARED_MAX_BYTES) {
+        return commands;
+    }
+    SharedEntry entry = { key, payload, commands };
+    s_shared.push_front(entry);
+    sharedBytes += key.length;
+    while (s_shared.size() > SHARED_ENTRIES || sharedBytes > SHARED_MAX_BYTES) {
+        sharedBytes -= s_shared.back().key.length;
+        s_shared.pop_back();
+    }
+    return commands;
+}
+
+int32_t CatalogCommands::intern(const char *data, size_t length) {
+    string value(data, length);
+    boost::unordered_map<string, int32_t>::const_iterator iter = m_stringIndexes.find(value);
+    if (iter != m_stringIndexes.end()) {
+        return iter->second;
+    }
+    int32_t index = static_cast<int32_t>(m_strings.size());
+    m_strings.push_back(value);
+    m_stringIndexes[value] = index;
+    return index;
+}
+
+/*
+ * Each line is formatted as one of:
+ *   add ref collection name
+ *   set ref fieldname value
+ *   delete ref collection name
+ * where ref is a path or $PREV.  The last part runs to the end of the line
+ * and may hold spaces.  Empty lines are skipped.
+ */
+void CatalogCommands::parseText(const string &payload) {
+    const char *data = payload.data();
+    size_t begin = 0;
+    while (begin < payload.size()) {
+        size_t end = payload.find('\n', begin);
+        if (end == string::npos) {
+            end = payload.size();
+        }
+        if (end == begin) {
+            begin = end + 1;
+            continue;
+        }
+
+        size_t parts[4][2];
+        size_t pos = begin;
+        for (int i = 0; i < 3; i++) {
+            const void *space = ::memchr(data + pos, ' ', end - pos);
+            size_t partEnd = space ? static_cast<const char*>(space) - data : end;
+            parts[i][0] = pos;
+            parts[i][1] = partEnd - pos;
+            pos = partEnd < end ? partEnd + 1 : end;
+        }
+        parts[3][0] = pos;
+        parts[3][1] = end - pos;
+
+        Command command;
+        const char *op = data + parts[0][0];
+        if (parts[0][1] == 3 && ::memcmp(op, "add", 3) == 0) {
+            command.op = ADD;
+        }
+        else if (parts[0][1] == 3 && ::memcmp(op, "set", 3) == 0) {
+            command.op = SET;
+        }
+        else if (parts[0][1] == 6 && ::memcmp(op, "delete", 6) == 0) {
+            command.op = DELETE;
+        }
+        else {
+            throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                          "Invalid catalog command.");
+        }
+        if (parts[1][1] == 5 && ::memcmp(data + parts[1][0], "$PREV", 5) == 0) {
+            command.ref = PREVIOUS_REF;
+        }
+        else {
+            command.ref = intern(data + parts[1][0], parts[1][1]);
+        }
+        command.coll = intern(data + parts[2][0], parts[2][1]);
+        command.child = intern(data + parts[3][0], parts[3][1]);
+        m_commands.push_back(command);
+
+        begin = end + 1;
+    }
+}
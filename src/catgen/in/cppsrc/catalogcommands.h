@@ -0,0 +1,95 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* WARNING: THIS FILE IS AUTO-GENERATED
+            DO NOT MODIFY THIS SOURCE
+            ALL CHANGES MUST BE MADE IN THE CATALOG GENERATOR */
+
+#ifndef CATALOG_CATALOG_COMMANDS_H_
+#define CATALOG_CATALOG_COMMANDS_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "boost/shared_ptr.hpp"
+#include "boost/unordered_map.hpp"
+
+namespace catalog {
+
+/**
+ * A decoded stream of catalog commands, built from the text form: newline
+ * separated "add ref collection name", "set ref field value" and
+ * "delete ref collection name" lines.
+ *
+ * Every string in the stream is stored once and the commands refer to them
+ * by index.  An instance is immutable once built, so all the engines of a
+ * process can apply the same one; see parseShared().
+ */
+class CatalogCommands {
+public:
+    enum Operation {
+        ADD = 0,
+        SET = 1,
+        DELETE = 2
+    };
+
+    /** Ref index of commands that apply to the item of the previous command ("$PREV"). */
+    static const int32_t PREVIOUS_REF = -1;
+
+    struct Command {
+        Operation op;
+        int32_t ref;
+        int32_t coll;
+        int32_t child;
+    };
+
+    /**
+     * Decode a text payload.
+     */
+    explicit CatalogCommands(const std::string &payload);
+
+    /**
+     * Decode a payload, or return the instance already decoded from an
+     * identical payload by another engine in this process.
+     */
+    static boost::shared_ptr<const CatalogCommands> parseShared(const std::string &payload);
+
+    size_t size() const {
+        return m_commands.size();
+    }
+
+    const Command &at(size_t index) const {
+        return m_commands[index];
+    }
+
+    const std::string &stringAt(int32_t index) const {
+        return m_strings[index];
+    }
+
+private:
+    void parseText(const std::string &payload);
+    int32_t intern(const char *data, size_t length);
+
+    std::vector<std::string> m_strings;
+    std::vector<Command> m_commands;
+    // Only used while decoding.
+    boost::unordered_map<std::string, int32_t> m_stringIndexes;
+};
+
+}
+
+#endif // CATALOG_CATALOG_COMMANDS_H_
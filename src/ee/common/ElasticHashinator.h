@@ -105,25 +105,41 @@ protected:
         return partitionForToken(hashCode);
     }
 
-    int32_t partitionForToken(int32_t hashCode) const {
-        int32_t min = 0;
-        int32_t max = tokenCount - 1;
+    /*
+     * Given a run of integer keys pick the partition for each, hashing
+     * them together rather than one call at a time.
+     */
+    void hashinateIntegers(const int64_t *values, int32_t count, int32_t *partitions) const {
+        MurmurHash3_x64_128_int64s(values, count, partitions);
+        for (int32_t i = 0; i < count; i++) {
+            // special case this hard to hash value to 0 (in both c++ and java)
+            partitions[i] = values[i] == INT64_MIN ? 0 : partitionForToken(partitions[i]);
+        }
+    }
 
-        while (min <= max) {
-            assert(min >= 0);
-            assert(max >= 0);
-            uint32_t mid = (min + max) >> 1;
-            int32_t midval = tokens[mid * 2];
+    /*
+     * The lookup table gives the range of tokens that can own a hash with
+     * the same top bits, which on a large ring is at most a token or two.
+     */
+    int32_t partitionForToken(int32_t hashCode) const {
+        uint32_t bucket = lookupBucket(hashCode);
+        int32_t min = lookupTable[bucket];
+        if (min < 0) {
+            // The bucket starts before the first token
+            return searchTokens(hashCode);
+        }
+        int32_t max = lookupTable[bucket + 1];
 
-            if (midval < hashCode) {
-                min = mid + 1;
-            } else if (midval > hashCode) {
-                max = mid - 1;
+        // Find the last token <= hashCode; tokens[min] is known to be one
+        while (min < max) {
+            int32_t mid = (min + max + 1) >> 1;
+            if (tokens[mid * 2] <= hashCode) {
+                min = mid;
             } else {
-                return tokens[mid * 2 + 1];
+                max = mid - 1;
             }
         }
-        return tokens[(min - 1) * 2 + 1];
+        return tokens[min * 2 + 1];
     }
 
     std::string debug() const {
@@ -140,12 +156,65 @@ protected:
     }
 
 private:
+    // Number of top bits of a hash used to index the lookup table
+    static const int LOOKUP_BITS = 12;
+    static const uint32_t LOOKUP_BUCKETS = 1 << LOOKUP_BITS;
+
+    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) : tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ) {
+        buildLookupTable();
+    }
+
+    /*
+     * Buckets are ordered like the signed hashes they cover
+     */
+    static uint32_t lookupBucket(int32_t hashCode) {
+        return (static_cast<uint32_t>(hashCode) ^ 0x80000000u) >> (32 - LOOKUP_BITS);
+    }
+
+    /*
+     * Entry i is the index of the last token at or below the lowest hash of
+     * bucket i, or -1 if there is none.  The extra entry closes the last bucket.
+     */
+    void buildLookupTable() {
+        int32_t token = -1;
+        for (uint32_t bucket = 0; bucket < LOOKUP_BUCKETS; bucket++) {
+            int32_t lowest = static_cast<int32_t>((bucket << (32 - LOOKUP_BITS)) ^ 0x80000000u);
+            while (token + 1 < static_cast<int32_t>(tokenCount) && tokens[(token + 1) * 2] <= lowest) {
+                token++;
+            }
+            lookupTable[bucket] = token;
+        }
+        lookupTable[LOOKUP_BUCKETS] = static_cast<int32_t>(tokenCount) - 1;
+    }
+
+    /*
+     * Binary search over the whole ring
+     */
+    int32_t searchTokens(int32_t hashCode) const {
+        int32_t min = 0;
+        int32_t max = tokenCount - 1;
+
+        while (min <= max) {
+            assert(min >= 0);
+            assert(max >= 0);
+            uint32_t mid = (min + max) >> 1;
+            int32_t midval = tokens[mid * 2];
 
-    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) : tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ) {}
+            if (midval < hashCode) {
+                min = mid + 1;
+            } else if (midval > hashCode) {
+                max = mid - 1;
+            } else {
+                return tokens[mid * 2 + 1];
+            }
+        }
+        return tokens[(min - 1) * 2 + 1];
+    }
 
     const int32_t *tokens;
     const uint32_t tokenCount;
     boost::scoped_array<int32_t> tokensOwner;
+    int32_t lookupTable[LOOKUP_BUCKETS + 1];
 
 };
 }
@@ -0,0 +1,185 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/FastBlockCompressor.h"
+
+#include <cstring>
+
+namespace voltdb {
+
+namespace {
+const int HASH_BITS = 14;
+const uint32_t NO_POSITION = UINT32_MAX;
+const size_t MAX_OFFSET = 65535;
+// Like LZ4, leave the tail as literals so matches never run to the very end.
+const size_t LAST_LITERALS = 5;
+
+inline uint32_t read32(const char* p) {
+    uint32_t value;
+    ::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hashPosition(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/** Write the bytes continuing a length which did not fit its nibble. */
+inline bool writeLength(size_t length, char*& out, const char* outEnd) {
+    while (length >= 255) {
+        if (out >= outEnd) {
+            return false;
+        }
+        *out++ = static_cast<char>(255);
+        length -= 255;
+    }
+    if (out >= outEnd) {
+        return false;
+    }
+    *out++ = static_cast<char>(length);
+    return true;
+}
+
+inline bool readLength(size_t& length, const unsigned char*& in, const unsigned char* inEnd) {
+    unsigned char byte;
+    do {
+        if (in >= inEnd) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/** Emit the literals [literals, literals + literalCount) and, if matchLength is non zero, a match. */
+inline bool writeSequence(const char* literals, size_t literalCount, size_t offset, size_t matchLength,
+                          char*& out, const char* outEnd) {
+    if (out >= outEnd) {
+        return false;
+    }
+    char* token = out++;
+    size_t matchCode = (matchLength == 0) ? 0 : matchLength - FastBlockCompressor::MIN_MATCH;
+    *token = static_cast<char>(((literalCount < 15 ? literalCount : 15) << 4) |
+                               (matchCode < 15 ? matchCode : 15));
+    if (literalCount >= 15 && !writeLength(literalCount - 15, out, outEnd)) {
+        return false;
+    }
+    if (static_cast<size_t>(outEnd - out) < literalCount) {
+        return false;
+    }
+    ::memcpy(out, literals, literalCount);
+    out += literalCount;
+    if (matchLength == 0) {
+        return true;
+    }
+    if (outEnd - out < 2) {
+        return false;
+    }
+    *out++ = static_cast<char>(offset & 0xff);
+    *out++ = static_cast<char>(offset >> 8);
+    return matchCode < 15 || writeLength(matchCode - 15, out, outEnd);
+}
+}
+
+const size_t FastBlockCompressor::MIN_MATCH;
+
+size_t FastBlockCompressor::compress(const char* source, size_t length, char* dest, size_t capacity) {
+    uint32_t table[1 << HASH_BITS];
+    ::memset(table, 0xff, sizeof(table));
+
+    char* out = dest;
+    const char* outEnd = dest + capacity;
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + MIN_MATCH + LAST_LITERALS <= length) {
+        uint32_t sequence = read32(source + position);
+        uint32_t& slot = table[hashPosition(sequence)];
+        uint32_t candidate = slot;
+        slot = static_cast<uint32_t>(position);
+        if (candidate == NO_POSITION || position - candidate > MAX_OFFSET ||
+                read32(source + candidate) != sequence) {
+            ++position;
+            continue;
+        }
+
+        size_t matchLength = MIN_MATCH;
+        size_t matchLimit = length - LAST_LITERALS;
+        while (position + matchLength < matchLimit &&
+               source[candidate + matchLength] == source[position + matchLength]) {
+            ++matchLength;
+        }
+        if (!writeSequence(source + anchor, position - anchor, position - candidate, matchLength, out, outEnd)) {
+            return 0;
+        }
+        position += matchLength;
+        anchor = position;
+    }
+    if (!writeSequence(source + anchor, length - anchor, 0, 0, out, outEnd)) {
+        return 0;
+    }
+    return out - dest;
+}
+
+bool FastBlockCompressor::decompress(const char* source, size_t sourceLength, char* dest, size_t length) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+    const unsigned char* inEnd = in + sourceLength;
+    char* out = dest;
+    char* outEnd = dest + length;
+    while (in < inEnd) {
+        unsigned char token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(literalCount, in, inEnd)) {
+            return false;
+        }
+        if (static_cast<size_t>(inEnd - in) < literalCount ||
+                static_cast<size_t>(outEnd - out) < literalCount) {
+            return false;
+        }
+        ::memcpy(out, in, literalCount);
+        in += literalCount;
+        out += literalCount;
+        if (in == inEnd) {
+            // The last sequence has no match.
+            break;
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = token & 0x0f;
+        if (matchLength == 15 && !readLength(matchLength, in, inEnd)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(out - dest) ||
+                static_cast<size_t>(outEnd - out) < matchLength) {
+            return false;
+        }
+        // Matches may overlap their own output, so copy byte by byte.
+        const char* match = out - offset;
+        for (size_t ii = 0; ii < matchLength; ++ii) {
+            out[ii] = match[ii];
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
+
+}
@@ -0,0 +1,57 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FASTBLOCKCOMPRESSOR_H_
+#define FASTBLOCKCOMPRESSOR_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * A small, fast LZ77 block codec for the binary log and stream buffers the
+ * EE hands off, trading ratio for speed in the manner of LZ4.
+ *
+ * A compressed block is a run of sequences.  Each sequence is a token byte
+ * whose high nibble is the literal count and low nibble the match length
+ * minus MIN_MATCH (15 in either nibble means more length bytes follow,
+ * each adding up to 255), the literals, a two byte little endian match
+ * offset and the extra match length bytes.  The last sequence holds only
+ * literals.  Matches reach back at most 64KB.
+ */
+class FastBlockCompressor {
+public:
+    static const size_t MIN_MATCH = 4;
+
+    /**
+     * Compress length bytes from source into at most capacity bytes of dest.
+     * @return the compressed length, or 0 if the result would not fit, in
+     *         which case the block should be sent as is.
+     */
+    static size_t compress(const char* source, size_t length, char* dest, size_t capacity);
+
+    /**
+     * Decompress a block produced by compress() into exactly length bytes.
+     * @return false if the block is corrupt or does not decompress to length.
+     */
+    static bool decompress(const char* source, size_t sourceLength, char* dest, size_t length);
+};
+
+}
+
+#endif // FASTBLOCKCOMPRESSOR_H_
@@ -0,0 +1,253 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/HugePageAllocator.h"
+
+#include "common/debuglog.h"
+#include "common/executorcontext.hpp"
+#include "common/FatalException.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+#ifdef LINUX
+#include <cctype>
+#include <cstdio>
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace voltdb {
+
+namespace {
+// From <numaif.h>, which belongs to libnuma.
+const int MPOL_PREFERRED_POLICY = 1;
+// Large enough for the node masks of any machine we run on.
+const unsigned long MAX_NUMA_NODES = 1024;
+const size_t BITS_PER_MASK_WORD = sizeof(unsigned long) * 8;
+
+inline size_t roundUpToHugePage(size_t size) {
+    return (size + HugePageAllocator::HUGE_PAGE_SIZE - 1) & ~(HugePageAllocator::HUGE_PAGE_SIZE - 1);
+}
+
+HugePageAllocationCounters* currentSiteCounters() {
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    return context == NULL ? NULL : &context->getHugePageAllocationCounters();
+}
+
+#ifdef LINUX
+// Sysfs lists the node of a CPU as a nodeN entry of its directory.
+int32_t nodeOfCpu(int cpu) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR* dir = opendir(path);
+    if (dir == NULL) {
+        return -1;
+    }
+    int32_t node = -1;
+    while (struct dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4])) {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+/**
+ * The node of all the CPUs the calling thread may run on, or -1 if they
+ * span several nodes.  The CPU a thread happens to be on says nothing
+ * about where it will run next unless it is pinned.
+ */
+int32_t nodeOfAffinity() {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) != 0) {
+        return -1;
+    }
+    int32_t node = -1;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if ( ! CPU_ISSET(cpu, &cpus)) {
+            continue;
+        }
+        int32_t cpuNode = nodeOfCpu(cpu);
+        if (cpuNode < 0 || (node >= 0 && cpuNode != node)) {
+            return -1;
+        }
+        node = cpuNode;
+    }
+    return node;
+}
+
+struct NodeMask {
+    explicit NodeMask(int32_t node) {
+        memset(m_words, 0, sizeof(m_words));
+        m_words[node / BITS_PER_MASK_WORD] = 1UL << (node % BITS_PER_MASK_WORD);
+    }
+    unsigned long m_words[MAX_NUMA_NODES / BITS_PER_MASK_WORD];
+};
+#endif
+
+/**
+ * Make the pages of a fresh mapping prefer the site's node.  The thread's
+ * own policy already does that for site threads; this covers the blocks a
+ * site allocates on another thread's behalf.
+ */
+void bindToNode(char* block, size_t size, HugePageAllocationCounters* counters) {
+    if (counters == NULL || counters->numaNode < 0) {
+        return;
+    }
+#ifdef LINUX
+    NodeMask mask(counters->numaNode);
+    if (syscall(SYS_mbind, block, size, MPOL_PREFERRED_POLICY,
+                mask.m_words, MAX_NUMA_NODES, 0) != 0) {
+        ++counters->numaBindFailures;
+    }
+#endif
+}
+}
+
+const size_t HugePageAllocator::HUGE_PAGE_SIZE;
+
+HugePageMode HugePageAllocator::s_mode = HUGE_PAGE_MODE_NONE;
+bool HugePageAllocator::s_bindToNumaNode = false;
+
+void HugePageAllocator::configure(HugePageMode mode, bool bindToNumaNode) {
+    s_mode = mode;
+    s_bindToNumaNode = bindToNumaNode;
+}
+
+int32_t HugePageAllocator::bindCurrentThreadToLocalNode(HugePageAllocationCounters* counters) {
+    if (!s_bindToNumaNode) {
+        return -1;
+    }
+#ifdef LINUX
+    int32_t node = nodeOfAffinity();
+    if (node < 0 || node >= static_cast<int32_t>(MAX_NUMA_NODES)) {
+        VOLT_WARN("Not binding the site thread to a NUMA node: its CPU affinity spans several nodes");
+        ++counters->numaBindFailures;
+        return -1;
+    }
+    NodeMask mask(node);
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_POLICY, mask.m_words, MAX_NUMA_NODES) == 0) {
+        VOLT_DEBUG("Bound the site thread to NUMA node %d", node);
+        counters->numaNode = node;
+        return counters->numaNode;
+    }
+    VOLT_WARN("Unable to bind the site thread to its NUMA node: %s", strerror(errno));
+#endif
+    ++counters->numaBindFailures;
+    return -1;
+}
+
+char* HugePageAllocator::mapHugePages(size_t size, HugePageAllocationCounters* counters) {
+#if defined(LINUX) && defined(MAP_HUGETLB)
+    if (s_mode == HUGE_PAGE_MODE_EXPLICIT) {
+        void* block = ::mmap(NULL, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED) {
+            if (counters != NULL) {
+                ++counters->hugetlbBlocks;
+            }
+            return static_cast<char*>(block);
+        }
+        // No (or not enough) pages reserved in the hugetlbfs pool.
+        if (counters != NULL) {
+            ++counters->fallbacks;
+        }
+    }
+#endif
+    // Over-map by a huge page so that an aligned range can be carved out;
+    // the kernel only backs aligned 2MB ranges with transparent huge pages.
+    size_t paddedSize = size + HUGE_PAGE_SIZE;
+    void* padded = ::mmap(NULL, paddedSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (padded == MAP_FAILED) {
+        return NULL;
+    }
+    char* start = static_cast<char*>(padded);
+    char* block = reinterpret_cast<char*>(roundUpToHugePage(reinterpret_cast<uintptr_t>(start)));
+    size_t head = block - start;
+    size_t tail = paddedSize - head - size;
+    if (head > 0) {
+        ::munmap(start, head);
+    }
+    if (tail > 0) {
+        ::munmap(block + size, tail);
+    }
+#ifdef MADV_HUGEPAGE
+    if (::madvise(block, size, MADV_HUGEPAGE) != 0 && counters != NULL) {
+        // Transparent huge pages are disabled; the mapping still works.
+        ++counters->fallbacks;
+    }
+#else
+    if (counters != NULL) {
+        ++counters->fallbacks;
+    }
+#endif
+    return block;
+}
+
+char* HugePageAllocator::allocate(size_t size, size_t& mappedSize) {
+    if (s_mode != HUGE_PAGE_MODE_NONE && size >= HUGE_PAGE_SIZE) {
+        HugePageAllocationCounters* counters = currentSiteCounters();
+        size_t roundedSize = roundUpToHugePage(size);
+        char* block = mapHugePages(roundedSize, counters);
+        if (block != NULL) {
+            bindToNode(block, roundedSize, counters);
+            if (counters != NULL) {
+                ++counters->mappedBlocks;
+                counters->mappedBytes += roundedSize;
+            }
+            mappedSize = roundedSize;
+            return block;
+        }
+        VOLT_WARN("Unable to map a %zu byte block, falling back to the heap: %s",
+                  roundedSize, strerror(errno));
+        if (counters != NULL) {
+            ++counters->fallbacks;
+        }
+    }
+    mappedSize = 0;
+    char* block = static_cast<char*>(::malloc(size));
+    if (block == NULL) {
+        throwFatalException("Failed to allocate a %zu byte block", size);
+    }
+    return block;
+}
+
+void HugePageAllocator::release(char* block, size_t mappedSize) {
+    if (mappedSize == 0) {
+        ::free(block);
+        return;
+    }
+    if (::munmap(block, mappedSize) != 0) {
+        throwFatalException("Failed to unmap a %zu byte block: %s", mappedSize, strerror(errno));
+    }
+    HugePageAllocationCounters* counters = currentSiteCounters();
+    if (counters != NULL) {
+        --counters->mappedBlocks;
+        counters->mappedBytes -= mappedSize;
+    }
+}
+
+}
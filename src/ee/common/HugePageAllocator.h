@@ -0,0 +1,107 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HUGEPAGEALLOCATOR_H_
+#define HUGEPAGEALLOCATOR_H_
+
+#include "common/types.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Allocation activity of one site's large blocks.  Blocks freed by a site
+ * other than the one which allocated them are charged to the freeing site,
+ * so the current values are only exact in aggregate.
+ */
+struct HugePageAllocationCounters {
+    HugePageAllocationCounters()
+      : numaNode(-1), mappedBlocks(0), mappedBytes(0), hugetlbBlocks(0),
+        fallbacks(0), numaBindFailures(0) {}
+
+    // NUMA node the site's memory prefers, or -1 if it is not bound.
+    int32_t numaNode;
+    // Blocks (and their bytes) currently backed by huge page mappings.
+    int64_t mappedBlocks;
+    int64_t mappedBytes;
+    // Mappings that got pre-reserved (explicit) huge pages.
+    int64_t hugetlbBlocks;
+    // Requests for huge pages which had to settle for something smaller.
+    int64_t fallbacks;
+    int64_t numaBindFailures;
+};
+
+/**
+ * Source of the large, long lived blocks backing tuple storage
+ * (TupleBlock) and the buffer chains of the compacting indexes and
+ * string pools (ContiguousAllocator).
+ *
+ * With huge pages enabled, blocks of at least HUGE_PAGE_SIZE are mapped on
+ * a 2MB boundary and backed by explicit (hugetlbfs) pages or advised to be
+ * backed by transparent huge pages, which cuts the TLB misses of index
+ * lookups into large tables.  Any step that fails degrades to the next one,
+ * ending at malloc(3), and is counted in the allocating site's
+ * HugePageAllocationCounters.
+ *
+ * NUMA binding uses the raw set_mempolicy/mbind system calls so that there
+ * is no dependency on libnuma.  The preferred (not strict) policy is used,
+ * so a node that runs out of memory spills over instead of failing.
+ */
+class HugePageAllocator {
+public:
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /**
+     * Set the process wide mode.  Blocks remember how they were obtained,
+     * so changing the mode never affects the release of existing blocks.
+     */
+    static void configure(HugePageMode mode, bool bindToNumaNode);
+
+    static HugePageMode mode() { return s_mode; }
+
+    static bool hugePagesEnabled() { return s_mode != HUGE_PAGE_MODE_NONE; }
+
+    /**
+     * Make the calling (site) thread prefer memory from the NUMA node its
+     * CPU affinity confines it to, if NUMA binding is configured.  Sites
+     * are pinned by the launcher (e.g. numactl --cpunodebind) and inherit
+     * its affinity; a thread free to run on several nodes is not bound.
+     * @return the node, or -1 if the thread was not bound.
+     */
+    static int32_t bindCurrentThreadToLocalNode(HugePageAllocationCounters* counters);
+
+    /**
+     * Allocate a block of at least size bytes.
+     * @param mappedSize set to the length of the mapping backing the block,
+     *        or 0 if the block came from malloc(3).  Pass it back to release().
+     */
+    static char* allocate(size_t size, size_t& mappedSize);
+
+    static void release(char* block, size_t mappedSize);
+
+private:
+    static char* mapHugePages(size_t size, HugePageAllocationCounters* counters);
+
+    static HugePageMode s_mode;
+    static bool s_bindToNumaNode;
+};
+
+}
+
+#endif // HUGEPAGEALLOCATOR_H_
@@ -0,0 +1,134 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/HugePageAllocatorStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+namespace {
+const char* modeName(HugePageMode mode) {
+    switch (mode) {
+    case HUGE_PAGE_MODE_TRANSPARENT:
+        return "TRANSPARENT";
+    case HUGE_PAGE_MODE_EXPLICIT:
+        return "EXPLICIT";
+    default:
+        return "NONE";
+    }
+}
+}
+
+vector<string> HugePageAllocatorStats::generateHugePageAllocatorStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("HUGE_PAGE_MODE");
+    columnNames.push_back("NUMA_NODE");
+    columnNames.push_back("MAPPED_BLOCKS");
+    columnNames.push_back("MAPPED_BYTES");
+    columnNames.push_back("HUGETLB_BLOCKS");
+    columnNames.push_back("FALLBACKS");
+    columnNames.push_back("NUMA_BIND_FAILURES");
+    return columnNames;
+}
+
+void HugePageAllocatorStats::populateHugePageAllocatorStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    types.push_back(VALUE_TYPE_VARCHAR); columnLengths.push_back(4096); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
+    for (int ii = 0; ii < 5; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* HugePageAllocatorStats::generateEmptyHugePageAllocatorStatsTable() {
+    string name = "Huge page allocator stats temp table";
+    vector<string> columnNames = HugePageAllocatorStats::generateHugePageAllocatorStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    HugePageAllocatorStats::populateHugePageAllocatorStatsSchema(columnTypes, columnLengths,
+                                                                 columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+HugePageAllocatorStats::HugePageAllocatorStats(const HugePageAllocationCounters& counters)
+    : StatsSource(), m_counters(counters), m_mode(), m_lastCounters()
+{
+}
+
+HugePageAllocatorStats::~HugePageAllocatorStats() {
+    m_tableName.free();
+    m_mode.free();
+}
+
+void HugePageAllocatorStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+    m_mode.free();
+    m_mode = ValueFactory::getStringValue(modeName(HugePageAllocator::mode()));
+}
+
+vector<string> HugePageAllocatorStats::generateStatsColumnNames() {
+    return HugePageAllocatorStats::generateHugePageAllocatorStatsColumnNames();
+}
+
+void HugePageAllocatorStats::updateStatsTuple(TableTuple *tuple) {
+    // Mapped blocks and bytes are current values; the rest are cumulative.
+    int64_t hugetlbBlocks = m_counters.hugetlbBlocks;
+    int64_t fallbacks = m_counters.fallbacks;
+    int64_t numaBindFailures = m_counters.numaBindFailures;
+    if (interval()) {
+        hugetlbBlocks -= m_lastCounters.hugetlbBlocks;
+        fallbacks -= m_lastCounters.fallbacks;
+        numaBindFailures -= m_lastCounters.numaBindFailures;
+        m_lastCounters = m_counters;
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["HUGE_PAGE_MODE"], m_mode);
+    tuple->setNValue(StatsSource::m_columnName2Index["NUMA_NODE"],
+                     ValueFactory::getIntegerValue(m_counters.numaNode));
+    tuple->setNValue(StatsSource::m_columnName2Index["MAPPED_BLOCKS"],
+                     ValueFactory::getBigIntValue(m_counters.mappedBlocks));
+    tuple->setNValue(StatsSource::m_columnName2Index["MAPPED_BYTES"],
+                     ValueFactory::getBigIntValue(m_counters.mappedBytes));
+    tuple->setNValue(StatsSource::m_columnName2Index["HUGETLB_BLOCKS"],
+                     ValueFactory::getBigIntValue(hugetlbBlocks));
+    tuple->setNValue(StatsSource::m_columnName2Index["FALLBACKS"],
+                     ValueFactory::getBigIntValue(fallbacks));
+    tuple->setNValue(StatsSource::m_columnName2Index["NUMA_BIND_FAILURES"],
+                     ValueFactory::getBigIntValue(numaBindFailures));
+}
+
+void HugePageAllocatorStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    HugePageAllocatorStats::populateHugePageAllocatorStatsSchema(types, columnLengths, allowNull, inBytes);
+}
@@ -0,0 +1,71 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HUGEPAGEALLOCATORSTATS_H_
+#define HUGEPAGEALLOCATORSTATS_H_
+
+#include "stats/StatsSource.h"
+#include "common/HugePageAllocator.h"
+
+namespace voltdb {
+class TempTable;
+
+/**
+ * StatsSource extension reporting how a site's tuple blocks and index
+ * buffers are backed: huge page mappings, fallbacks and NUMA binding.
+ */
+class HugePageAllocatorStats : public StatsSource {
+public:
+    static std::vector<std::string> generateHugePageAllocatorStatsColumnNames();
+
+    static void populateHugePageAllocatorStatsSchema(std::vector<voltdb::ValueType>& types,
+                                                     std::vector<int32_t>& columnLengths,
+                                                     std::vector<bool>& allowNull,
+                                                     std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyHugePageAllocatorStatsTable();
+
+    HugePageAllocatorStats(const HugePageAllocationCounters& counters);
+
+    ~HugePageAllocatorStats();
+
+    /**
+     * Configure the StatsSource superclass and capture the huge page mode,
+     * which is fixed once the engine has initialized.
+     */
+    void configure(std::string name);
+
+protected:
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    const HugePageAllocationCounters& m_counters;
+
+    voltdb::NValue m_mode;
+
+    // Counter values at the last interval poll.
+    HugePageAllocationCounters m_lastCounters;
+};
+
+}
+
+#endif /* HUGEPAGEALLOCATORSTATS_H_ */
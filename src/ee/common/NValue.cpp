@@ -114,6 +114,10 @@ const double NValue::s_ltMinDecimalAsDouble = -1E26;
 TTInt NValue::s_maxInt64AsDecimal(TTInt(INT64_MAX) * kMaxScaleFactor);
 TTInt NValue::s_minInt64AsDecimal(TTInt(-INT64_MAX) * kMaxScaleFactor);
 
+#ifdef VOLT_DECIMAL_INT128
+constexpr TTInt128 NValue::s_maxDecimalInt128;
+#endif
+
 /*
  * Produce a debugging string describing an NValue.
  */
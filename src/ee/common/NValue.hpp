@@ -70,6 +70,14 @@ typedef ttmath::Int<2> TTInt;
 //Long integer with space for multiplication and division without carry/overflow
 typedef ttmath::Int<4> TTLInt;
 
+// Where the compiler has a native 128 bit integer with the same two's
+// complement layout as TTInt, DECIMAL arithmetic is done on it directly,
+// falling back to ttmath only for intermediates that do not fit.
+#if defined(__SIZEOF_INT128__) && defined(TTMATH_PLATFORM64)
+#define VOLT_DECIMAL_INT128
+typedef __int128 TTInt128;
+#endif
+
 template<typename T>
 void throwCastSQLValueOutOfRangeException(
         const T value,
@@ -812,6 +820,28 @@ private:
     static ValueType s_doublePromotionTable[];
     static TTInt s_maxDecimalValue;
     static TTInt s_minDecimalValue;
+#ifdef VOLT_DECIMAL_INT128
+    // 10**38 - 1, the same bound as s_maxDecimalValue.
+    static constexpr TTInt128 s_maxDecimalInt128 =
+        static_cast<TTInt128>(10000000000000000000ULL) * 10000000000000000000ULL - 1;
+
+    static TTInt128 decimalToInt128(const TTInt& value) {
+        return static_cast<TTInt128>(
+                (static_cast<unsigned __int128>(value.table[1]) << 64) | value.table[0]);
+    }
+
+    static bool isDecimalInRange(TTInt128 value) {
+        return value <= s_maxDecimalInt128 && value >= -s_maxDecimalInt128;
+    }
+
+    static NValue getDecimalValueFromInt128(TTInt128 value) {
+        NValue retval(VALUE_TYPE_DECIMAL);
+        TTInt& decimal = retval.getDecimal();
+        decimal.table[0] = static_cast<uint64_t>(value);
+        decimal.table[1] = static_cast<uint64_t>(static_cast<unsigned __int128>(value) >> 64);
+        return retval;
+    }
+#endif
     // These initializers give the unique double values that are
     // closest but not equal to +/-1E26 within the accuracy of a double.
     static const double s_gtMaxDecimalAsDouble;
@@ -2124,7 +2154,12 @@ private:
         assert(m_valueType == VALUE_TYPE_DECIMAL);
         switch (rhs.getValueType()) {
         case VALUE_TYPE_DECIMAL:
+#ifdef VOLT_DECIMAL_INT128
+            return compareValue<TTInt128>(decimalToInt128(getDecimal()),
+                                          decimalToInt128(rhs.getDecimal()));
+#else
             return compareValue<TTInt>(getDecimal(), rhs.getDecimal());
+#endif
         case VALUE_TYPE_DOUBLE: {
             const double rhsValue = rhs.getDouble();
             TTInt scaledValue = getDecimal();
@@ -2328,6 +2363,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_DECIMAL_INT128
+        TTInt128 sum;
+        if ( ! __builtin_add_overflow(decimalToInt128(lhs.getDecimal()),
+                                      decimalToInt128(rhs.getDecimal()), &sum) &&
+                isDecimalInRange(sum)) {
+            return getDecimalValueFromInt128(sum);
+        }
+#endif
         TTInt retval(lhs.getDecimal());
         if (retval.Add(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2346,6 +2389,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_DECIMAL_INT128
+        TTInt128 difference;
+        if ( ! __builtin_sub_overflow(decimalToInt128(lhs.getDecimal()),
+                                      decimalToInt128(rhs.getDecimal()), &difference) &&
+                isDecimalInRange(difference)) {
+            return getDecimalValueFromInt128(difference);
+        }
+#endif
         TTInt retval(lhs.getDecimal());
         if (retval.Sub(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2370,6 +2421,18 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_DECIMAL_INT128
+        // Exact whenever the unscaled product fits; otherwise the 256 bit
+        // intermediate below decides whether the scaled result does.
+        TTInt128 product;
+        if ( ! __builtin_mul_overflow(decimalToInt128(lhs.getDecimal()),
+                                      decimalToInt128(rhs.getDecimal()), &product)) {
+            product /= kMaxScaleFactor;
+            if (isDecimalInRange(product)) {
+                return getDecimalValueFromInt128(product);
+            }
+        }
+#endif
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= rhs.getDecimal();
@@ -2405,6 +2468,18 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef VOLT_DECIMAL_INT128
+        TTInt128 divisor = decimalToInt128(rhs.getDecimal());
+        TTInt128 dividend;
+        if (divisor != 0 &&
+                ! __builtin_mul_overflow(decimalToInt128(lhs.getDecimal()),
+                                         static_cast<TTInt128>(kMaxScaleFactor), &dividend)) {
+            TTInt128 quotient = dividend / divisor;
+            if (isDecimalInRange(quotient)) {
+                return getDecimalValueFromInt128(quotient);
+            }
+        }
+#endif
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= kMaxScaleFactor;
@@ -0,0 +1,302 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/PlannerDomBinary.h"
+
+#include "common/SerializableEEException.h"
+
+#include <cstring>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+namespace voltdb {
+
+namespace {
+
+const char BINARY_MAGIC[] = { '\0', 'V', 'P', 'B' };
+const size_t BINARY_MAGIC_LENGTH = sizeof(BINARY_MAGIC);
+const char BINARY_VERSION = 1;
+
+// Far deeper than any plan nests, but shallow enough that a malformed
+// plan cannot exhaust the stack.
+const int MAX_DEPTH = 4096;
+
+void throwInvalidPlan() {
+    throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                  "PlannerDomBinary: malformed binary plan");
+}
+
+void writeVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+class Encoder {
+public:
+    void encode(const rapidjson::Value &value) {
+        switch (value.GetType()) {
+        case rapidjson::kNullType:
+            m_body.push_back(PlannerDomBinary::TAG_NULL);
+            break;
+        case rapidjson::kFalseType:
+            m_body.push_back(PlannerDomBinary::TAG_FALSE);
+            break;
+        case rapidjson::kTrueType:
+            m_body.push_back(PlannerDomBinary::TAG_TRUE);
+            break;
+        case rapidjson::kStringType:
+            m_body.push_back(PlannerDomBinary::TAG_STRING);
+            writeVarint(m_body, value.GetStringLength());
+            m_body.append(value.GetString(), value.GetStringLength());
+            break;
+        case rapidjson::kArrayType:
+            m_body.push_back(PlannerDomBinary::TAG_ARRAY);
+            writeVarint(m_body, value.Size());
+            for (rapidjson::Value::ConstValueIterator iter = value.Begin(); iter != value.End(); ++iter) {
+                encode(*iter);
+            }
+            break;
+        case rapidjson::kObjectType:
+            m_body.push_back(PlannerDomBinary::TAG_OBJECT);
+            writeVarint(m_body, value.MemberCount());
+            for (rapidjson::Value::ConstMemberIterator iter = value.MemberBegin();
+                 iter != value.MemberEnd(); ++iter) {
+                writeVarint(m_body, keyIndex(iter->name));
+                encode(iter->value);
+            }
+            break;
+        case rapidjson::kNumberType:
+            if (value.IsInt64()) {
+                int64_t number = value.GetInt64();
+                m_body.push_back(PlannerDomBinary::TAG_INTEGER);
+                writeVarint(m_body, (static_cast<uint64_t>(number) << 1) ^ static_cast<uint64_t>(number >> 63));
+            }
+            else if (value.IsUint64()) {
+                m_body.push_back(PlannerDomBinary::TAG_UNSIGNED);
+                writeVarint(m_body, value.GetUint64());
+            }
+            else {
+                double number = value.GetDouble();
+                uint64_t bits;
+                ::memcpy(&bits, &number, sizeof(bits));
+                m_body.push_back(PlannerDomBinary::TAG_DOUBLE);
+                for (int i = 0; i < 8; i++) {
+                    m_body.push_back(static_cast<char>(bits >> (8 * i)));
+                }
+            }
+            break;
+        }
+    }
+
+    std::string finish() {
+        std::string out(BINARY_MAGIC, BINARY_MAGIC_LENGTH);
+        out.push_back(BINARY_VERSION);
+        writeVarint(out, m_keys.size());
+        for (std::vector<std::string>::const_iterator iter = m_keys.begin(); iter != m_keys.end(); ++iter) {
+            writeVarint(out, iter->size());
+            out.append(*iter);
+        }
+        out.append(m_body);
+        return out;
+    }
+
+private:
+    size_t keyIndex(const rapidjson::Value &name) {
+        std::string key(name.GetString(), name.GetStringLength());
+        boost::unordered_map<std::string, size_t>::const_iterator iter = m_keyIndexes.find(key);
+        if (iter != m_keyIndexes.end()) {
+            return iter->second;
+        }
+        size_t index = m_keys.size();
+        m_keys.push_back(key);
+        m_keyIndexes[key] = index;
+        return index;
+    }
+
+    std::string m_body;
+    std::vector<std::string> m_keys;
+    boost::unordered_map<std::string, size_t> m_keyIndexes;
+};
+
+class Decoder {
+public:
+    Decoder(const char *plan, size_t length, rapidjson::Document &document)
+        : m_pos(reinterpret_cast<const uint8_t*>(plan) + BINARY_MAGIC_LENGTH + 1),
+          m_end(reinterpret_cast<const uint8_t*>(plan) + length),
+          m_allocator(document.GetAllocator())
+    {
+        // Keys are copied into the document once and shared by every member
+        // that uses them.
+        uint64_t keyCount = readVarint();
+        if (keyCount > static_cast<uint64_t>(m_end - m_pos)) {
+            throwInvalidPlan();
+        }
+        m_keys.reserve(static_cast<size_t>(keyCount));
+        for (uint64_t i = 0; i < keyCount; i++) {
+            size_t keyLength = readLength();
+            char *key = static_cast<char*>(m_allocator.Malloc(keyLength + 1));
+            ::memcpy(key, m_pos, keyLength);
+            key[keyLength] = '\0';
+            m_pos += keyLength;
+            m_keys.push_back(rapidjson::Value::StringRefType(key, static_cast<rapidjson::SizeType>(keyLength)));
+        }
+    }
+
+    void decode(rapidjson::Value &value, int depth) {
+        if (depth > MAX_DEPTH || m_pos >= m_end) {
+            throwInvalidPlan();
+        }
+        switch (*m_pos++) {
+        case PlannerDomBinary::TAG_NULL:
+            value.SetNull();
+            break;
+        case PlannerDomBinary::TAG_FALSE:
+            value.SetBool(false);
+            break;
+        case PlannerDomBinary::TAG_TRUE:
+            value.SetBool(true);
+            break;
+        case PlannerDomBinary::TAG_INTEGER: {
+            uint64_t zigzag = readVarint();
+            value.SetInt64(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+            break;
+        }
+        case PlannerDomBinary::TAG_UNSIGNED:
+            value.SetUint64(readVarint());
+            break;
+        case PlannerDomBinary::TAG_DOUBLE: {
+            if (m_end - m_pos < 8) {
+                throwInvalidPlan();
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; i++) {
+                bits |= static_cast<uint64_t>(m_pos[i]) << (8 * i);
+            }
+            m_pos += 8;
+            double number;
+            ::memcpy(&number, &bits, sizeof(number));
+            value.SetDouble(number);
+            break;
+        }
+        case PlannerDomBinary::TAG_STRING: {
+            size_t stringLength = readLength();
+            value.SetString(reinterpret_cast<const char*>(m_pos),
+                            static_cast<rapidjson::SizeType>(stringLength), m_allocator);
+            m_pos += stringLength;
+            break;
+        }
+        case PlannerDomBinary::TAG_ARRAY: {
+            // Every element takes at least its tag byte.
+            size_t count = readLength();
+            value.SetArray();
+            value.Reserve(static_cast<rapidjson::SizeType>(count), m_allocator);
+            for (size_t i = 0; i < count; i++) {
+                rapidjson::Value element;
+                decode(element, depth + 1);
+                value.PushBack(element, m_allocator);
+            }
+            break;
+        }
+        case PlannerDomBinary::TAG_OBJECT: {
+            size_t count = readLength();
+            value.SetObject();
+            for (size_t i = 0; i < count; i++) {
+                uint64_t key = readVarint();
+                if (key >= m_keys.size()) {
+                    throwInvalidPlan();
+                }
+                rapidjson::Value name(m_keys[static_cast<size_t>(key)]);
+                rapidjson::Value member;
+                decode(member, depth + 1);
+                value.AddMember(name, member, m_allocator);
+            }
+            break;
+        }
+        default:
+            throwInvalidPlan();
+        }
+    }
+
+    bool atEnd() const {
+        return m_pos == m_end;
+    }
+
+private:
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_pos >= m_end) {
+                throwInvalidPlan();
+            }
+            uint8_t byte = *m_pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throwInvalidPlan();
+        return 0;
+    }
+
+    /** Read a length or count that cannot exceed the remaining bytes. */
+    size_t readLength() {
+        uint64_t length = readVarint();
+        if (length > static_cast<uint64_t>(m_end - m_pos)) {
+            throwInvalidPlan();
+        }
+        return static_cast<size_t>(length);
+    }
+
+    const uint8_t *m_pos;
+    const uint8_t *m_end;
+    rapidjson::Document::AllocatorType &m_allocator;
+    std::vector<rapidjson::Value::StringRefType> m_keys;
+};
+
+}
+
+bool PlannerDomBinary::isBinary(const char *plan, size_t length) {
+    return length > BINARY_MAGIC_LENGTH && ::memcmp(plan, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0;
+}
+
+std::string PlannerDomBinary::encode(const char *jsonPlan) {
+    rapidjson::Document document;
+    document.Parse<0>(jsonPlan);
+    if (document.HasParseError()) {
+        throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                      "PlannerDomBinary: plan is not valid JSON");
+    }
+    Encoder encoder;
+    encoder.encode(document);
+    return encoder.finish();
+}
+
+void PlannerDomBinary::decode(const char *plan, size_t length, rapidjson::Document &document) {
+    if ( ! isBinary(plan, length) || plan[BINARY_MAGIC_LENGTH] != BINARY_VERSION) {
+        throwInvalidPlan();
+    }
+    Decoder decoder(plan, length, document);
+    decoder.decode(document, 0);
+    if ( ! decoder.atEnd()) {
+        throwInvalidPlan();
+    }
+}
+
+}
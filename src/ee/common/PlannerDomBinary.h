@@ -0,0 +1,74 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLANNERDOMBINARY_H_
+#define PLANNERDOMBINARY_H_
+
+#include "rapidjson/document.h"
+
+#include <string>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Compact binary encoding of a plan DOM, accepted by PlannerDomRoot in
+ * place of the JSON text.  It carries exactly what the JSON carries, so
+ * every plan node, expression and schema loader works unchanged, but
+ * decoding it needs no number or escape parsing and every object key is
+ * stored once.
+ *
+ * Layout, with counts, lengths and indexes as unsigned LEB128 varints:
+ *   magic "\0VPB", version byte
+ *   key count, then for each key its length and bytes
+ *   the root value
+ * Each value is a tag byte followed by:
+ *   NULL, FALSE, TRUE    nothing
+ *   INTEGER              zigzag varint
+ *   UNSIGNED             varint (only for values above INT64_MAX)
+ *   DOUBLE               8 bytes, little endian IEEE 754
+ *   STRING               length and bytes
+ *   ARRAY                element count and elements
+ *   OBJECT               member count, then key index and value per member
+ */
+class PlannerDomBinary {
+public:
+    enum Tag {
+        TAG_NULL = 0,
+        TAG_FALSE = 1,
+        TAG_TRUE = 2,
+        TAG_INTEGER = 3,
+        TAG_UNSIGNED = 4,
+        TAG_DOUBLE = 5,
+        TAG_STRING = 6,
+        TAG_ARRAY = 7,
+        TAG_OBJECT = 8
+    };
+
+    /** True if the plan is in the binary form rather than JSON text. */
+    static bool isBinary(const char *plan, size_t length);
+
+    /** Encode a JSON plan in the binary form.  Throws if the JSON does not parse. */
+    static std::string encode(const char *jsonPlan);
+
+    /** Decode a binary plan into the document.  Throws if the plan is malformed. */
+    static void decode(const char *plan, size_t length, rapidjson::Document &document);
+};
+
+}
+
+#endif // PLANNERDOMBINARY_H_
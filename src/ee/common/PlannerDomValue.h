@@ -18,9 +18,12 @@
 #ifndef PLANNERDOMVALUE_H_
 #define PLANNERDOMVALUE_H_
 
+#include "common/PlannerDomBinary.h"
 #include "common/SerializableEEException.h"
 
 #include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -155,6 +158,17 @@ namespace voltdb {
             return m_value[index];
         }
 
+        /**
+         * Serialize this value and everything under it back to compact JSON.
+         * Two subtrees of the same plan compare equal iff their strings do.
+         */
+        std::string toJSONString() const {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            m_value.Accept(writer);
+            return std::string(buffer.GetString(), buffer.GetSize());
+        }
+
     private:
         PlannerDomValue(rapidjson::Value &value) : m_value(value) {}
 
@@ -173,10 +187,26 @@ namespace voltdb {
             m_document.Parse<0>(jsonStr);
         }
 
+        /**
+         * Accepts either JSON text or the PlannerDomBinary form.
+         */
+        PlannerDomRoot(const char *plan, size_t length) {
+            if (PlannerDomBinary::isBinary(plan, length)) {
+                PlannerDomBinary::decode(plan, length, m_document);
+            }
+            else {
+                m_document.Parse<0>(plan, length);
+            }
+        }
+
         bool isNull() {
             return m_document.IsNull();
         }
 
+        bool hasParseError() const {
+            return m_document.HasParseError();
+        }
+
         PlannerDomValue rootObject() {
             return PlannerDomValue(m_document);
         }
@@ -0,0 +1,117 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/SiteBarrierStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> SiteBarrierStats::generateSiteBarrierStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("BARRIER_TYPE");
+    columnNames.push_back("WAIT_COUNT");
+    columnNames.push_back("SLEEP_COUNT");
+    columnNames.push_back("TOTAL_WAIT_NANOS");
+    columnNames.push_back("AVG_WAIT_NANOS");
+    columnNames.push_back("MAX_WAIT_NANOS");
+    return columnNames;
+}
+
+void SiteBarrierStats::populateSiteBarrierStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    types.push_back(VALUE_TYPE_VARCHAR); columnLengths.push_back(4096); allowNull.push_back(false);inBytes.push_back(false);
+    for (int ii = 0; ii < 5; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* SiteBarrierStats::generateEmptySiteBarrierStatsTable() {
+    string name = "Site barrier stats temp table";
+    vector<string> columnNames = SiteBarrierStats::generateSiteBarrierStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    SiteBarrierStats::populateSiteBarrierStatsSchema(columnTypes, columnLengths,
+                                                     columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+SiteBarrierStats::SiteBarrierStats(const SiteBarrierWaitCounters& counters)
+    : StatsSource(), m_counters(counters), m_barrierType(), m_lastCounters()
+{
+}
+
+SiteBarrierStats::~SiteBarrierStats() {
+    m_tableName.free();
+    m_barrierType.free();
+}
+
+void SiteBarrierStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+    m_barrierType.free();
+    m_barrierType = ValueFactory::getStringValue(
+            SynchronizedThreadLock::barrierType() == REPLICATED_BARRIER_TYPE_SPIN_FUTEX ? "SPIN_FUTEX" : "MUTEX");
+}
+
+vector<string> SiteBarrierStats::generateStatsColumnNames() {
+    return SiteBarrierStats::generateSiteBarrierStatsColumnNames();
+}
+
+void SiteBarrierStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t waits = m_counters.waits;
+    int64_t sleeps = m_counters.sleeps;
+    int64_t totalWaitNanos = m_counters.totalWaitNanos;
+    // The max is only tracked since the beginning; intervals report it as is.
+    int64_t maxWaitNanos = m_counters.maxWaitNanos;
+    if (interval()) {
+        waits -= m_lastCounters.waits;
+        sleeps -= m_lastCounters.sleeps;
+        totalWaitNanos -= m_lastCounters.totalWaitNanos;
+        m_lastCounters = m_counters;
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["BARRIER_TYPE"], m_barrierType);
+    tuple->setNValue(StatsSource::m_columnName2Index["WAIT_COUNT"], ValueFactory::getBigIntValue(waits));
+    tuple->setNValue(StatsSource::m_columnName2Index["SLEEP_COUNT"], ValueFactory::getBigIntValue(sleeps));
+    tuple->setNValue(StatsSource::m_columnName2Index["TOTAL_WAIT_NANOS"],
+                     ValueFactory::getBigIntValue(totalWaitNanos));
+    tuple->setNValue(StatsSource::m_columnName2Index["AVG_WAIT_NANOS"],
+                     ValueFactory::getBigIntValue(waits == 0 ? 0 : totalWaitNanos / waits));
+    tuple->setNValue(StatsSource::m_columnName2Index["MAX_WAIT_NANOS"],
+                     ValueFactory::getBigIntValue(maxWaitNanos));
+}
+
+void SiteBarrierStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    SiteBarrierStats::populateSiteBarrierStatsSchema(types, columnLengths, allowNull, inBytes);
+}
@@ -0,0 +1,71 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SITEBARRIERSTATS_H_
+#define SITEBARRIERSTATS_H_
+
+#include "stats/StatsSource.h"
+#include "common/SynchronizedThreadLock.h"
+
+namespace voltdb {
+class TempTable;
+
+/**
+ * StatsSource extension reporting how long a site has waited in the
+ * barrier that serializes replicated table writes across the sites of a host.
+ */
+class SiteBarrierStats : public StatsSource {
+public:
+    static std::vector<std::string> generateSiteBarrierStatsColumnNames();
+
+    static void populateSiteBarrierStatsSchema(std::vector<voltdb::ValueType>& types,
+                                               std::vector<int32_t>& columnLengths,
+                                               std::vector<bool>& allowNull,
+                                               std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptySiteBarrierStatsTable();
+
+    SiteBarrierStats(const SiteBarrierWaitCounters& counters);
+
+    ~SiteBarrierStats();
+
+    /**
+     * Configure the StatsSource superclass and capture the barrier type,
+     * which is fixed once the first site of the host has initialized.
+     */
+    void configure(std::string name);
+
+protected:
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    const SiteBarrierWaitCounters& m_counters;
+
+    voltdb::NValue m_barrierType;
+
+    // Counter values at the last interval poll.
+    SiteBarrierWaitCounters m_lastCounters;
+};
+
+}
+
+#endif /* SITEBARRIERSTATS_H_ */
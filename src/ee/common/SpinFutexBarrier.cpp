@@ -0,0 +1,125 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/SpinFutexBarrier.h"
+
+#include <cassert>
+#include <climits>
+#include <sched.h>
+
+#ifdef LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace voltdb {
+
+namespace {
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+}
+
+const int32_t SpinFutexBarrier::DEFAULT_SPIN_ITERATIONS;
+
+SpinFutexBarrier::SpinFutexBarrier()
+  : m_remaining(0), m_coordinatorSleeping(0),
+    m_sense(0), m_releaseSleepers(0),
+    m_participants(0), m_spinIterations(DEFAULT_SPIN_ITERATIONS)
+{
+}
+
+void SpinFutexBarrier::reset(int32_t participants, int32_t spinIterations) {
+    assert(participants > 0);
+    m_participants = participants;
+    m_spinIterations = spinIterations;
+    m_coordinatorSleeping.store(0);
+    m_releaseSleepers.store(0);
+    m_remaining.store(participants);
+}
+
+bool SpinFutexBarrier::arriveAndWaitForAll() {
+    int32_t remaining = m_remaining.fetch_sub(1) - 1;
+    assert(remaining >= 0);
+    bool slept = false;
+    while (remaining != 0) {
+        slept |= waitWhileEquals(m_remaining, remaining, m_coordinatorSleeping);
+        remaining = m_remaining.load(std::memory_order_acquire);
+    }
+    return slept;
+}
+
+bool SpinFutexBarrier::arriveAndWaitForRelease() {
+    // Read the sense before arriving: the coordinator cannot flip it until
+    // our arrival has been counted, so this is the value of our round.
+    int32_t sense = m_sense.load(std::memory_order_acquire);
+    if (m_remaining.fetch_sub(1) == 1 && m_coordinatorSleeping.load() > 0) {
+        futexWake(m_remaining, 1);
+    }
+    return waitWhileEquals(m_sense, sense, m_releaseSleepers);
+}
+
+void SpinFutexBarrier::release() {
+    // Rearm before flipping the sense so that a released site which races
+    // ahead into the next round counts down against a full latch.
+    m_remaining.store(m_participants);
+    m_sense.fetch_add(1);
+    if (m_releaseSleepers.load() > 0) {
+        futexWake(m_sense, INT_MAX);
+    }
+}
+
+bool SpinFutexBarrier::waitWhileEquals(std::atomic<int32_t>& word, int32_t value,
+                                       std::atomic<int32_t>& sleepers) {
+    for (int32_t spins = 0; spins < m_spinIterations; ++spins) {
+        if (word.load(std::memory_order_acquire) != value) {
+            return false;
+        }
+        cpuRelax();
+    }
+    bool slept = false;
+    while (word.load(std::memory_order_acquire) == value) {
+        // The waker checks the sleeper count after changing the word, and
+        // the kernel rechecks the word before sleeping, so no wakeup is lost.
+        sleepers.fetch_add(1);
+        futexWait(word, value);
+        sleepers.fetch_sub(1);
+        slept = true;
+    }
+    return slept;
+}
+
+void SpinFutexBarrier::futexWait(std::atomic<int32_t>& word, int32_t value) {
+#ifdef LINUX
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+    if (word.load(std::memory_order_acquire) == value) {
+        sched_yield();
+    }
+#endif
+}
+
+void SpinFutexBarrier::futexWake(std::atomic<int32_t>& word, int32_t count) {
+#ifdef LINUX
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(&word), FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#endif
+}
+
+}
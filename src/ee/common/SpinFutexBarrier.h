@@ -0,0 +1,99 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPINFUTEXBARRIER_H_
+#define SPINFUTEXBARRIER_H_
+
+#include <stdint.h>
+#if __cplusplus >= 201103L
+#include <atomic>
+#else
+#include <cstdatomic>
+#endif
+
+namespace voltdb {
+
+/**
+ * Two phase barrier used to hand the replicated table context from all
+ * the sites of a host to the lowest site and back again.
+ *
+ * Phase one: every site arrives.  The coordinator (the lowest site) waits
+ * until all the other sites have arrived, and then runs alone.
+ * Phase two: the coordinator releases the others by flipping the sense
+ * word.  The other sites wait for that flip.
+ *
+ * Waiters spin for a bounded number of iterations before sleeping on a
+ * futex, so short multi-partition writes never enter the kernel.  Each
+ * shared word lives on its own cache line so that arrivals (which write
+ * the countdown) do not invalidate the line the released sites are polling.
+ * On platforms without futexes the sleep degrades to sched_yield().
+ */
+class SpinFutexBarrier {
+public:
+    static const int32_t DEFAULT_SPIN_ITERATIONS = 4096;
+
+    SpinFutexBarrier();
+
+    /**
+     * (Re)arm the barrier for the given number of participants, including
+     * the coordinator.  Must not be called while any site is waiting.
+     */
+    void reset(int32_t participants, int32_t spinIterations = DEFAULT_SPIN_ITERATIONS);
+
+    /**
+     * Called by the coordinator.  Returns when every participant has arrived.
+     * @return true if the coordinator had to sleep in the kernel.
+     */
+    bool arriveAndWaitForAll();
+
+    /**
+     * Called by every participant but the coordinator.  Returns once the
+     * coordinator has called release().
+     * @return true if this participant had to sleep in the kernel.
+     */
+    bool arriveAndWaitForRelease();
+
+    /**
+     * Called by the coordinator when its single threaded work is done.
+     * Rearms the countdown and wakes all the other participants.
+     */
+    void release();
+
+    int32_t participants() const { return m_participants; }
+
+private:
+    /** Spin, then sleep, until the word no longer holds the given value. */
+    bool waitWhileEquals(std::atomic<int32_t>& word, int32_t value, std::atomic<int32_t>& sleepers);
+
+    static void futexWait(std::atomic<int32_t>& word, int32_t value);
+    static void futexWake(std::atomic<int32_t>& word, int32_t count);
+
+    // Number of sites still expected in the current round.
+    alignas(64) std::atomic<int32_t> m_remaining;
+    std::atomic<int32_t> m_coordinatorSleeping;
+
+    // Flipped (incremented) once per round by release().
+    alignas(64) std::atomic<int32_t> m_sense;
+    std::atomic<int32_t> m_releaseSleepers;
+
+    alignas(64) int32_t m_participants;
+    int32_t m_spinIterations;
+};
+
+}
+
+#endif // SPINFUTEXBARRIER_H_
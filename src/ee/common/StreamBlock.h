@@ -204,6 +204,11 @@ namespace voltdb
             m_rowCount++;
         }
 
+        inline void consumedRows(size_t consumed, size_t rows) {
+            commonConsumed(consumed);
+            m_rowCount += rows;
+        }
+
         inline void truncateExportTo(size_t mark, int64_t seqNo) {
             commonTruncateTo(mark);
             m_rowCount = seqNo - m_startSequenceNumber;
@@ -225,7 +230,8 @@ namespace voltdb
             m_hasDRBeginTxn(false),
             m_startDRSequenceNumber(std::numeric_limits<int64_t>::max()),
             m_lastDRSequenceNumber(std::numeric_limits<int64_t>::max()),
-            m_lastMpUniqueId(0)
+            m_lastMpUniqueId(0),
+            m_compressed(false)
         {}
 
         DrStreamBlock(DrStreamBlock *other) :
@@ -236,7 +242,8 @@ namespace voltdb
             m_hasDRBeginTxn(other->m_hasDRBeginTxn),
             m_startDRSequenceNumber(other->m_startDRSequenceNumber),
             m_lastDRSequenceNumber(other->m_lastDRSequenceNumber),
-            m_lastMpUniqueId(other->m_lastMpUniqueId)
+            m_lastMpUniqueId(other->m_lastMpUniqueId),
+            m_compressed(other->m_compressed)
         {}
 
         ~DrStreamBlock()
@@ -310,6 +317,20 @@ namespace voltdb
             recordLastBeginTxnOffset();
         }
 
+        /**
+         * The sealed block's transactions were replaced in place by a compressed
+         * log of the given length.  uso() + offset() no longer spans the block.
+         */
+        inline void recordCompressed(size_t length) {
+            assert(length <= m_offset);
+            m_offset = length;
+            m_compressed = true;
+        }
+
+        inline bool isCompressed() const {
+            return m_compressed;
+        }
+
     private:
         size_t m_lastDRBeginTxnOffset;  // keep record of DR begin txn to avoid txn span multiple buffers
         size_t m_rowCountForDR;
@@ -318,6 +339,7 @@ namespace voltdb
         int64_t m_startDRSequenceNumber;
         int64_t m_lastDRSequenceNumber;
         int64_t m_lastMpUniqueId;
+        bool m_compressed;
     };
 }
 
@@ -0,0 +1,153 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/StreamBufferPool.h"
+
+#include "common/debuglog.h"
+
+#include <boost/foreach.hpp>
+
+#include <cassert>
+#include <mutex>
+
+namespace voltdb {
+
+namespace {
+// Guards s_outstanding.  Taken before any pool's own mutex.
+std::mutex s_registryMutex;
+
+const size_t PREFAULT_STRIDE = 4096;
+}
+
+const size_t StreamBufferPool::MAX_POOLED_BUFFER_SIZE;
+const size_t StreamBufferPool::DEFAULT_MAX_IDLE_BYTES;
+
+boost::unordered_map<char*, StreamBufferPool::OutstandingBuffer> StreamBufferPool::s_outstanding;
+
+StreamBufferPool::StreamBufferPool(size_t maxIdleBytes)
+  : m_mutex(), m_maxIdleBytes(maxIdleBytes), m_idleBuffers(), m_counters()
+{
+}
+
+StreamBufferPool::~StreamBufferPool() {
+    std::lock_guard<std::mutex> registryGuard(s_registryMutex);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    typedef boost::unordered_map<size_t, std::vector<char*> >::value_type IdleList;
+    BOOST_FOREACH (IdleList& idle, m_idleBuffers) {
+        BOOST_FOREACH (char* buffer, idle.second) {
+            delete [] buffer;
+        }
+    }
+    if (m_counters.outstandingBuffers > 0) {
+        // The top end still holds some of our buffers; orphan them so that
+        // they are freed when they come back.
+        VOLT_DEBUG("Orphaning %jd outstanding stream buffers", (intmax_t)m_counters.outstandingBuffers);
+        typedef boost::unordered_map<char*, OutstandingBuffer>::value_type Outstanding;
+        BOOST_FOREACH (Outstanding& entry, s_outstanding) {
+            if (entry.second.owner == this) {
+                entry.second.owner = NULL;
+            }
+        }
+    }
+}
+
+char* StreamBufferPool::acquire(size_t size) {
+    if (size > MAX_POOLED_BUFFER_SIZE) {
+        return new char[size];
+    }
+
+    char* buffer = NULL;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_counters.acquires;
+        std::vector<char*>& idle = m_idleBuffers[size];
+        if (idle.empty()) {
+            ++m_counters.allocations;
+        }
+        else {
+            buffer = idle.back();
+            idle.pop_back();
+            ++m_counters.poolHits;
+            --m_counters.idleBuffers;
+            m_counters.idleBytes -= size;
+        }
+        ++m_counters.outstandingBuffers;
+    }
+    if (buffer == NULL) {
+        buffer = new char[size];
+    }
+
+    std::lock_guard<std::mutex> registryGuard(s_registryMutex);
+    OutstandingBuffer& entry = s_outstanding[buffer];
+    entry.owner = this;
+    entry.size = size;
+    return buffer;
+}
+
+void StreamBufferPool::reserve(size_t size, int32_t count) {
+    assert(size <= MAX_POOLED_BUFFER_SIZE);
+    for (int32_t ii = 0; ii < count; ++ii) {
+        char* buffer = new char[size];
+        for (size_t offset = 0; offset < size; offset += PREFAULT_STRIDE) {
+            buffer[offset] = 0;
+        }
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_counters.allocations;
+        recycle(buffer, size);
+    }
+}
+
+void StreamBufferPool::release(char* buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> registryGuard(s_registryMutex);
+        boost::unordered_map<char*, OutstandingBuffer>::iterator it = s_outstanding.find(buffer);
+        if (it != s_outstanding.end()) {
+            StreamBufferPool* owner = it->second.owner;
+            size_t size = it->second.size;
+            s_outstanding.erase(it);
+            if (owner != NULL) {
+                // Holding the registry lock keeps the owner from being destroyed under us.
+                std::lock_guard<std::mutex> guard(owner->m_mutex);
+                ++owner->m_counters.releases;
+                --owner->m_counters.outstandingBuffers;
+                owner->recycle(buffer, size);
+                return;
+            }
+        }
+    }
+    delete [] buffer;
+}
+
+void StreamBufferPool::recycle(char* buffer, size_t size) {
+    if (m_counters.idleBytes + size > m_maxIdleBytes) {
+        delete [] buffer;
+        return;
+    }
+    m_idleBuffers[size].push_back(buffer);
+    ++m_counters.idleBuffers;
+    m_counters.idleBytes += size;
+}
+
+StreamBufferPoolCounters StreamBufferPool::counters() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_counters;
+}
+
+}
@@ -0,0 +1,124 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMBUFFERPOOL_H_
+#define STREAMBUFFERPOOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace voltdb {
+
+/**
+ * Activity of one site's StreamBufferPool.
+ */
+struct StreamBufferPoolCounters {
+    StreamBufferPoolCounters()
+      : acquires(0), poolHits(0), allocations(0), releases(0),
+        outstandingBuffers(0), idleBuffers(0), idleBytes(0) {}
+
+    int64_t acquires;
+    // Acquires satisfied by a recycled buffer.
+    int64_t poolHits;
+    // Fresh buffers allocated for the pool, including pre-faulted ones.
+    int64_t allocations;
+    // Pooled buffers handed back, by the site or by the top end.
+    int64_t releases;
+    // Pooled buffers currently owned by a stream or the top end.
+    int64_t outstandingBuffers;
+    int64_t idleBuffers;
+    int64_t idleBytes;
+};
+
+/**
+ * Recycles the buffers backing the export and DR stream blocks.
+ *
+ * A stream block's buffer is handed to the top end when the block is
+ * pushed, and is freed later, possibly by another thread, through
+ * release().  Buffers of the pool's sizes go back on the owning pool's
+ * free list instead of to the allocator, so a steady flow of stream blocks
+ * causes no large mallocs or page faults on the site thread.  Buffers
+ * larger than MAX_POOLED_BUFFER_SIZE (the DR stream's oversized blocks)
+ * are not pooled.
+ *
+ * The pool outlives neither its engine nor the buffers it has handed out:
+ * buffers released after their pool is gone are simply freed.
+ *
+ * Each pool's free lists and counters have their own lock, so sites never
+ * contend with each other for those.  Which pool, if any, a buffer belongs
+ * to is recorded in one process-wide registry: release() is given only a
+ * raw pointer, by Java or the IPC top end, and must tell pooled buffers
+ * apart from any other new[]ed buffer without reading outside of it.  The
+ * registry lock is held only for the lookup and never across allocation.
+ */
+class StreamBufferPool {
+public:
+    static const size_t MAX_POOLED_BUFFER_SIZE = 4 * 1024 * 1024;
+    static const size_t DEFAULT_MAX_IDLE_BYTES = 16 * 1024 * 1024;
+
+    StreamBufferPool(size_t maxIdleBytes = DEFAULT_MAX_IDLE_BYTES);
+
+    ~StreamBufferPool();
+
+    /**
+     * Get a buffer of exactly size bytes, recycling an idle one if possible.
+     * The buffer must be returned with release().
+     */
+    char* acquire(size_t size);
+
+    /**
+     * Allocate count buffers of the given size, touching every page so that
+     * they are faulted in, and park them on the free list.
+     */
+    void reserve(size_t size, int32_t count);
+
+    /**
+     * Return a buffer obtained from acquire(), or any other new[]ed buffer,
+     * which is then simply deleted.  Safe to call from any thread.
+     */
+    static void release(char* buffer);
+
+    /** A consistent snapshot of the pool's counters. */
+    StreamBufferPoolCounters counters() const;
+
+private:
+    struct OutstandingBuffer {
+        StreamBufferPool* owner;
+        size_t size;
+    };
+
+    // Buffers handed out by any pool, keyed by address.  Guarded by the
+    // registry lock, which is taken before any pool's m_mutex.
+    static boost::unordered_map<char*, OutstandingBuffer> s_outstanding;
+
+    /** Park a released buffer, or free it if the pool is full.  Requires m_mutex. */
+    void recycle(char* buffer, size_t size);
+
+    // Guards m_idleBuffers and m_counters.
+    mutable std::mutex m_mutex;
+    const size_t m_maxIdleBytes;
+    boost::unordered_map<size_t, std::vector<char*> > m_idleBuffers;
+    StreamBufferPoolCounters m_counters;
+};
+
+}
+
+#endif // STREAMBUFFERPOOL_H_
@@ -0,0 +1,120 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/StreamBufferPoolStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> StreamBufferPoolStats::generateStreamBufferPoolStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("ACQUIRES");
+    columnNames.push_back("POOL_HITS");
+    columnNames.push_back("ALLOCATIONS");
+    columnNames.push_back("RELEASES");
+    columnNames.push_back("OUTSTANDING_BUFFERS");
+    columnNames.push_back("IDLE_BUFFERS");
+    columnNames.push_back("IDLE_BYTES");
+    return columnNames;
+}
+
+void StreamBufferPoolStats::populateStreamBufferPoolStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 7; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* StreamBufferPoolStats::generateEmptyStreamBufferPoolStatsTable() {
+    string name = "Stream buffer pool stats temp table";
+    vector<string> columnNames = StreamBufferPoolStats::generateStreamBufferPoolStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    StreamBufferPoolStats::populateStreamBufferPoolStatsSchema(columnTypes, columnLengths,
+                                                               columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+StreamBufferPoolStats::StreamBufferPoolStats(const StreamBufferPool& pool)
+    : StatsSource(), m_pool(pool), m_lastCounters()
+{
+}
+
+StreamBufferPoolStats::~StreamBufferPoolStats() {
+    m_tableName.free();
+}
+
+void StreamBufferPoolStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+}
+
+vector<string> StreamBufferPoolStats::generateStatsColumnNames() {
+    return StreamBufferPoolStats::generateStreamBufferPoolStatsColumnNames();
+}
+
+void StreamBufferPoolStats::updateStatsTuple(TableTuple *tuple) {
+    // Outstanding and idle buffers are current values; the rest are cumulative.
+    StreamBufferPoolCounters counters = m_pool.counters();
+    int64_t acquires = counters.acquires;
+    int64_t poolHits = counters.poolHits;
+    int64_t allocations = counters.allocations;
+    int64_t releases = counters.releases;
+    if (interval()) {
+        acquires -= m_lastCounters.acquires;
+        poolHits -= m_lastCounters.poolHits;
+        allocations -= m_lastCounters.allocations;
+        releases -= m_lastCounters.releases;
+        m_lastCounters = counters;
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["ACQUIRES"],
+                     ValueFactory::getBigIntValue(acquires));
+    tuple->setNValue(StatsSource::m_columnName2Index["POOL_HITS"],
+                     ValueFactory::getBigIntValue(poolHits));
+    tuple->setNValue(StatsSource::m_columnName2Index["ALLOCATIONS"],
+                     ValueFactory::getBigIntValue(allocations));
+    tuple->setNValue(StatsSource::m_columnName2Index["RELEASES"],
+                     ValueFactory::getBigIntValue(releases));
+    tuple->setNValue(StatsSource::m_columnName2Index["OUTSTANDING_BUFFERS"],
+                     ValueFactory::getBigIntValue(counters.outstandingBuffers));
+    tuple->setNValue(StatsSource::m_columnName2Index["IDLE_BUFFERS"],
+                     ValueFactory::getBigIntValue(counters.idleBuffers));
+    tuple->setNValue(StatsSource::m_columnName2Index["IDLE_BYTES"],
+                     ValueFactory::getBigIntValue(counters.idleBytes));
+}
+
+void StreamBufferPoolStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    StreamBufferPoolStats::populateStreamBufferPoolStatsSchema(types, columnLengths, allowNull, inBytes);
+}
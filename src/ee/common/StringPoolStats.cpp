@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/StringPoolStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> StringPoolStats::generateStringPoolStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("SIZE_CLASSES");
+    columnNames.push_back("LIVE_ALLOCATIONS");
+    columnNames.push_back("HOLES");
+    columnNames.push_back("ALLOCATED_BYTES");
+    columnNames.push_back("LIVE_BYTES");
+    columnNames.push_back("FRAGMENTATION_PERCENT");
+    columnNames.push_back("RELOCATIONS");
+    return columnNames;
+}
+
+void StringPoolStats::populateStringPoolStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 5; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+    types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+}
+
+TempTable* StringPoolStats::generateEmptyStringPoolStatsTable() {
+    string name = "String pool stats temp table";
+    vector<string> columnNames = StringPoolStats::generateStringPoolStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    StringPoolStats::populateStringPoolStatsSchema(columnTypes, columnLengths,
+                                                   columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+StringPoolStats::StringPoolStats()
+    : StatsSource(), m_lastRelocations(0)
+{
+}
+
+StringPoolStats::~StringPoolStats() {
+    m_tableName.free();
+}
+
+void StringPoolStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+}
+
+vector<string> StringPoolStats::generateStatsColumnNames() {
+    return StringPoolStats::generateStringPoolStatsColumnNames();
+}
+
+void StringPoolStats::updateStatsTuple(TableTuple *tuple) {
+    // Stats are collected on the site thread, so these are its own pools.
+    RelocatableFragmentation fragmentation;
+    ThreadLocalPool::getRelocatableFragmentation(fragmentation);
+    int64_t relocations = fragmentation.relocations;
+    if (interval()) {
+        relocations -= m_lastRelocations;
+        m_lastRelocations = fragmentation.relocations;
+    }
+    int32_t fragmentationPercent = 0;
+    if (fragmentation.allocatedBytes > 0) {
+        fragmentationPercent = static_cast<int32_t>(
+                (fragmentation.allocatedBytes - fragmentation.liveBytes) * 100 / fragmentation.allocatedBytes);
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["SIZE_CLASSES"],
+                     ValueFactory::getBigIntValue(fragmentation.sizeClasses));
+    tuple->setNValue(StatsSource::m_columnName2Index["LIVE_ALLOCATIONS"],
+                     ValueFactory::getBigIntValue(fragmentation.liveAllocations));
+    tuple->setNValue(StatsSource::m_columnName2Index["HOLES"],
+                     ValueFactory::getBigIntValue(fragmentation.holes));
+    tuple->setNValue(StatsSource::m_columnName2Index["ALLOCATED_BYTES"],
+                     ValueFactory::getBigIntValue(fragmentation.allocatedBytes));
+    tuple->setNValue(StatsSource::m_columnName2Index["LIVE_BYTES"],
+                     ValueFactory::getBigIntValue(fragmentation.liveBytes));
+    tuple->setNValue(StatsSource::m_columnName2Index["FRAGMENTATION_PERCENT"],
+                     ValueFactory::getIntegerValue(fragmentationPercent));
+    tuple->setNValue(StatsSource::m_columnName2Index["RELOCATIONS"],
+                     ValueFactory::getBigIntValue(relocations));
+}
+
+void StringPoolStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    StringPoolStats::populateStringPoolStatsSchema(types, columnLengths, allowNull, inBytes);
+}
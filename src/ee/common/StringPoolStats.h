@@ -0,0 +1,63 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGPOOLSTATS_H_
+#define STRINGPOOLSTATS_H_
+
+#include "stats/StatsSource.h"
+#include "common/ThreadLocalPool.h"
+
+namespace voltdb {
+class TempTable;
+
+/**
+ * StatsSource extension reporting how much of the memory held by a site's
+ * relocatable string pools is actually in use.
+ */
+class StringPoolStats : public StatsSource {
+public:
+    static std::vector<std::string> generateStringPoolStatsColumnNames();
+
+    static void populateStringPoolStatsSchema(std::vector<voltdb::ValueType>& types,
+                                              std::vector<int32_t>& columnLengths,
+                                              std::vector<bool>& allowNull,
+                                              std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyStringPoolStatsTable();
+
+    StringPoolStats();
+
+    ~StringPoolStats();
+
+    void configure(std::string name);
+
+protected:
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    // Relocation count at the last interval poll.
+    int64_t m_lastRelocations;
+};
+
+}
+
+#endif /* STRINGPOOLSTATS_H_ */
@@ -0,0 +1,104 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/SubqueryCacheStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> SubqueryCacheStats::generateSubqueryCacheStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("CACHE_HITS");
+    columnNames.push_back("CACHE_MISSES");
+    columnNames.push_back("CACHE_EVICTIONS");
+    return columnNames;
+}
+
+void SubqueryCacheStats::populateSubqueryCacheStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 3; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* SubqueryCacheStats::generateEmptySubqueryCacheStatsTable() {
+    string name = "Subquery cache stats temp table";
+    vector<string> columnNames = SubqueryCacheStats::generateSubqueryCacheStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    SubqueryCacheStats::populateSubqueryCacheStatsSchema(columnTypes, columnLengths,
+                                                         columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+SubqueryCacheStats::SubqueryCacheStats(const SubqueryCacheCounters& counters)
+    : StatsSource(), m_counters(counters), m_lastCounters()
+{
+}
+
+SubqueryCacheStats::~SubqueryCacheStats() {
+    m_tableName.free();
+}
+
+void SubqueryCacheStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+}
+
+vector<string> SubqueryCacheStats::generateStatsColumnNames() {
+    return SubqueryCacheStats::generateSubqueryCacheStatsColumnNames();
+}
+
+void SubqueryCacheStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t hits = m_counters.hits;
+    int64_t misses = m_counters.misses;
+    int64_t evictions = m_counters.evictions;
+    if (interval()) {
+        hits -= m_lastCounters.hits;
+        misses -= m_lastCounters.misses;
+        evictions -= m_lastCounters.evictions;
+        m_lastCounters = m_counters;
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_HITS"],
+                     ValueFactory::getBigIntValue(hits));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_MISSES"],
+                     ValueFactory::getBigIntValue(misses));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_EVICTIONS"],
+                     ValueFactory::getBigIntValue(evictions));
+}
+
+void SubqueryCacheStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    SubqueryCacheStats::populateSubqueryCacheStatsSchema(types, columnLengths, allowNull, inBytes);
+}
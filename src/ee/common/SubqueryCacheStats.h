@@ -0,0 +1,67 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SUBQUERYCACHESTATS_H_
+#define SUBQUERYCACHESTATS_H_
+
+#include "stats/StatsSource.h"
+#include "common/SubqueryResultCache.h"
+
+namespace voltdb {
+class TempTable;
+
+/**
+ * StatsSource extension reporting how often a site's correlated subqueries
+ * were answered from their result caches.
+ */
+class SubqueryCacheStats : public StatsSource {
+public:
+    static std::vector<std::string> generateSubqueryCacheStatsColumnNames();
+
+    static void populateSubqueryCacheStatsSchema(std::vector<voltdb::ValueType>& types,
+                                                 std::vector<int32_t>& columnLengths,
+                                                 std::vector<bool>& allowNull,
+                                                 std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptySubqueryCacheStatsTable();
+
+    SubqueryCacheStats(const SubqueryCacheCounters& counters);
+
+    ~SubqueryCacheStats();
+
+    /**
+     * Configure the StatsSource superclass.
+     */
+    void configure(std::string name);
+
+protected:
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    const SubqueryCacheCounters& m_counters;
+
+    // Counter values at the last interval poll.
+    SubqueryCacheCounters m_lastCounters;
+};
+
+}
+
+#endif /* SUBQUERYCACHESTATS_H_ */
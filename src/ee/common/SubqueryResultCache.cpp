@@ -0,0 +1,114 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/SubqueryResultCache.h"
+
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+#include "storage/TempTableLimits.h"
+
+namespace voltdb {
+
+const size_t SubqueryResultCache::MAX_RESULTS;
+const int64_t SubqueryResultCache::MAX_ROWS_PER_RESULT;
+const int64_t SubqueryResultCache::DEFAULT_MAX_BYTES;
+
+SubqueryResultCache::SubqueryResultCache(const AbstractTempTable* templateTable,
+                                         TempTableLimits* limits,
+                                         SubqueryCacheCounters* counters)
+    : m_rows(TableFactory::buildTempTable("subquery result cache",
+                                          TupleSchema::createTupleSchema(templateTable->schema()),
+                                          templateTable->getColumnNames(),
+                                          limits))
+    , m_results()
+    , m_limits(limits)
+    , m_counters(counters)
+    , m_maxBytes(DEFAULT_MAX_BYTES)
+{
+    if (limits != NULL && limits->getMemoryLimit() > 0) {
+        m_maxBytes = limits->getMemoryLimit() / 4;
+    }
+}
+
+SubqueryResultCache::~SubqueryResultCache() {
+    // Return all of the rows' memory to the temp table limits; a temp
+    // table keeps its first block.
+    m_rows->deleteAllTempTuples();
+    if (m_limits != NULL) {
+        m_limits->reduceAllocated(static_cast<int>(m_rows->allocatedTupleMemory()));
+    }
+}
+
+bool SubqueryResultCache::restore(const std::vector<NValue>& params, AbstractTempTable* outputTable) {
+    ResultMap::const_iterator it = m_results.find(params);
+    if (it == m_results.end()) {
+        ++m_counters->misses;
+        return false;
+    }
+    ++m_counters->hits;
+    assert(outputTable->activeTupleCount() == 0);
+    const std::vector<TableTuple>& rows = it->second;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        TableTuple row = rows[i];
+        outputTable->insertTempTuple(row);
+    }
+    outputTable->finishInserts();
+    return true;
+}
+
+void SubqueryResultCache::remember(const std::vector<NValue>& params, const AbstractTempTable* outputTable) {
+    int64_t rowCount = outputTable->activeTupleCount();
+    if (rowCount > MAX_ROWS_PER_RESULT) {
+        return;
+    }
+    // Inserting the rows may take one more block.
+    int blockSize = m_rows->getTableAllocationSize();
+    if (m_results.size() >= MAX_RESULTS ||
+            m_rows->allocatedTupleMemory() + blockSize > m_maxBytes) {
+        clear();
+    }
+    if (m_limits != NULL && ! m_limits->hasRoomFor(blockSize)) {
+        // Leave the memory to the query itself.
+        clear();
+        return;
+    }
+
+    std::vector<NValue> key;
+    key.reserve(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        key.push_back(params[i].copyNValue());
+    }
+    std::vector<TableTuple>& rows = m_results[key];
+    assert(rows.empty());
+    rows.reserve(rowCount);
+    TableTuple tuple(outputTable->schema());
+    TableIterator iterator = const_cast<AbstractTempTable*>(outputTable)->iterator();
+    while (iterator.next(tuple)) {
+        rows.push_back(m_rows->appendTempTuple(tuple));
+    }
+}
+
+void SubqueryResultCache::clear() {
+    if ( ! m_results.empty()) {
+        ++m_counters->evictions;
+    }
+    m_results.clear();
+    m_rows->deleteAllTempTuples();
+}
+
+}
@@ -0,0 +1,116 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUBQUERYRESULTCACHE_H_
+#define SUBQUERYRESULTCACHE_H_
+
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "common/NValue.hpp"
+#include "common/tabletuple.h"
+
+namespace voltdb {
+
+class AbstractTempTable;
+class TempTable;
+class TempTableLimits;
+
+/** Cumulative counters of the subquery result caches of a site. */
+struct SubqueryCacheCounters {
+    SubqueryCacheCounters() : hits(0), misses(0), evictions(0) { }
+    int64_t hits;
+    int64_t misses;
+    int64_t evictions;
+};
+
+/**
+ * Results of a correlated subquery, keyed by the values of all the
+ * parameters it was run with.  When the outer rows alternate between a
+ * few correlation values, a subquery runs once per distinct value
+ * rather than once per outer row.
+ *
+ * The cached rows are shallow copies, like those of any temp table, so
+ * the cache must not outlive the fragment.  It is bounded three ways:
+ * results of more than MAX_ROWS_PER_RESULT rows are not cached, there
+ * are at most MAX_RESULTS results, and its rows, which are charged to
+ * the fragment's temp table limits, take at most a quarter of the temp
+ * table memory limit.  When it is full it is emptied and starts over.
+ */
+class SubqueryResultCache {
+public:
+    static const size_t MAX_RESULTS = 1024;
+    static const int64_t MAX_ROWS_PER_RESULT = 64;
+    // The budget when temp table memory is not limited.
+    static const int64_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+    SubqueryResultCache(const AbstractTempTable* templateTable,
+                        TempTableLimits* limits,
+                        SubqueryCacheCounters* counters);
+    ~SubqueryResultCache();
+
+    /**
+     * If a result is cached for the given parameter values, put its rows
+     * into the output table, which must be empty, and return true.
+     */
+    bool restore(const std::vector<NValue>& params, AbstractTempTable* outputTable);
+
+    /** Cache the rows of the output table as the result for the given parameter values. */
+    void remember(const std::vector<NValue>& params, const AbstractTempTable* outputTable);
+
+    size_t size() const { return m_results.size(); }
+
+private:
+    struct ParamsHasher : std::unary_function<std::vector<NValue>, std::size_t> {
+        std::size_t operator()(const std::vector<NValue>& params) const {
+            std::size_t seed = 0;
+            for (size_t i = 0; i < params.size(); ++i) {
+                params[i].hashCombine(seed);
+            }
+            return seed;
+        }
+    };
+
+    struct ParamsEqualityChecker {
+        bool operator()(const std::vector<NValue>& lhs, const std::vector<NValue>& rhs) const {
+            assert(lhs.size() == rhs.size());
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i].compare(rhs[i]) != VALUE_COMPARE_EQUAL) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    typedef boost::unordered_map<std::vector<NValue>, std::vector<TableTuple>,
+                                 ParamsHasher, ParamsEqualityChecker> ResultMap;
+
+    void clear();
+
+    // Holds the rows of all the cached results; the map points into it.
+    boost::scoped_ptr<TempTable> m_rows;
+    ResultMap m_results;
+    TempTableLimits* m_limits;
+    SubqueryCacheCounters* m_counters;
+    int64_t m_maxBytes;
+};
+
+}
+#endif // SUBQUERYRESULTCACHE_H_
@@ -24,6 +24,8 @@
 
 #include "storage/persistenttable.h"
 
+#include <chrono>
+
 #ifdef LINUX
 #include <sys/syscall.h>
 #endif
@@ -50,6 +52,10 @@ pthread_cond_t SynchronizedThreadLock::s_wakeLowestEngineCondition;
 int32_t SynchronizedThreadLock::s_SITES_PER_HOST = -1;
 int32_t SynchronizedThreadLock::s_globalTxnStartCountdownLatch = 0;
 
+// Chosen by the first engine to initialize, along with SITES_PER_HOST.
+ReplicatedBarrierType SynchronizedThreadLock::s_barrierType = REPLICATED_BARRIER_TYPE_MUTEX;
+SpinFutexBarrier SynchronizedThreadLock::s_spinFutexBarrier;
+
 bool SynchronizedThreadLock::s_inSingleThreadMode = false;
 const int32_t SynchronizedThreadLock::s_mpMemoryPartitionId = 65535;
 #ifndef  NDEBUG
@@ -88,10 +94,13 @@ void SynchronizedThreadLock::destroy() {
     s_SITES_PER_HOST = -1;
 }
 
-void SynchronizedThreadLock::init(int32_t sitesPerHost, EngineLocals& newEngineLocals) {
+void SynchronizedThreadLock::init(int32_t sitesPerHost, EngineLocals& newEngineLocals,
+                                  ReplicatedBarrierType barrierType) {
     if (s_SITES_PER_HOST == 0) {
         s_SITES_PER_HOST = sitesPerHost;
         s_globalTxnStartCountdownLatch = s_SITES_PER_HOST;
+        s_barrierType = barrierType;
+        s_spinFutexBarrier.reset(s_SITES_PER_HOST);
     }
     if (*newEngineLocals.enginePartitionId != 16383) {
         s_enginesByPartitionId[*newEngineLocals.enginePartitionId] = newEngineLocals;
@@ -190,24 +199,41 @@ bool SynchronizedThreadLock::countDownGlobalTxnStartCount(bool lowestSite) {
     assert(s_globalTxnStartCountdownLatch > 0);
     assert(ThreadLocalPool::getEnginePartitionId() != 16383);
     assert(!isInSingleThreadMode());
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    bool slept = false;
     if (lowestSite) {
-        pthread_mutex_lock(&s_sharedEngineMutex);
-        if (--s_globalTxnStartCountdownLatch != 0) {
-            pthread_cond_wait(&s_wakeLowestEngineCondition, &s_sharedEngineMutex);
+        if (s_barrierType == REPLICATED_BARRIER_TYPE_SPIN_FUTEX) {
+            slept = s_spinFutexBarrier.arriveAndWaitForAll();
+        }
+        else {
+            pthread_mutex_lock(&s_sharedEngineMutex);
+            if (--s_globalTxnStartCountdownLatch != 0) {
+                pthread_cond_wait(&s_wakeLowestEngineCondition, &s_sharedEngineMutex);
+                slept = true;
+            }
+            pthread_mutex_unlock(&s_sharedEngineMutex);
         }
-        pthread_mutex_unlock(&s_sharedEngineMutex);
+        recordBarrierWait(context, startTime, slept);
         VOLT_DEBUG("Switching context to MP partition on thread %d", ThreadLocalPool::getThreadPartitionId());
         setIsInSingleThreadMode(true);
         return true;
     }
     else {
         VOLT_DEBUG("Waiting for MP partition work to complete on thread %d", ThreadLocalPool::getThreadPartitionId());
-        pthread_mutex_lock(&s_sharedEngineMutex);
-        if (--s_globalTxnStartCountdownLatch == 0) {
-            pthread_cond_broadcast(&s_wakeLowestEngineCondition);
+        if (s_barrierType == REPLICATED_BARRIER_TYPE_SPIN_FUTEX) {
+            slept = s_spinFutexBarrier.arriveAndWaitForRelease();
+        }
+        else {
+            pthread_mutex_lock(&s_sharedEngineMutex);
+            if (--s_globalTxnStartCountdownLatch == 0) {
+                pthread_cond_broadcast(&s_wakeLowestEngineCondition);
+            }
+            pthread_cond_wait(&s_sharedEngineCondition, &s_sharedEngineMutex);
+            pthread_mutex_unlock(&s_sharedEngineMutex);
+            slept = true;
         }
-        pthread_cond_wait(&s_sharedEngineCondition, &s_sharedEngineMutex);
-        pthread_mutex_unlock(&s_sharedEngineMutex);
+        recordBarrierWait(context, startTime, slept);
         VOLT_DEBUG("Other SP partition thread released on thread %d", ThreadLocalPool::getThreadPartitionId());
         assert(!isInSingleThreadMode());
         return false;
@@ -215,6 +241,12 @@ bool SynchronizedThreadLock::countDownGlobalTxnStartCount(bool lowestSite) {
 }
 
 void SynchronizedThreadLock::signalLowestSiteFinished() {
+    if (s_barrierType == REPLICATED_BARRIER_TYPE_SPIN_FUTEX) {
+        VOLT_DEBUG("Restore context to lowest SP partition on thread %d", ThreadLocalPool::getThreadPartitionId());
+        setIsInSingleThreadMode(false);
+        s_spinFutexBarrier.release();
+        return;
+    }
     pthread_mutex_lock(&s_sharedEngineMutex);
     s_globalTxnStartCountdownLatch = s_SITES_PER_HOST;
     VOLT_DEBUG("Restore context to lowest SP partition on thread %d", ThreadLocalPool::getThreadPartitionId());
@@ -223,6 +255,17 @@ void SynchronizedThreadLock::signalLowestSiteFinished() {
     pthread_mutex_unlock(&s_sharedEngineMutex);
 }
 
+void SynchronizedThreadLock::recordBarrierWait(ExecutorContext* context,
+                                               const std::chrono::steady_clock::time_point& startTime,
+                                               bool slept) {
+    if (context == NULL) {
+        return;
+    }
+    int64_t waitNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    context->getSiteBarrierWaitCounters().recordWait(waitNanos, slept);
+}
+
 void SynchronizedThreadLock::addUndoAction(bool synchronized, UndoQuantum *uq, UndoReleaseAction* action,
         PersistentTable *table) {
     if (synchronized) {
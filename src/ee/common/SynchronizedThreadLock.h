@@ -22,6 +22,7 @@
 //#include "boost/unordered_map.hpp"
 
 #include <cassert>
+#include <chrono>
 #include <map>
 #include <stack>
 #include <string>
@@ -33,12 +34,15 @@
 #include <cstdatomic>
 #endif
 
+#include "common/SpinFutexBarrier.h"
+#include "common/types.h"
 #include "common/UndoQuantumReleaseInterest.h"
 
 class DRBinaryLogTest;
 
 namespace voltdb {
 struct EngineLocals;
+class ExecutorContext;
 class UndoQuantum;
 class UndoReleaseAction;
 typedef std::map<int32_t, EngineLocals> SharedEngineLocalsType;
@@ -62,6 +66,30 @@ public:
     void notifyQuantumRelease();
 };
 
+/**
+ * Time one site has spent in the replicated table barrier.  Each site
+ * only ever updates and reads its own counters.
+ */
+struct SiteBarrierWaitCounters {
+    SiteBarrierWaitCounters() : waits(0), sleeps(0), totalWaitNanos(0), maxWaitNanos(0) {}
+
+    void recordWait(int64_t waitNanos, bool slept) {
+        ++waits;
+        if (slept) {
+            ++sleeps;
+        }
+        totalWaitNanos += waitNanos;
+        if (waitNanos > maxWaitNanos) {
+            maxWaitNanos = waitNanos;
+        }
+    }
+
+    int64_t waits;
+    int64_t sleeps;
+    int64_t totalWaitNanos;
+    int64_t maxWaitNanos;
+};
+
 class PersistentTable;
 class ExecuteWithAllSitesMemory;
 class ReplicatedMaterializedViewHandler;
@@ -77,7 +105,8 @@ class SynchronizedThreadLock {
 public:
     static void create();
     static void destroy();
-    static void init(int32_t sitesPerHost, EngineLocals& newEngineLocals);
+    static void init(int32_t sitesPerHost, EngineLocals& newEngineLocals,
+                     ReplicatedBarrierType barrierType = REPLICATED_BARRIER_TYPE_MUTEX);
     static void resetMemory(int32_t partitionId);
 
     /**
@@ -85,6 +114,7 @@ public:
      */
     static bool countDownGlobalTxnStartCount(bool lowestSite);
     static void signalLowestSiteFinished();
+    static ReplicatedBarrierType barrierType() { return s_barrierType; }
 
     /**
      * Add a new undo action possibly in a synchronized manner.
@@ -130,6 +160,10 @@ private:
     static void lockReplicatedResourceForInit();
     static void unlockReplicatedResourceForInit();
 
+    static void recordBarrierWait(ExecutorContext* context,
+                                  const std::chrono::steady_clock::time_point& startTime,
+                                  bool slept);
+
     static bool s_inSingleThreadMode;
 #ifndef  NDEBUG
     static bool s_usingMpMemory;
@@ -140,6 +174,8 @@ private:
     static pthread_cond_t s_wakeLowestEngineCondition;
     static int32_t s_globalTxnStartCountdownLatch;
     static int32_t s_SITES_PER_HOST;
+    static ReplicatedBarrierType s_barrierType;
+    static SpinFutexBarrier s_spinFutexBarrier;
     static EngineLocals s_mpEngine;
     static SharedEngineLocalsType s_enginesByPartitionId;
 
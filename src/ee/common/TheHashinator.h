@@ -74,6 +74,32 @@ class TheHashinator {
         }
     }
 
+    /**
+     * Pick the partition for each of count values, with the same result as
+     * calling hashinate() on each.  Non null integer values are gathered and
+     * hashed in runs by hashinateIntegers().
+     */
+    void hashinateBatch(const NValue *values, int32_t count, int32_t *partitions) const
+    {
+        int64_t keys[INTEGER_BATCH_SIZE];
+        int32_t positions[INTEGER_BATCH_SIZE];
+        int32_t batched = 0;
+        for (int32_t i = 0; i < count; i++) {
+            const NValue &value = values[i];
+            if (value.isNull() || ! isIntegralType(ValuePeeker::peekValueType(value))) {
+                partitions[i] = hashinate(value);
+                continue;
+            }
+            keys[batched] = ValuePeeker::peekAsRawInt64(value);
+            positions[batched] = i;
+            if (++batched == INTEGER_BATCH_SIZE) {
+                hashinateGathered(keys, positions, batched, partitions);
+                batched = 0;
+            }
+        }
+        hashinateGathered(keys, positions, batched, partitions);
+    }
+
     /*
      * Given a previously calculated hash value pick the partition to store the data in
      */
@@ -100,6 +126,30 @@ class TheHashinator {
      * pick a partition to store the data
      */
     virtual int32_t hashinate(const char *string, int32_t length) const = 0;
+
+    /*
+     * Given a run of integer keys pick the partition for each.  Hashinators
+     * that can hash several keys at once override this.
+     */
+    virtual void hashinateIntegers(const int64_t *values, int32_t count, int32_t *partitions) const
+    {
+        for (int32_t i = 0; i < count; i++) {
+            partitions[i] = hashinate(values[i]);
+        }
+    }
+
+  private:
+    static const int32_t INTEGER_BATCH_SIZE = 64;
+
+    void hashinateGathered(const int64_t *keys, const int32_t *positions, int32_t count,
+                           int32_t *partitions) const
+    {
+        int32_t keyPartitions[INTEGER_BATCH_SIZE];
+        hashinateIntegers(keys, count, keyPartitions);
+        for (int32_t i = 0; i < count; i++) {
+            partitions[positions[i]] = keyPartitions[i];
+        }
+    }
 };
 
 } // namespace voltdb
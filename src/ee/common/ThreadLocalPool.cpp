@@ -220,15 +220,20 @@ int32_t getAllocationSizeForObject(int length) {
     target |= target >> 8;
     target |= target >> 16;
     target++;
-    // Try to shrink the target to "midway" down to the previous power of 2,
-    // if the length fits.
-    // Strictly speaking, a geometric mean (dividing the even power by sqrt(2))
-    // would give a more consistently proportional over-allocation for values
-    // at slightly different scales, but the arithmetic mean (3/4 of the power)
-    // is fast to calculate and close enough for our purposes.
-    int threeQuartersTarget = target - (target >> 2);
-    if (length_to_fit < threeQuartersTarget) {
-        target = threeQuartersTarget;
+    // Split the range down to the previous power of 2 into four size
+    // classes, an eighth of the power apart, and pick the smallest one
+    // that fits. This bounds the over-allocation to about 25%.
+    // Below 64 bytes that would give classes that are not a multiple of
+    // 8 bytes, so only shrink the target to "midway" (3/4 of the power).
+    int step = target >> 3;
+    if (step >= 8) {
+        target -= ((target - length_to_fit) / step) * step;
+    }
+    else {
+        int threeQuartersTarget = target - (target >> 2);
+        if (length_to_fit < threeQuartersTarget) {
+            target = threeQuartersTarget;
+        }
     }
     if (target <= MAX_ALLOCATION) {
         return target;
@@ -264,6 +269,13 @@ int32_t ThreadLocalPool::getAllocationSizeForRelocatable(Sized* data)
 void ThreadLocalPool::freeRelocatable(Sized* data)
 { delete [] reinterpret_cast<char*>(data); }
 
+void ThreadLocalPool::setDeferRelocatableCompaction(bool defer) { }
+
+int32_t ThreadLocalPool::compactRelocatables(int32_t maxRelocations)
+{ return 0; }
+
+void ThreadLocalPool::getRelocatableFragmentation(RelocatableFragmentation& fragmentation) { }
+
 #else // not MEMCHECK
 
 PoolPairTypePtr ThreadLocalPool::getDataPoolPair()
@@ -275,6 +287,13 @@ namespace {
 CompactingStringStorage &getStringPoolMap() {
     return *static_cast<CompactingStringStorage *>(pthread_getspecific(m_stringKey));
 }
+
+bool s_deferRelocatableCompaction = false;
+}
+
+void ThreadLocalPool::setDeferRelocatableCompaction(bool defer)
+{
+    s_deferRelocatableCompaction = defer;
 }
 
 ThreadLocalPool::Sized* ThreadLocalPool::allocateRelocatable(char** referrer, int32_t sz)
@@ -302,7 +321,11 @@ ThreadLocalPool::Sized* ThreadLocalPool::allocateRelocatable(char** referrer, in
         // Compute num_elements to be the largest multiple of alloc_size
         // to fit in a 2MB buffer.
         int32_t num_elements = ((2 * 1024 * 1024 - 1) / alloc_size) + 1;
-        boost::shared_ptr<CompactingPool> pool(new CompactingPool(alloc_size, num_elements));
+        // Replicated table strings are shared by all the sites, so their
+        // pools can not be compacted between one site's transactions.
+        bool defer = s_deferRelocatableCompaction &&
+                &poolMap != SynchronizedThreadLock::getMpEngine().stringData;
+        boost::shared_ptr<CompactingPool> pool(new CompactingPool(alloc_size, num_elements, defer));
         poolMap.insert(std::pair<int32_t, boost::shared_ptr<CompactingPool> >(alloc_size, pool));
         allocation = pool->malloc(referrer);
     }
@@ -349,6 +372,32 @@ void ThreadLocalPool::freeRelocatable(Sized* sized)
     }
 }
 
+int32_t ThreadLocalPool::compactRelocatables(int32_t maxRelocations)
+{
+    int32_t relocated = 0;
+    CompactingStringStorage& poolMap = getStringPoolMap();
+    for (CompactingStringStorage::iterator iter = poolMap.begin();
+         iter != poolMap.end() && relocated < maxRelocations; ++iter) {
+        relocated += iter->second->compact(maxRelocations - relocated);
+    }
+    return relocated;
+}
+
+void ThreadLocalPool::getRelocatableFragmentation(RelocatableFragmentation& fragmentation)
+{
+    CompactingStringStorage& poolMap = getStringPoolMap();
+    for (CompactingStringStorage::iterator iter = poolMap.begin(); iter != poolMap.end(); ++iter) {
+        const CompactingPool& pool = *iter->second;
+        int64_t live = pool.getSlotCount() - pool.getHoleCount();
+        ++fragmentation.sizeClasses;
+        fragmentation.liveAllocations += live;
+        fragmentation.holes += pool.getHoleCount();
+        fragmentation.allocatedBytes += pool.getBytesAllocated();
+        fragmentation.liveBytes += live * pool.getSlotSize();
+        fragmentation.relocations += pool.getRelocationCount();
+    }
+}
+
 #endif
 
 void* ThreadLocalPool::allocateExactSizedObject(std::size_t sz)
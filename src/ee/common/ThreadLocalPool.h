@@ -31,6 +31,24 @@ namespace voltdb {
 
 typedef boost::unordered_map<int32_t, boost::shared_ptr<CompactingPool> > CompactingStringStorage;
 
+/**
+ * Snapshot of how well a site's relocatable (string) storage is packed.
+ */
+struct RelocatableFragmentation {
+    RelocatableFragmentation()
+      : sizeClasses(0), liveAllocations(0), holes(0),
+        allocatedBytes(0), liveBytes(0), relocations(0) {}
+
+    int64_t sizeClasses;
+    int64_t liveAllocations;
+    // Freed allocations waiting for compactRelocatables().
+    int64_t holes;
+    // Bytes of buffers held by the pools and bytes of live allocations.
+    int64_t allocatedBytes;
+    int64_t liveBytes;
+    int64_t relocations;
+};
+
 struct voltdb_pool_allocator_new_delete
 {
     typedef std::size_t size_type;
@@ -198,6 +216,24 @@ public:
      */
     static void freeRelocatable(Sized* string);
 
+    /**
+     * Make the relocatable pools created from now on on sites (not the
+     * shared replicated table pools) leave holes on free instead of
+     * compacting right away.  The holes are filled in by
+     * compactRelocatables().
+     */
+    static void setDeferRelocatableCompaction(bool defer);
+
+    /**
+     * Incrementally compact the current site's relocatable pools, moving at
+     * most maxRelocations allocations, and release the buffers of emptied
+     * pools.  Must only be called between transactions.
+     * @return the number of allocations moved.
+     */
+    static int32_t compactRelocatables(int32_t maxRelocations);
+
+    static void getRelocatableFragmentation(RelocatableFragmentation& fragmentation);
+
     static void resetStateForTest();
     static int32_t* getThreadPartitionIdForTest();
     static void setThreadPartitionIdForTest(int32_t* partitionId);
@@ -16,6 +16,7 @@
  */
 #include "common/Topend.h"
 #include "common/StreamBlock.h"
+#include "common/StreamBufferPool.h"
 #include "storage/table.h"
 #include "storage/persistenttable.h"
 #include "storage/tablefactory.h"
@@ -78,7 +79,7 @@ namespace voltdb {
         signatures.push(signature);
         generationIds.push(generationId);
         exportBlocks.push_back(boost::shared_ptr<ExportStreamBlock>(new ExportStreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
         receivedExportBuffer = true;
     }
 
@@ -93,14 +94,14 @@ namespace voltdb {
         receivedDRBuffer = true;
         partitionIds.push(partitionId);
         drBlocks.push_back(boost::shared_ptr<DrStreamBlock>(new DrStreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
         return pushDRBufferRetval;
     }
 
     void DummyTopend::pushPoisonPill(int32_t partitionId, std::string& reason, DrStreamBlock *block) {
         partitionIds.push(partitionId);
         drBlocks.push_back(boost::shared_ptr<DrStreamBlock>(new DrStreamBlock(block)));
-        data.push_back(boost::shared_array<char>(block->rawPtr()));
+        data.push_back(boost::shared_array<char>(block->rawPtr(), StreamBufferPool::release));
     }
 
 
@@ -153,6 +153,15 @@ namespace voltdb
             }
         }
 
+        /*
+         * True while any quantum can still be undone. Undo actions hold
+         * raw tuple addresses, so tuples must not be moved in the meantime.
+         */
+        bool hasPendingQuantums() const
+        {
+            return ! m_undoQuantums.empty();
+        }
+
         int64_t getSize() const
         {
             int64_t total = 0;
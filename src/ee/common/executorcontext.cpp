@@ -112,9 +112,12 @@ ExecutorContext::ExecutorContext(int64_t siteId,
     m_undoQuantum(undoQuantum),
     m_staticParams(MAX_PARAM_COUNT),
     m_usedParamcnt(0),
+    m_executionEpoch(0),
     m_tuplesModifiedStack(),
     m_executorsMap(NULL),
     m_subqueryContextMap(),
+    m_tempTableLimits(NULL),
+    m_subqueryCacheCounters(),
     m_drStream(drStream),
     m_drReplicatedStream(drReplicatedStream),
     m_engine(engine),
@@ -194,6 +197,7 @@ UniqueTempTableResult ExecutorContext::executeExecutors(const std::vector<Abstra
     // all of its children are positioned before it in this list,
     // therefore dependency tracking is not needed here.
     int ctr = 0;
+    ++m_executionEpoch;
     try {
         BOOST_FOREACH (AbstractExecutor *executor, executorList) {
             assert(executor);
@@ -27,7 +27,10 @@
 #include "common/UniqueId.hpp"
 #include "execution/ExecutorVector.h"
 #include "execution/VoltDBEngine.h"
+#include "common/HugePageAllocator.h"
+#include "common/StreamBufferPool.h"
 #include "common/ThreadLocalPool.h"
+#include "common/SynchronizedThreadLock.h"
 
 #include <vector>
 #include <stack>
@@ -158,9 +161,11 @@ class ExecutorContext {
         m_undoQuantum = undoQuantum;
     }
 
-    void setupForExecutors(std::map<int, std::vector<AbstractExecutor*>* >* executorsMap) {
+    void setupForExecutors(std::map<int, std::vector<AbstractExecutor*>* >* executorsMap,
+                           TempTableLimits* limits = NULL) {
         assert(executorsMap != NULL);
         m_executorsMap = executorsMap;
+        m_tempTableLimits = limits;
         assert(m_subqueryContextMap.empty());
 
         assert(m_commonTableMap.empty());
@@ -268,6 +273,13 @@ class ExecutorContext {
         return &(m_subqueryContextMap.find(subqueryId)->second);
     }
 
+    /** Temp table limits of the fragment being executed, or NULL */
+    TempTableLimits* getTempTableLimits() const { return m_tempTableLimits; }
+
+    /** Hits, misses and evictions of the subquery result caches of this site */
+    const SubqueryCacheCounters& getSubqueryCacheCounters() const { return m_subqueryCacheCounters; }
+    SubqueryCacheCounters* accessSubqueryCacheCounters() { return &m_subqueryCacheCounters; }
+
     /**
      * Execute all the executors in the given vector.
      *
@@ -362,6 +374,14 @@ class ExecutorContext {
     NValueArray& getParameterContainer() { return m_staticParams; }
     const NValueArray& getParameterContainer() const { return m_staticParams; }
 
+    /**
+     * Incremented each time a list of executors starts running.  Every
+     * change to the parameter container is followed by such a run, so a
+     * value derived only from parameters stays valid for as long as the
+     * epoch does not change (see FoldedExpression).
+     */
+    int64_t executionEpoch() const { return m_executionEpoch; }
+
     void pushNewModifiedTupleCounter() { m_tuplesModifiedStack.push(0); }
     void popModifiedTupleCounter() { m_tuplesModifiedStack.pop(); }
     const int64_t getModifiedTupleCount() const {
@@ -443,6 +463,18 @@ class ExecutorContext {
         return &m_lttBlockCache;
     }
 
+    SiteBarrierWaitCounters& getSiteBarrierWaitCounters() {
+        return m_siteBarrierWaitCounters;
+    }
+
+    HugePageAllocationCounters& getHugePageAllocationCounters() {
+        return m_hugePageAllocationCounters;
+    }
+
+    StreamBufferPool& getStreamBufferPool() {
+        return m_streamBufferPool;
+    }
+
   private:
     /**
      * This holds the top end for this executor context.  Don't
@@ -460,6 +492,7 @@ class ExecutorContext {
     NValueArray m_staticParams;
     /** TODO : should be passed as execute() parameter..*/
     int m_usedParamcnt;
+    int64_t m_executionEpoch;
 
     /** Counts tuples modified by a plan fragments.  Top of stack is the
      * most deeply nested executing plan fragment.
@@ -471,6 +504,8 @@ class ExecutorContext {
     std::map<int, std::vector<AbstractExecutor*>* >* m_executorsMap;
     std::map<std::string, AbstractTempTable*> m_commonTableMap;
     std::map<int, SubqueryContext> m_subqueryContextMap;
+    TempTableLimits* m_tempTableLimits;
+    SubqueryCacheCounters m_subqueryCacheCounters;
 
     AbstractDRTupleStream *m_drStream;
     AbstractDRTupleStream *m_drReplicatedStream;
@@ -482,6 +517,9 @@ class ExecutorContext {
     int64_t m_currentDRTimestamp;
     LargeTempTableBlockCache m_lttBlockCache;
     bool m_traceOn;
+    SiteBarrierWaitCounters m_siteBarrierWaitCounters;
+    HugePageAllocationCounters m_hugePageAllocationCounters;
+    StreamBufferPool m_streamBufferPool;
 
   public:
     int64_t m_lastCommittedSpHandle;
@@ -20,7 +20,10 @@
 
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "common/NValue.hpp"
+#include "common/SubqueryResultCache.h"
 
 namespace voltdb {
 
@@ -36,6 +39,8 @@ namespace voltdb {
 *    could get executed once per unique value.
 * The subquery context is registered with the global executor context as candidates for
 * post-fragment cleanup, allowing results to be retained between invocations.
+* A correlated subquery also gets a result cache, so that a change of parameters
+* back to values it has already seen in this fragment does not rerun it.
 */
 struct SubqueryContext {
     SubqueryContext(std::vector<NValue> lastParams)
@@ -46,6 +51,7 @@ struct SubqueryContext {
     SubqueryContext(const SubqueryContext& other)
       : m_hasValidResult(other.m_hasValidResult)
       , m_lastParams(other.m_lastParams)
+      , m_resultCache(other.m_resultCache)
     {
         if (m_hasValidResult) {
             m_lastResult = other.m_lastResult;
@@ -65,12 +71,17 @@ struct SubqueryContext {
 
     std::vector<NValue>& accessLastParams() { return m_lastParams; }
 
+    SubqueryResultCache* getResultCache() const { return m_resultCache.get(); }
+    void setResultCache(SubqueryResultCache* cache) { m_resultCache.reset(cache); }
+
 private:
     bool m_hasValidResult;
     NValue m_lastResult;
     // The parameter values that were used to obtain the last result in the ascending
     // order of the parameter indexes
     std::vector<NValue> m_lastParams;
+    // Shared by the copies the context map makes; NULL for a subquery without parameters
+    boost::shared_ptr<SubqueryResultCache> m_resultCache;
 };
 
 }
@@ -457,7 +457,38 @@ inline bool tableStreamTypeIsStreamIndexing(TableStreamType streamType) {
 // ------------------------------------------------------------------
 enum StatisticsSelectorType {
     STATISTICS_SELECTOR_TYPE_TABLE,
-    STATISTICS_SELECTOR_TYPE_INDEX
+    STATISTICS_SELECTOR_TYPE_INDEX,
+    // Per-site (not per-table) statistics.  These ignore the locators.
+    STATISTICS_SELECTOR_TYPE_SITE_BARRIER,
+    STATISTICS_SELECTOR_TYPE_HUGE_PAGE_ALLOCATOR,
+    STATISTICS_SELECTOR_TYPE_STRING_POOL,
+    STATISTICS_SELECTOR_TYPE_COMPACTION,
+    STATISTICS_SELECTOR_TYPE_STREAM_BUFFER_POOL,
+    STATISTICS_SELECTOR_TYPE_PLAN_CACHE,
+    STATISTICS_SELECTOR_TYPE_SUBQUERY_CACHE
+};
+
+// ------------------------------------------------------------------
+// Barrier used to synchronize all the sites of a host around
+// replicated table writes.
+// ------------------------------------------------------------------
+enum ReplicatedBarrierType {
+    // pthread mutex and condition variables.
+    REPLICATED_BARRIER_TYPE_MUTEX = 0,
+    // Sense-reversing barrier which spins, then sleeps on a futex.
+    REPLICATED_BARRIER_TYPE_SPIN_FUTEX = 1
+};
+
+// ------------------------------------------------------------------
+// Backing of the large blocks holding tuples and index nodes.
+// ------------------------------------------------------------------
+enum HugePageMode {
+    // Plain heap allocations.
+    HUGE_PAGE_MODE_NONE = 0,
+    // 2MB aligned mappings advised to use transparent huge pages.
+    HUGE_PAGE_MODE_TRANSPARENT = 1,
+    // Pre-reserved hugetlbfs pages, falling back to transparent ones.
+    HUGE_PAGE_MODE_EXPLICIT = 2
 };
 
 // ------------------------------------------------------------------
@@ -178,7 +178,7 @@ void ExecutorVector::initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node)
 }
 
 void ExecutorVector::setupContext(ExecutorContext* executorContext) {
-    executorContext->setupForExecutors(&m_subplanExecListMap);
+    executorContext->setupForExecutors(&m_subplanExecListMap, &m_limits);
 }
 
 void ExecutorVector::resetLimitStats() { m_limits.resetPeakMemory(); }
@@ -0,0 +1,136 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "execution/PlanCacheStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> PlanCacheStats::generatePlanCacheStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("CACHE_HITS");
+    columnNames.push_back("CACHE_MISSES");
+    columnNames.push_back("LOAD_NANOS");
+    columnNames.push_back("SHARED_HITS");
+    columnNames.push_back("SHARED_MISSES");
+    columnNames.push_back("SHARED_EVICTIONS");
+    columnNames.push_back("SHARED_PARSE_NANOS");
+    columnNames.push_back("SHARED_PLANS");
+    return columnNames;
+}
+
+void PlanCacheStats::populatePlanCacheStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 8; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* PlanCacheStats::generateEmptyPlanCacheStatsTable() {
+    string name = "Plan cache stats temp table";
+    vector<string> columnNames = PlanCacheStats::generatePlanCacheStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    PlanCacheStats::populatePlanCacheStatsSchema(columnTypes, columnLengths,
+                                                 columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+PlanCacheStats::PlanCacheStats(const PlanCacheCounters& counters, bool reportSharedCounters)
+    : StatsSource(), m_counters(counters), m_reportSharedCounters(reportSharedCounters),
+      m_lastCounters(), m_lastSharedCounters()
+{
+}
+
+PlanCacheStats::~PlanCacheStats() {
+    m_tableName.free();
+}
+
+void PlanCacheStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+}
+
+vector<string> PlanCacheStats::generateStatsColumnNames() {
+    return PlanCacheStats::generatePlanCacheStatsColumnNames();
+}
+
+void PlanCacheStats::updateStatsTuple(TableTuple *tuple) {
+    // The number of shared plans is a current value; the rest are cumulative.
+    // The shared counters are host wide, so only one site reports them.
+    PlanCacheCounters counters = m_counters;
+    SharedPlanCacheCounters sharedCounters;
+    if (m_reportSharedCounters) {
+        sharedCounters = SharedPlanCache::instance().counters();
+    }
+    int64_t hits = counters.hits;
+    int64_t misses = counters.misses;
+    int64_t loadNanos = counters.loadNanos;
+    int64_t sharedHits = sharedCounters.hits;
+    int64_t sharedMisses = sharedCounters.misses;
+    int64_t sharedEvictions = sharedCounters.evictions;
+    int64_t sharedParseNanos = sharedCounters.parseNanos;
+    if (interval()) {
+        hits -= m_lastCounters.hits;
+        misses -= m_lastCounters.misses;
+        loadNanos -= m_lastCounters.loadNanos;
+        sharedHits -= m_lastSharedCounters.hits;
+        sharedMisses -= m_lastSharedCounters.misses;
+        sharedEvictions -= m_lastSharedCounters.evictions;
+        sharedParseNanos -= m_lastSharedCounters.parseNanos;
+        m_lastCounters = counters;
+        m_lastSharedCounters = sharedCounters;
+    }
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_HITS"],
+                     ValueFactory::getBigIntValue(hits));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_MISSES"],
+                     ValueFactory::getBigIntValue(misses));
+    tuple->setNValue(StatsSource::m_columnName2Index["LOAD_NANOS"],
+                     ValueFactory::getBigIntValue(loadNanos));
+    tuple->setNValue(StatsSource::m_columnName2Index["SHARED_HITS"],
+                     ValueFactory::getBigIntValue(sharedHits));
+    tuple->setNValue(StatsSource::m_columnName2Index["SHARED_MISSES"],
+                     ValueFactory::getBigIntValue(sharedMisses));
+    tuple->setNValue(StatsSource::m_columnName2Index["SHARED_EVICTIONS"],
+                     ValueFactory::getBigIntValue(sharedEvictions));
+    tuple->setNValue(StatsSource::m_columnName2Index["SHARED_PARSE_NANOS"],
+                     ValueFactory::getBigIntValue(sharedParseNanos));
+    tuple->setNValue(StatsSource::m_columnName2Index["SHARED_PLANS"],
+                     ValueFactory::getBigIntValue(sharedCounters.plans));
+}
+
+void PlanCacheStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    PlanCacheStats::populatePlanCacheStatsSchema(types, columnLengths, allowNull, inBytes);
+}
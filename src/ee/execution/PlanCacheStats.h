@@ -0,0 +1,74 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLANCACHESTATS_H_
+#define PLANCACHESTATS_H_
+
+#include "stats/StatsSource.h"
+#include "execution/SharedPlanCache.h"
+
+namespace voltdb {
+class TempTable;
+
+/**
+ * StatsSource extension reporting a site's executor cache hit rate and
+ * load time, along with the host wide SharedPlanCache they sit in front of.
+ * Only one site of the host reports the shared counters, so that summing the
+ * rows of all the sites does not count them once per site.
+ */
+class PlanCacheStats : public StatsSource {
+public:
+    static std::vector<std::string> generatePlanCacheStatsColumnNames();
+
+    static void populatePlanCacheStatsSchema(std::vector<voltdb::ValueType>& types,
+                                             std::vector<int32_t>& columnLengths,
+                                             std::vector<bool>& allowNull,
+                                             std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyPlanCacheStatsTable();
+
+    PlanCacheStats(const PlanCacheCounters& counters, bool reportSharedCounters);
+
+    ~PlanCacheStats();
+
+    /**
+     * Configure the StatsSource superclass.
+     */
+    void configure(std::string name);
+
+protected:
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    const PlanCacheCounters& m_counters;
+
+    // False for all sites but one, which then report zero shared counters.
+    const bool m_reportSharedCounters;
+
+    // Counter values at the last interval poll.
+    PlanCacheCounters m_lastCounters;
+    SharedPlanCacheCounters m_lastSharedCounters;
+};
+
+}
+
+#endif /* PLANCACHESTATS_H_ */
@@ -0,0 +1,85 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "execution/SharedPlanCache.h"
+
+#include "common/PlannerDomValue.h"
+
+#include <chrono>
+
+namespace voltdb {
+
+SharedPlanCache& SharedPlanCache::instance() {
+    static SharedPlanCache cache;
+    return cache;
+}
+
+SharedPlanCache::SharedPlanCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+boost::shared_ptr<PlannerDomRoot> SharedPlanCache::get(const std::string& plan) {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        EntrySet::nth_index<1>::type::iterator iter = m_entries.get<1>().find(plan);
+        if (iter != m_entries.get<1>().end()) {
+            m_entries.relocate(m_entries.begin(), m_entries.project<0>(iter));
+            ++m_counters.hits;
+            return iter->root;
+        }
+    }
+
+    // Parse outside the lock so that sites loading different plans do not
+    // wait on each other.  Two sites missing on the same plan at once both
+    // parse it and the second keeps the first one's copy.
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    boost::shared_ptr<PlannerDomRoot> root(new PlannerDomRoot(plan.data(), plan.size()));
+    int64_t parseNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    ++m_counters.misses;
+    m_counters.parseNanos += parseNanos;
+    if (root->hasParseError()) {
+        return root;
+    }
+    std::pair<EntrySet::iterator, bool> inserted = m_entries.push_front(Entry(plan, root));
+    if ( ! inserted.second) {
+        m_entries.relocate(m_entries.begin(), inserted.first);
+        return inserted.first->root;
+    }
+    while (m_entries.size() > m_capacity) {
+        m_entries.pop_back();
+        ++m_counters.evictions;
+    }
+    return root;
+}
+
+SharedPlanCacheCounters SharedPlanCache::counters() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    SharedPlanCacheCounters counters = m_counters;
+    counters.plans = static_cast<int64_t>(m_entries.size());
+    return counters;
+}
+
+void SharedPlanCache::clear() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_entries.clear();
+}
+
+}
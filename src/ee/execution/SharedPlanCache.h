@@ -0,0 +1,110 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHAREDPLANCACHE_H_
+#define SHAREDPLANCACHE_H_
+
+#include <string>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+// The next #define limits the number of features pulled into the build
+// We don't use those features.
+#define BOOST_MULTI_INDEX_DISABLE_SERIALIZATION
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace voltdb {
+class PlannerDomRoot;
+
+/** Counters of a site's fragment id keyed executor cache. */
+struct PlanCacheCounters {
+    PlanCacheCounters() : hits(0), misses(0), loadNanos(0) {}
+
+    int64_t hits;
+    int64_t misses;
+    // Time spent building executor vectors on misses.
+    int64_t loadNanos;
+};
+
+/** Counters of the host wide SharedPlanCache. */
+struct SharedPlanCacheCounters {
+    SharedPlanCacheCounters() : hits(0), misses(0), evictions(0), parseNanos(0), plans(0) {}
+
+    int64_t hits;
+    int64_t misses;
+    int64_t evictions;
+    // Time spent parsing or decoding plans on misses.
+    int64_t parseNanos;
+    int64_t plans;
+};
+
+/**
+ * LRU cache of parsed plan DOMs shared by all the sites of a process and
+ * keyed by the plan text (JSON or PlannerDomBinary).  A burst of ad hoc
+ * queries is parsed once per host instead of once per site.
+ *
+ * The cached roots are only ever read.  Each site still builds its own
+ * plan nodes from them, since executors attach themselves and their output
+ * tables to the plan nodes.
+ */
+class SharedPlanCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 1000;
+
+    static SharedPlanCache& instance();
+
+    explicit SharedPlanCache(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Return the parsed DOM of the plan, parsing it on a miss.  Plans that
+     * do not parse are returned but not cached.
+     */
+    boost::shared_ptr<PlannerDomRoot> get(const std::string& plan);
+
+    SharedPlanCacheCounters counters() const;
+
+    void clear();
+
+private:
+    struct Entry {
+        Entry(const std::string& plan, const boost::shared_ptr<PlannerDomRoot>& root)
+            : plan(plan), root(root) {}
+
+        std::string plan;
+        boost::shared_ptr<PlannerDomRoot> root;
+    };
+
+    typedef boost::multi_index::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::member<Entry, std::string, &Entry::plan> >
+        >
+    > EntrySet;
+
+    mutable std::mutex m_mutex;
+    EntrySet m_entries;
+    const size_t m_capacity;
+    SharedPlanCacheCounters m_counters;
+};
+
+}
+
+#endif // SHAREDPLANCACHE_H_
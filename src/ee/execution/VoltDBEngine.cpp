@@ -62,12 +62,18 @@
 
 #include "common/ElasticHashinator.h"
 #include "common/ExecuteWithMpMemory.h"
+#include "common/HugePageAllocatorStats.h"
 #include "common/InterruptException.h"
 #include "common/RecoveryProtoMessage.h"
+#include "common/SiteBarrierStats.h"
+#include "common/StreamBufferPoolStats.h"
+#include "common/StringPoolStats.h"
+#include "common/SubqueryCacheStats.h"
 #include "common/TupleOutputStream.h"
 #include "common/TupleOutputStreamProcessor.h"
 
 #include "common/SynchronizedThreadLock.h"
+#include "execution/PlanCacheStats.h"
 #include "executors/abstractexecutor.h"
 #include "expressions/functionexpression.h"
 
@@ -75,8 +81,11 @@
 #include "indexes/tableindexfactory.h"
 
 #include "storage/AbstractDRTupleStream.h"
+#include "storage/CompactionScheduler.h"
+#include "storage/CompactionStats.h"
 #include "storage/DRTupleStream.h"
 #include "storage/ExecuteTaskUndoGenerateDREventAction.h"
+#include "storage/ExportTupleStream.h"
 #include "storage/MaterializedViewHandler.h"
 #include "storage/MaterializedViewTriggerForWrite.h"
 #include "storage/streamedtable.h"
@@ -118,6 +127,11 @@ ENABLE_BOOST_FOREACH_ON_CONST_MAP(Table);
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Function);
 
 static const size_t PLAN_CACHE_SIZE = 1000;
+// How many relocatable strings each tick may move to fill freed holes.
+static const int32_t STRING_RELOCATIONS_PER_TICK = 1000;
+// How many tuples, and how much time, each tick may spend compacting table blocks.
+static const int32_t COMPACTION_TUPLES_PER_TICK = 10000;
+static const int64_t COMPACTION_MICROS_PER_TICK = 2000;
 // table name prefix of DR conflict table
 const std::string DR_REPLICATED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_REPLICATED";
 const std::string DR_PARTITIONED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_PARTITIONED";
@@ -193,7 +207,13 @@ VoltDBEngine::initialize(int32_t clusterIndex,
                          int64_t tempTableMemoryLimit,
                          bool isLowestSiteId,
                          int32_t compactionThreshold,
-                         int32_t exportFlushTimeout)
+                         int32_t exportFlushTimeout,
+                         ReplicatedBarrierType barrierType,
+                         HugePageMode hugePageMode,
+                         bool bindToNumaNode,
+                         bool deferStringCompaction,
+                         int32_t prefaultedStreamBuffers,
+                         bool compressDRBuffers)
 {
     m_clusterIndex = clusterIndex;
     m_siteId = siteId;
@@ -237,6 +257,7 @@ VoltDBEngine::initialize(int32_t clusterIndex,
 
     // configure DR stream
     m_drStream = new DRTupleStream(partitionId, static_cast<size_t>(defaultDrBufferSize));
+    m_drStream->setCompressBuffers(compressDRBuffers);
 
     // required for catalog loading.
     m_executorContext = new ExecutorContext(siteId,
@@ -256,8 +277,46 @@ VoltDBEngine::initialize(int32_t clusterIndex,
     VOLT_DEBUG("Initializing partition %d (tid %ld) with context %p", m_partitionId,
             SynchronizedThreadLock::getThreadId(), m_executorContext);
     EngineLocals newLocals = EngineLocals(ExecutorContext::getExecutorContext());
-    SynchronizedThreadLock::init(sitesPerHost, newLocals);
+    SynchronizedThreadLock::init(sitesPerHost, newLocals, barrierType);
+    HugePageAllocator::configure(hugePageMode, bindToNumaNode);
+    ThreadLocalPool::setDeferRelocatableCompaction(deferStringCompaction);
     SynchronizedThreadLock::unlockReplicatedResourceForInit();
+
+    HugePageAllocationCounters& allocationCounters = m_executorContext->getHugePageAllocationCounters();
+    HugePageAllocator::bindCurrentThreadToLocalNode(&allocationCounters);
+    m_hugePageAllocatorStats.reset(new HugePageAllocatorStats(allocationCounters));
+    m_hugePageAllocatorStats->configure("Huge page allocator stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_HUGE_PAGE_ALLOCATOR, 0,
+                                       m_hugePageAllocatorStats.get());
+
+    m_stringPoolStats.reset(new StringPoolStats());
+    m_stringPoolStats->configure("String pool stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_STRING_POOL, 0, m_stringPoolStats.get());
+
+    m_compactionScheduler.reset(new CompactionScheduler(COMPACTION_TUPLES_PER_TICK, COMPACTION_MICROS_PER_TICK));
+    m_compactionStats.reset(new CompactionStats(m_compactionScheduler->counters()));
+    m_compactionStats->configure("Compaction stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_COMPACTION, 0, m_compactionStats.get());
+
+    // Fault in a few export sized buffers up front so the first blocks pushed don't pay for it
+    StreamBufferPool& streamBufferPool = m_executorContext->getStreamBufferPool();
+    streamBufferPool.reserve(EL_BUFFER_SIZE, prefaultedStreamBuffers);
+    m_streamBufferPoolStats.reset(new StreamBufferPoolStats(streamBufferPool));
+    m_streamBufferPoolStats->configure("Stream buffer pool stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_STREAM_BUFFER_POOL, 0,
+                                       m_streamBufferPoolStats.get());
+
+    m_planCacheStats.reset(new PlanCacheStats(m_planCacheCounters, m_isLowestSite));
+    m_planCacheStats->configure("Plan cache stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_PLAN_CACHE, 0, m_planCacheStats.get());
+
+    m_subqueryCacheStats.reset(new SubqueryCacheStats(m_executorContext->getSubqueryCacheCounters()));
+    m_subqueryCacheStats->configure("Subquery cache stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_SUBQUERY_CACHE, 0, m_subqueryCacheStats.get());
+
+    m_siteBarrierStats.reset(new SiteBarrierStats(m_executorContext->getSiteBarrierWaitCounters()));
+    m_siteBarrierStats->configure("Site barrier stats");
+    m_statsManager.registerStatsSource(STATISTICS_SELECTOR_TYPE_SITE_BARRIER, 0, m_siteBarrierStats.get());
 }
 
 VoltDBEngine::~VoltDBEngine() {
@@ -327,12 +386,26 @@ VoltDBEngine::~VoltDBEngine() {
             delete labeledInfo.second;
         }
 
+        m_siteBarrierStats.reset();
+        m_hugePageAllocatorStats.reset();
+        m_stringPoolStats.reset();
+        m_compactionStats.reset();
+        m_streamBufferPoolStats.reset();
+        m_planCacheStats.reset();
+        m_subqueryCacheStats.reset();
         delete m_executorContext;
 
         delete m_drReplicatedStream;
         delete m_drStream;
     }
     else {
+        m_siteBarrierStats.reset();
+        m_hugePageAllocatorStats.reset();
+        m_stringPoolStats.reset();
+        m_compactionStats.reset();
+        m_streamBufferPoolStats.reset();
+        m_planCacheStats.reset();
+        m_subqueryCacheStats.reset();
         delete m_executorContext;
     }
     VOLT_DEBUG("finished deallocate for partition %d", m_partitionId);
@@ -1919,6 +1992,7 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId) {
             m_currExecutorVec = (*iter).get();
             // update the context
             m_currExecutorVec->setupContext(m_executorContext);
+            ++m_planCacheCounters.hits;
             return;
         }
     }
@@ -1936,7 +2010,11 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId) {
         throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, msg);
     }
 
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
     boost::shared_ptr<ExecutorVector> ev_guard = ExecutorVector::fromJsonPlan(this, plan, fragId);
+    ++m_planCacheCounters.misses;
+    m_planCacheCounters.loadNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
 
     // add the plan to the back
     //
@@ -2217,6 +2295,30 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
     if (m_executorContext->drReplicatedStream()) {
         m_executorContext->drReplicatedStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
     }
+
+    // Fill in the holes left by deleted strings while no transaction is running.
+    ThreadLocalPool::compactRelocatables(STRING_RELOCATIONS_PER_TICK);
+
+    compactTablesIncrementally();
+}
+
+void VoltDBEngine::compactTablesIncrementally() {
+    // Undo actions point at the tuples they would restore, so leave every
+    // block alone until the undo log has been released.
+    if (m_compactionScheduler.get() == NULL || m_undoLog.hasPendingQuantums()) {
+        return;
+    }
+    // Replicated tables are shared by all the sites of the host and are
+    // only compacted under the replicated resource lock, on quantum release.
+    std::vector<PersistentTable*> tables;
+    typedef std::pair<CatalogId, Table*> CatalogIdTable;
+    BOOST_FOREACH (CatalogIdTable entry, m_tables) {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(entry.second);
+        if (table != NULL && ! table->isReplicatedTable()) {
+            tables.push_back(table);
+        }
+    }
+    m_compactionScheduler->compact(tables);
 }
 
 /** Bring the Export and DR system to a steady state with no pending committed data */
@@ -2288,21 +2390,33 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
     Table* resultTable = NULL;
     std::vector<CatalogId> locatorIds;
 
-    for (int ii = 0; ii < numLocators; ii++) {
-        CatalogId locator = static_cast<CatalogId>(locators[ii]);
-        Table* t = getTableById(locator);
-        if (!t) {
-            char message[256];
-            snprintf(message, 256,  "getStats() called with selector %d, and"
-                    " an invalid locator %d that does not correspond to"
-                    " a table", selector, locator);
-            throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
-                                          message);
-        }
-        auto streamTable = dynamic_cast<StreamedTable*>(t);
-        if (streamTable == NULL || streamTable->getWrapper() == NULL) {
-            // skip stats for stream tables with ExportTupleStreams
-            locatorIds.push_back(locator);
+    if (selector == STATISTICS_SELECTOR_TYPE_SITE_BARRIER ||
+            selector == STATISTICS_SELECTOR_TYPE_HUGE_PAGE_ALLOCATOR ||
+            selector == STATISTICS_SELECTOR_TYPE_STRING_POOL ||
+            selector == STATISTICS_SELECTOR_TYPE_COMPACTION ||
+            selector == STATISTICS_SELECTOR_TYPE_STREAM_BUFFER_POOL ||
+            selector == STATISTICS_SELECTOR_TYPE_PLAN_CACHE ||
+            selector == STATISTICS_SELECTOR_TYPE_SUBQUERY_CACHE) {
+        // Site-wide statistics are registered under a single locator.
+        locatorIds.push_back(0);
+    }
+    else {
+        for (int ii = 0; ii < numLocators; ii++) {
+            CatalogId locator = static_cast<CatalogId>(locators[ii]);
+            Table* t = getTableById(locator);
+            if (!t) {
+                char message[256];
+                snprintf(message, 256,  "getStats() called with selector %d, and"
+                        " an invalid locator %d that does not correspond to"
+                        " a table", selector, locator);
+                throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                              message);
+            }
+            auto streamTable = dynamic_cast<StreamedTable*>(t);
+            if (streamTable == NULL || streamTable->getWrapper() == NULL) {
+                // skip stats for stream tables with ExportTupleStreams
+                locatorIds.push_back(locator);
+            }
         }
     }
     size_t lengthPosition = m_resultOutput.reserveBytes(sizeof(int32_t));
@@ -2310,12 +2424,14 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
     try {
         switch (selector) {
         case STATISTICS_SELECTOR_TYPE_TABLE:
-            resultTable = m_statsManager.getStats(
-                    (StatisticsSelectorType) selector,
-                    m_siteId, m_partitionId,
-                    locatorIds, interval, now);
-            break;
         case STATISTICS_SELECTOR_TYPE_INDEX:
+        case STATISTICS_SELECTOR_TYPE_SITE_BARRIER:
+        case STATISTICS_SELECTOR_TYPE_HUGE_PAGE_ALLOCATOR:
+        case STATISTICS_SELECTOR_TYPE_STRING_POOL:
+        case STATISTICS_SELECTOR_TYPE_COMPACTION:
+        case STATISTICS_SELECTOR_TYPE_STREAM_BUFFER_POOL:
+        case STATISTICS_SELECTOR_TYPE_PLAN_CACHE:
+        case STATISTICS_SELECTOR_TYPE_SUBQUERY_CACHE:
             resultTable = m_statsManager.getStats(
                     (StatisticsSelectorType) selector,
                     m_siteId, m_partitionId,
@@ -2726,6 +2842,7 @@ void VoltDBEngine::executeTask(TaskType taskType, ReferenceSerializeInputBE &tas
         // create or delete dr replicated stream as needed
         if (m_drReplicatedStream == NULL && m_isLowestSite) {
             m_drReplicatedStream = new DRTupleStream(16383, m_drStream->getDefaultCapacity(), drProtocolVersion);
+            m_drReplicatedStream->setCompressBuffers(m_drStream->compressBuffers());
         }
         m_drStream->setDrProtocolVersion(drProtocolVersion);
         m_executorContext->setDrStream(m_drStream);
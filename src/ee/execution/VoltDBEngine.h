@@ -52,6 +52,8 @@
 #include "common/UndoLog.h"
 #include "common/valuevector.h"
 
+#include "execution/SharedPlanCache.h"
+
 #include "logging/LogManager.h"
 #include "logging/LogProxy.h"
 #include "logging/StdoutLogProxy.h"
@@ -91,11 +93,19 @@ class AbstractDRTupleStream;
 class AbstractExecutor;
 class AbstractPlanNode;
 class AbstractTempTable;
+class CompactionScheduler;
+class CompactionStats;
 class EnginePlanSet;  // Locally defined in VoltDBEngine.cpp
 class ExecutorContext;
 class ExecutorVector;
+class HugePageAllocatorStats;
 class PersistentTable;
+class PlanCacheStats;
 class RecoveryProtoMsg;
+class SiteBarrierStats;
+class StreamBufferPoolStats;
+class StringPoolStats;
+class SubqueryCacheStats;
 class StreamedTable;
 class Table;
 class TableCatalogDelegate;
@@ -146,7 +156,13 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                         int64_t tempTableMemoryLimit,
                         bool createDrReplicatedStream,
                         int32_t compactionThreshold = 95,
-                        int32_t exportFlushTimeout = 4*1000);
+                        int32_t exportFlushTimeout = 4*1000,
+                        ReplicatedBarrierType barrierType = REPLICATED_BARRIER_TYPE_MUTEX,
+                        HugePageMode hugePageMode = HUGE_PAGE_MODE_NONE,
+                        bool bindToNumaNode = false,
+                        bool deferStringCompaction = false,
+                        int32_t prefaultedStreamBuffers = 0,
+                        bool compressDRBuffers = false);
         virtual ~VoltDBEngine();
 
         // ------------------------------------------------------------------
@@ -391,6 +407,9 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         /** Perform once per second, non-transactional work. */
         void tick(int64_t timeInMillis, int64_t lastCommittedSpHandle);
 
+        /** Spend one tick's compaction budget on the sparsest partitioned tables. */
+        void compactTablesIncrementally();
+
         /** flush active work (like EL buffers) */
         void quiesce(int64_t lastCommittedSpHandle);
 
@@ -763,6 +782,29 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         /** Stats manager for this execution engine **/
         voltdb::StatsAgent m_statsManager;
 
+        /** Time this site has spent in the replicated table barrier */
+        boost::scoped_ptr<SiteBarrierStats> m_siteBarrierStats;
+
+        /** How this site's tuple blocks and index buffers are backed */
+        boost::scoped_ptr<HugePageAllocatorStats> m_hugePageAllocatorStats;
+
+        /** How densely this site's relocatable strings are packed */
+        boost::scoped_ptr<StringPoolStats> m_stringPoolStats;
+
+        /** Compacts the blocks of this site's partitioned tables a little on every tick */
+        boost::scoped_ptr<CompactionScheduler> m_compactionScheduler;
+        boost::scoped_ptr<CompactionStats> m_compactionStats;
+
+        /** How well this site's export and DR stream buffers are recycled */
+        boost::scoped_ptr<StreamBufferPoolStats> m_streamBufferPoolStats;
+
+        /** Hit rate and load time of this site's executor cache (m_plans) */
+        PlanCacheCounters m_planCacheCounters;
+        boost::scoped_ptr<PlanCacheStats> m_planCacheStats;
+
+        /** Hit rate of the result caches of this site's correlated subqueries */
+        boost::scoped_ptr<SubqueryCacheStats> m_subqueryCacheStats;
+
         /*
          * Pool for short lived strings that will not live past the return back to Java.
          */
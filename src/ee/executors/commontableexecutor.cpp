@@ -16,8 +16,11 @@
  */
 
 #include "executors/commontableexecutor.h"
+#include "execution/ExecutorVector.h"
 #include "plannodes/commontablenode.h"
+#include "storage/TempTableLimits.h"
 #include "storage/tableiterator.h"
+#include "storage/temptable.h"
 
 namespace voltdb {
 
@@ -26,10 +29,74 @@ bool CommonTableExecutor::p_init(AbstractPlanNode*,
     // Not much to do here... just create an output table that
     // has the same schema as our input table
     setTempOutputTable(executorVector);
+    m_unionDistinct = static_cast<CommonTablePlanNode*>(m_abstractNode)->isUnionDistinct();
+    m_copyDistinctRows = m_unionDistinct && executorVector.isLargeQuery();
     return true;
 }
 
+bool CommonTableExecutor::insertIntoResult(AbstractTempTable* finalOutputTable, TableTuple& tuple) {
+    if ( ! m_unionDistinct) {
+        finalOutputTable->insertTempTuple(tuple);
+        return true;
+    }
+    if (m_distinctRows.find(tuple) != m_distinctRows.end()) {
+        return false;
+    }
+    if (m_copyDistinctRows) {
+        // Large temp table tuples keep their non-inlined data in their
+        // block, which may be spilled, so the key gets its own deep copy.
+        PoolBackedTupleStorage storage;
+        storage.init(tuple.getSchema(), &m_memoryPool);
+        storage.allocateActiveTuple();
+        TableTuple& copy = storage;
+        copy.copyForPersistentInsert(tuple, &m_memoryPool);
+        m_distinctRows.insert(copy);
+        // Throws once the copies take the query past its memory limit.
+        int64_t allocated = m_memoryPool.getAllocatedMemory();
+        if (allocated > m_chargedBytes) {
+            TempTableLimits* limits = ExecutorContext::getExecutorContext()->getTempTableLimits();
+            int64_t bytes = allocated - m_chargedBytes;
+            m_chargedBytes = allocated;
+            if (limits != NULL) {
+                limits->increaseAllocated(static_cast<int>(bytes));
+            }
+        }
+        finalOutputTable->insertTempTuple(tuple);
+    }
+    else {
+        // The temp table is only appended to, so its tuples stay put
+        // and can be the keys of the set.
+        m_distinctRows.insert(static_cast<TempTable*>(finalOutputTable)->appendTempTuple(tuple));
+    }
+    return true;
+}
+
+void CommonTableExecutor::releaseDistinctRows() {
+    m_distinctRows.clear();
+    m_memoryPool.purge();
+    if (m_chargedBytes > 0) {
+        TempTableLimits* limits = ExecutorContext::getExecutorContext()->getTempTableLimits();
+        if (limits != NULL) {
+            limits->reduceAllocated(static_cast<int>(m_chargedBytes));
+        }
+        m_chargedBytes = 0;
+    }
+}
+
 bool CommonTableExecutor::p_execute(const NValueArray& params) {
+    // The charged copies are released whether or not the query finishes.
+    try {
+        bool result = executeCommonTable();
+        releaseDistinctRows();
+        return result;
+    }
+    catch (...) {
+        releaseDistinctRows();
+        throw;
+    }
+}
+
+bool CommonTableExecutor::executeCommonTable() {
     ExecutorContext *ec = ExecutorContext::getExecutorContext();
     CommonTablePlanNode* node = static_cast<CommonTablePlanNode*>(m_abstractNode);
     AbstractTempTable* inputTable = m_abstractNode->getTempInputTable();
@@ -37,11 +104,16 @@ bool CommonTableExecutor::p_execute(const NValueArray& params) {
 
     // To start, add whatever the base query produced (this executor's
     // plan node has the plan tree for the base query as its child) to
-    // the final result.
+    // the final result.  For UNION, duplicates among these rows are
+    // still recursed on once; what they produce is filtered below.
     TableTuple iterTuple(inputTable->schema());
-    TableIterator iter = inputTable->iterator();
-    while (iter.next(iterTuple)) {
-        finalOutputTable->insertTuple(iterTuple);
+    {
+        // Each scan's iterator goes before its table is emptied: a large
+        // temp table iterator unpins its last block when it goes away.
+        TableIterator iter = inputTable->iterator();
+        while (iter.next(iterTuple)) {
+            insertIntoResult(finalOutputTable, iterTuple);
+        }
     }
 
     int recursiveStmtId = node->getRecursiveStmtId();
@@ -65,21 +137,42 @@ bool CommonTableExecutor::p_execute(const NValueArray& params) {
 
     while (inputTable->activeTupleCount() > 0) {
         // At head of this loop, inputTable should contain the results
-        // of the base query, or the results of the last invocation of
-        // the recursive query.
+        // of the base query, or the new results of the last invocation
+        // of the recursive query.
 
         // Execute the recursive query...
         AbstractTempTable* recursiveOutputTable = ec->executeExecutors(recursiveStmtId).release();
 
-        // Add the recursive output to the final result
-        iter = recursiveOutputTable->iterator();
-        while (iter.next(iterTuple)) {
-            finalOutputTable->insertTuple(iterTuple);
+        if (m_unionDistinct) {
+            // Only the rows never seen before go on to the next
+            // iteration.  Both tables keep their blocks for it.
+            inputTable->deleteAllTempTuplesForReuse();
+            {
+                TableIterator iter = recursiveOutputTable->iterator();
+                while (iter.next(iterTuple)) {
+                    if (insertIntoResult(finalOutputTable, iterTuple)) {
+                        inputTable->insertTempTuple(iterTuple);
+                    }
+                }
+            }
+            inputTable->finishInserts();
+            recursiveOutputTable->deleteAllTempTuplesForReuse();
+        }
+        else {
+            // Add the recursive output to the final result
+            {
+                TableIterator iter = recursiveOutputTable->iterator();
+                while (iter.next(iterTuple)) {
+                    finalOutputTable->insertTempTuple(iterTuple);
+                }
+            }
+
+            // Now prepare for the next iteration.  The recursive
+            // query's output table gets the emptied blocks of the
+            // input table to write its next results into.
+            inputTable->swapContents(recursiveOutputTable);
+            recursiveOutputTable->deleteAllTempTuplesForReuse();
         }
-
-        // Now prepare for the next iteration...
-        inputTable->deleteAllTempTuples();
-        inputTable->swapContents(recursiveOutputTable);
 
         // inputTable now has recursive output
         // recursiveOutputTable is now empty
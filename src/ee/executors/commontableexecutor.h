@@ -46,6 +46,10 @@
 #ifndef COMMONTABLEEXECUTOR_H
 #define COMMONTABLEEXECUTOR_H
 
+#include "boost/unordered_set.hpp"
+
+#include "common/Pool.hpp"
+#include "common/tabletuple.h"
 #include "common/valuevector.h"
 #include "executors/abstractexecutor.h"
 
@@ -58,11 +62,19 @@ class VoltDBEngine;
 /**
  * This class implements the executor for common table expressions.  It's output table
  * is placed the ExecutorContext's common table map.
+ *
+ * Recursive CTEs are evaluated semi-naively: each run of the recursive
+ * statement only sees the rows produced by the previous run.  For UNION
+ * (rather than UNION ALL) a hash set of the rows produced so far filters
+ * every run's output, so only new rows are kept and passed on.
  */
 class CommonTableExecutor : public AbstractExecutor {
 public:
     CommonTableExecutor(VoltDBEngine* engine, AbstractPlanNode *planNode)
         : AbstractExecutor(engine, planNode)
+        , m_chargedBytes(0)
+        , m_unionDistinct(false)
+        , m_copyDistinctRows(false)
     {
     }
 
@@ -70,6 +82,34 @@ public:
                         const ExecutorVector& executorVector);
 
     virtual bool p_execute(const NValueArray& params);
+
+private:
+    typedef boost::unordered_set<TableTuple, TableTupleHasher, TableTupleEqualityChecker> TupleSet;
+
+    /**
+     * Add a row to the result unless this is a UNION (distinct) CTE
+     * and the row has been produced before.  Returns true if the row
+     * was added.
+     */
+    bool insertIntoResult(AbstractTempTable* finalOutputTable, TableTuple& tuple);
+
+    bool executeCommonTable();
+
+    /**
+     * Forget the rows of the result so far, and give the memory of
+     * their copies back to the temp table limits.
+     */
+    void releaseDistinctRows();
+
+    // Rows of the result so far, for UNION (distinct) CTEs.  The
+    // tuples live in the output table, unless it is a large temp table
+    // whose blocks may be swapped out; then they are copied into the
+    // memory pool, which is charged to the temp table limits.
+    TupleSet m_distinctRows;
+    Pool m_memoryPool;
+    int64_t m_chargedBytes;
+    bool m_unionDistinct;
+    bool m_copyDistinctRows;
 };
 
 } // end namespace voltdb
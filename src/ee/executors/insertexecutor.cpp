@@ -54,6 +54,9 @@
 namespace voltdb {
 int64_t InsertExecutor::s_modifiedTuples;
 
+// How many rows of a multi-row insert are sorted and inserted together.
+static const size_t INSERT_BATCH_SIZE = 1000;
+
 bool InsertExecutor::p_init(AbstractPlanNode* abstractNode,
                             const ExecutorVector& executorVector)
 {
@@ -340,6 +343,20 @@ void InsertExecutor::p_execute_tuple_internal(TableTuple &tuple) {
         // so fall through to the "insert" logic
     }
 
+    if (m_batchInserts) {
+        // The template tuple is reused for the next row.  Its uninlined
+        // values were freshly allocated in the temp pool for this row, so
+        // a shallow copy is enough to keep them.
+        char* storage = static_cast<char*>(m_tempPool->allocate(m_templateTuple.tupleLength()));
+        TableTuple batched(storage, m_templateTuple.getSchema());
+        batched.copy(m_templateTuple);
+        m_batchedTuples.push_back(batched);
+        if (m_batchedTuples.size() >= INSERT_BATCH_SIZE) {
+            flushBatchedTuples();
+        }
+        return;
+    }
+
     // try to put the tuple into the target table
     if (m_hasPurgeFragment) {
         executePurgeFragmentIfNeeded(&m_persistentTable);
@@ -355,6 +372,21 @@ void InsertExecutor::p_execute_tuple_internal(TableTuple &tuple) {
     return;
 }
 
+void InsertExecutor::flushBatchedTuples() {
+    if (m_batchedTuples.empty()) {
+        return;
+    }
+    if (m_isStreamed) {
+        static_cast<StreamedTable*>(m_targetTable)->insertTuples(m_batchedTuples);
+    }
+    else {
+        m_persistentTable->insertPersistentTuples(m_batchedTuples);
+    }
+    VOLT_TRACE("Target table:\n%s\n", m_targetTable->debug().c_str());
+    m_modifiedTuples += m_batchedTuples.size();
+    m_batchedTuples.clear();
+}
+
 void InsertExecutor::p_execute_tuple(TableTuple &tuple) {
     // This should only be called from inlined insert executors because we have to change contexts every time
     ConditionalSynchronizedExecuteWithMpMemory possiblySynchronizedUseMpMemory(
@@ -414,10 +446,20 @@ bool InsertExecutor::p_execute(const NValueArray &params) {
                 // An insert is quite simple really. We just loop through our m_inputTable
                 // and insert any tuple that we find into our targetTable. It doesn't get any easier than that!
                 //
+                // Rows of a multi-row insert into a persistent table are
+                // inserted in primary key order, in batches.  Rows bound for
+                // a stream are batched in input order and appended to the
+                // export stream together.  Upserts and tables with a purge
+                // fragment still go row by row.
+                m_batchInserts = ! m_isUpsert && ! m_hasPurgeFragment &&
+                        m_inputTable->activeTupleCount() > 1;
+                m_batchedTuples.clear();
                 TableIterator iterator = m_inputTable->iterator();
                 while (iterator.next(inputTuple)) {
                     p_execute_tuple_internal(inputTuple);
                 }
+                flushBatchedTuples();
+                m_batchInserts = false;
                 if (m_replicatedTableOperation) {
                     s_modifiedTuples = m_modifiedTuples;
                 }
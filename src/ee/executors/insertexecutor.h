@@ -83,7 +83,9 @@ class InsertExecutor : public AbstractExecutor
         m_persistentTable(NULL),
         m_upsertTuple(),
         m_templateTuple(),
-        m_tempPool(NULL)
+        m_tempPool(NULL),
+        m_batchInserts(false),
+        m_batchedTuples()
             {
             }
 
@@ -157,6 +159,12 @@ class InsertExecutor : public AbstractExecutor
      */
     void p_execute_tuple_internal(TableTuple &tuple);
 
+    /**
+     * Insert the rows collected for a multi-row insert into the target
+     * table in one batch and count them.
+     */
+    void flushBatchedTuples();
+
     /** A tuple with the target table's schema that is populated
      * with default values for each field. */
     StandAloneTupleStorage m_templateTupleStorage;
@@ -181,6 +189,10 @@ class InsertExecutor : public AbstractExecutor
     TableTuple m_upsertTuple;
     TableTuple m_templateTuple;
     Pool* m_tempPool;
+    /** Multi-row inserts collect their rows here (copied into the temp
+     * pool) and insert them in batches. */
+    bool m_batchInserts;
+    std::vector<TableTuple> m_batchedTuples;
 };
 
 /**
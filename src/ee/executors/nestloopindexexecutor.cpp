@@ -45,6 +45,8 @@
 
 #include "nestloopindexexecutor.h"
 
+#include "common/Pool.hpp"
+
 #include "execution/ProgressMonitorProxy.h"
 
 #include "executors/aggregateexecutor.h"
@@ -67,6 +69,49 @@ using namespace voltdb;
 const static int8_t UNMATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE);
 const static int8_t MATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE + 1);
 
+/**
+ * A window of outer tuples whose equality search keys are built up front
+ * and looked up in the inner index with a single TableIndex::moveToKeys()
+ * call, so the cache misses of the individual probes overlap. The joined
+ * rows are still produced one outer tuple at a time, in outer order.
+ *
+ * The batch keeps its own copies of the outer tuples, so the outer table
+ * can still be freed (or a large temp table's blocks released) as it is
+ * iterated.
+ */
+struct NestLoopIndexExecutor::ProbeBatch {
+    static const int SIZE = 32;
+
+    ProbeBatch(const TupleSchema* keySchema, const TupleSchema* outerSchema)
+        : m_outerCount(0)
+    {
+        for (int i = 0; i < SIZE; ++i) {
+            m_keyStorage[i].init(keySchema);
+            m_keys.push_back(m_keyStorage[i].tuple());
+            m_outerStorage[i].init(outerSchema);
+        }
+    }
+
+    StandAloneTupleStorage m_keyStorage[SIZE];
+    // the first probeCount of these are the keys probed for the batch
+    std::vector<TableTuple> m_keys;
+    std::vector<IndexCursor> m_cursors;
+    // the first m_outerCount of these hold copies of the batch's outer tuples
+    StandAloneTupleStorage m_outerStorage[SIZE];
+    // non-inlined data of the outer tuple copies, purged for each batch
+    Pool m_outerPool;
+    int m_outerCount;
+    // for each outer tuple, the position of its key and cursor,
+    // or -1 if it failed the pre-join predicate or can't match any key
+    int m_probes[SIZE];
+};
+
+NestLoopIndexExecutor::NestLoopIndexExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
+    : AbstractJoinExecutor(engine, abstract_node)
+    , m_indexNode(NULL)
+    , m_lookupType(INDEX_LOOKUP_TYPE_INVALID)
+{ }
+
 bool NestLoopIndexExecutor::p_init(AbstractPlanNode* abstractNode,
                                    const ExecutorVector& executorVector)
 {
@@ -131,6 +176,67 @@ bool NestLoopIndexExecutor::p_init(AbstractPlanNode* abstractNode,
     p_init_null_tuples(node->getInputTable(), m_indexNode->getTargetTable());
 
     m_indexValues.init(index->getKeySchema());
+    if (m_lookupType == INDEX_LOOKUP_TYPE_EQ && num_of_searchkeys > 0) {
+        m_probeBatch.reset(new ProbeBatch(index->getKeySchema(), node->getInputTable()->schema()));
+    }
+    return true;
+}
+
+/**
+ * Copy the next batch of outer tuples and probe the inner index for all
+ * of them that can match. Returns the number of outer tuples gathered.
+ */
+int NestLoopIndexExecutor::fillProbeBatch(TableIterator& outerIterator, TableTuple& outerTuple,
+                                          const TableIndex* index, AbstractExpression* prejoinExpression)
+{
+    ProbeBatch& batch = *m_probeBatch;
+    batch.m_outerPool.purge();
+    int outerCount = 0;
+    int probeCount = 0;
+    while (outerCount < ProbeBatch::SIZE && outerIterator.next(outerTuple)) {
+        // The iterator may free the tuple's block once it moves on, so
+        // the predicate and the search key are evaluated on the copy.
+        TableTuple& copy = batch.m_outerStorage[outerCount].tuple();
+        copy.copyForPersistentInsert(outerTuple, &batch.m_outerPool);
+        int probe = -1;
+        if ((prejoinExpression == NULL || prejoinExpression->eval(&copy, NULL).isTrue()) &&
+                setEqualitySearchKey(copy, batch.m_keys[probeCount])) {
+            probe = probeCount++;
+        }
+        batch.m_probes[outerCount++] = probe;
+    }
+    if (probeCount > 0) {
+        index->moveToKeys(batch.m_keys.data(), batch.m_cursors.data(), probeCount);
+    }
+    batch.m_outerCount = outerCount;
+    return outerCount;
+}
+
+/**
+ * Build the equality search key for an outer tuple the way p_execute()
+ * does for a single lookup. Returns false when no inner tuple can match,
+ * because a key value is NULL or does not fit its indexed column.
+ */
+bool NestLoopIndexExecutor::setEqualitySearchKey(const TableTuple& outerTuple, TableTuple& searchKey) const
+{
+    const std::vector<AbstractExpression*>& searchKeyExprs = m_indexNode->getSearchKeyExpressions();
+    searchKey.setAllNulls();
+    int num_of_searchkeys = static_cast<int>(searchKeyExprs.size());
+    for (int ctr = 0; ctr < num_of_searchkeys; ctr++) {
+        NValue candidateValue = searchKeyExprs[ctr]->eval(&outerTuple, NULL);
+        if (candidateValue.isNull() && m_indexNode->getCompareNotDistinctFlags()[ctr] == false) {
+            return false;
+        }
+        try {
+            searchKey.setNValue(ctr, candidateValue);
+        }
+        catch (const SQLException &e) {
+            if ((e.getInternalFlags() & (SQLException::TYPE_OVERFLOW | SQLException::TYPE_UNDERFLOW | SQLException::TYPE_VAR_LENGTH_MISMATCH)) == 0) {
+                throw e;
+            }
+            return false;
+        }
+    }
     return true;
 }
 
@@ -217,6 +323,16 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     //
     TableTuple outer_tuple(outer_table->schema());
     TableTuple inner_tuple(inner_table->schema());
+    // Equality lookups probe the index a batch of outer tuples at a time.
+    // This is skipped for a LIMIT, which could stop the join before the
+    // whole batch is needed.
+    ProbeBatch* probeBatch = NULL;
+    if (m_probeBatch && limit_node == NULL) {
+        probeBatch = m_probeBatch.get();
+        probeBatch->m_cursors.assign(ProbeBatch::SIZE, IndexCursor(index->getTupleSchema()));
+        probeBatch->m_outerCount = 0;
+    }
+    int batchPosition = 0;
     TableIterator outer_iterator = outer_table->iteratorDeletingAsWeGo();
     int num_of_outer_cols = outer_table->columnCount();
     assert (outer_tuple.columnCount() == outer_table->columnCount());
@@ -264,7 +380,23 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     }
 
     VOLT_TRACE("<num_of_outer_cols>: %d\n", num_of_outer_cols);
-    while (postfilter.isUnderLimit() && outer_iterator.next(outer_tuple)) {
+    while (postfilter.isUnderLimit()) {
+        int batchProbe = -1;
+        if (probeBatch == NULL) {
+            if (!outer_iterator.next(outer_tuple)) {
+                break;
+            }
+        }
+        else {
+            if (batchPosition == probeBatch->m_outerCount) {
+                if (fillProbeBatch(outer_iterator, outer_tuple, index, prejoin_expression) == 0) {
+                    break;
+                }
+                batchPosition = 0;
+            }
+            outer_tuple = probeBatch->m_outerStorage[batchPosition].tuple();
+            batchProbe = probeBatch->m_probes[batchPosition++];
+        }
         VOLT_TRACE("outer_tuple:%s",
                    outer_tuple.debug(outer_table->name()).c_str());
         pmp.countdownProgress();
@@ -278,8 +410,11 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
         // For outer joins if outer tuple fails pre-join predicate
         // (join expression based on the outer table only)
         // it can't match any of inner tuples
-        if (prejoin_expression == NULL || prejoin_expression->eval(&outer_tuple, NULL).isTrue()) {
-            int activeNumOfSearchKeys = num_of_searchkeys;
+        // A batched outer tuple had the pre-join predicate checked and its
+        // search key built and probed when its batch was filled.
+        if (probeBatch != NULL ? batchProbe >= 0 :
+                (prejoin_expression == NULL || prejoin_expression->eval(&outer_tuple, NULL).isTrue())) {
+            int activeNumOfSearchKeys = (probeBatch == NULL) ? num_of_searchkeys : 0;
             VOLT_TRACE ("<Nested Loop Index exec, WHILE-LOOP...> Number of searchKeys: %d \n", num_of_searchkeys);
             IndexLookupType localLookupType = m_lookupType;
             SortDirectionType localSortDirection = m_sortDirection;
@@ -411,7 +546,12 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                 // index scan executor
                 if (num_of_searchkeys > 0) {
                     if (localLookupType == INDEX_LOOKUP_TYPE_EQ) {
-                        index->moveToKey(&index_values, indexCursor);
+                        if (probeBatch != NULL) {
+                            indexCursor = probeBatch->m_cursors[batchProbe];
+                        }
+                        else {
+                            index->moveToKey(&index_values, indexCursor);
+                        }
                     }
                     else if (localLookupType == INDEX_LOOKUP_TYPE_GT) {
                         index->moveToGreaterThanKey(&index_values, indexCursor);
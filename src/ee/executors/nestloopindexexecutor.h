@@ -52,6 +52,8 @@
 #include "expressions/abstractexpression.h"
 #include "executors/abstractjoinexecutor.h"
 
+#include <boost/scoped_ptr.hpp>
+
 
 namespace voltdb {
 
@@ -59,6 +61,8 @@ class NestLoopIndexPlanNode;
 class IndexScanPlanNode;
 class AggregateExecutorBase;
 class ProgressMonitorProxy;
+class TableIndex;
+class TableIterator;
 class TableTuple;
 
 /**
@@ -72,11 +76,7 @@ class TableTuple;
 class NestLoopIndexExecutor : public AbstractJoinExecutor
 {
 public:
-    NestLoopIndexExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
-        : AbstractJoinExecutor(engine, abstract_node)
-        , m_indexNode(NULL)
-        , m_lookupType(INDEX_LOOKUP_TYPE_INVALID)
-    { }
+    NestLoopIndexExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node);
 
     ~NestLoopIndexExecutor();
 
@@ -86,11 +86,19 @@ protected:
                 const ExecutorVector& executorVector);
     bool p_execute(const NValueArray &params);
 
+    struct ProbeBatch;
+    int fillProbeBatch(TableIterator& outerIterator, TableTuple& outerTuple,
+                       const TableIndex* index, AbstractExpression* prejoinExpression);
+    bool setEqualitySearchKey(const TableTuple& outerTuple, TableTuple& searchKey) const;
+
     IndexScanPlanNode* m_indexNode;
     IndexLookupType m_lookupType;
     std::vector<AbstractExpression*> m_outputExpressions;
     SortDirectionType m_sortDirection;
     StandAloneTupleStorage m_indexValues;
+    // Set up for equality lookups, whose index probes are issued a
+    // batch of outer tuples at a time
+    boost::scoped_ptr<ProbeBatch> m_probeBatch;
 };
 
 }
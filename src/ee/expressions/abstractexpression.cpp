@@ -45,8 +45,14 @@
 
 #include "abstractexpression.h"
 
+#include "common/executorcontext.hpp"
 #include "common/serializeio.h"
+#include "common/ValuePeeker.hpp"
+#include "expressions/commonsubexpression.h"
+#include "expressions/constantvalueexpression.h"
 #include "expressions/expressionutil.h"
+#include "expressions/foldedexpression.h"
+#include "expressions/functionexpression.h"
 
 namespace voltdb {
 
@@ -130,15 +136,18 @@ AbstractExpression::debug(const std::string &spacer) const
 AbstractExpression*
 AbstractExpression::buildExpressionTree(PlannerDomValue obj)
 {
+    int dependencies;
     AbstractExpression * exp =
-      AbstractExpression::buildExpressionTree_recurse(obj);
+      AbstractExpression::buildExpressionTree_recurse(obj, dependencies);
 
-    if (exp)
+    if (exp) {
+        exp = foldSubtree(exp, dependencies);
         exp->initParamShortCircuits();
+    }
     return exp;
 }
 
-AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj) {
+AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj, int &dependencies) {
     // build a tree recursively from the bottom upwards.
     // when the expression node is instantiated, its type,
     // value and child types will have been discovered.
@@ -153,6 +162,25 @@ AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomVa
     peek_type = static_cast<ExpressionType>(obj.valueForKey("TYPE").asInt());
     assert(peek_type != EXPRESSION_TYPE_INVALID);
 
+    // A subexpression repeated in a scan's predicate and inline projection
+    // is built once; its later occurrences refer to the first.
+    CommonSubexpressionScope *cse = CommonSubexpressionScope::enabledScope();
+    std::string cseKey;
+    if (cse != NULL &&
+            (obj.hasNonNullKey("LEFT") || obj.hasNonNullKey("RIGHT") || obj.hasNonNullKey("ARGS"))) {
+        cseKey = obj.toJSONString();
+        if ( ! cse->isRepeated(cseKey)) {
+            cseKey.clear();
+        }
+        else {
+            AbstractExpression *shared = cse->lookup(cseKey, dependencies);
+            if (shared != NULL) {
+                return shared;
+            }
+        }
+    }
+    dependencies = nodeDependency(obj, peek_type);
+
     if (obj.hasNonNullKey("VALUE_TYPE")) {
         int32_t value_type_int = obj.valueForKey("VALUE_TYPE").asInt();
         value_type = static_cast<ValueType>(value_type_int);
@@ -174,25 +202,46 @@ AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomVa
 
     // recurse to children
     try {
+        int leftDependencies = DEPENDS_ON_NOTHING;
+        int rightDependencies = DEPENDS_ON_NOTHING;
         if (obj.hasNonNullKey("LEFT")) {
             PlannerDomValue leftValue = obj.valueForKey("LEFT");
-            left_child = AbstractExpression::buildExpressionTree_recurse(leftValue);
+            left_child = AbstractExpression::buildExpressionTree_recurse(leftValue, leftDependencies);
         }
         if (obj.hasNonNullKey("RIGHT")) {
             PlannerDomValue rightValue = obj.valueForKey("RIGHT");
-            right_child = AbstractExpression::buildExpressionTree_recurse(rightValue);
+            right_child = AbstractExpression::buildExpressionTree_recurse(rightValue, rightDependencies);
         }
+        dependencies |= leftDependencies | rightDependencies;
 
         // NULL argsVector corresponds to a missing ARGS value
         // vs. an empty argsVector which corresponds to an empty array ARGS value.
         // Different expression types could assert either a NULL or non-NULL argsVector initializer.
         std::vector<AbstractExpression*> argsVector;
+        std::vector<int> argDependencies;
         if (obj.hasNonNullKey("ARGS")) {
             PlannerDomValue argsArray = obj.valueForKey("ARGS");
             for (int i = 0; i < argsArray.arrayLen(); i++) {
                 PlannerDomValue argValue = argsArray.valueAtIndex(i);
-                AbstractExpression* argExpr = AbstractExpression::buildExpressionTree_recurse(argValue);
+                int argDependency;
+                AbstractExpression* argExpr = AbstractExpression::buildExpressionTree_recurse(argValue, argDependency);
                 argsVector.push_back(argExpr);
+                argDependencies.push_back(argDependency);
+                dependencies |= argDependency;
+            }
+        }
+
+        // If this node has to be evaluated for every tuple, evaluate the
+        // children that do not once instead.  Otherwise leave that to the
+        // nearest ancestor that does.
+        if (dependencies & (DEPENDS_ON_TUPLE | DEPENDS_ON_UNKNOWN)) {
+            left_child = foldSubtree(left_child, leftDependencies);
+            // CASE WHEN needs its RIGHT child to be the alternative itself.
+            if (peek_type != EXPRESSION_TYPE_OPERATOR_CASE_WHEN) {
+                right_child = foldSubtree(right_child, rightDependencies);
+            }
+            for (size_t i = 0; i < argsVector.size(); i++) {
+                argsVector[i] = foldSubtree(argsVector[i], argDependencies[i]);
             }
         }
 
@@ -205,6 +254,12 @@ AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomVa
 
         finalExpr->setInBytes(inBytes);
 
+        if ( ! cseKey.empty() &&
+                dependencies == DEPENDS_ON_TUPLE &&
+                peek_type != EXPRESSION_TYPE_OPERATOR_ALTERNATIVE &&
+                peek_type != EXPRESSION_TYPE_VALUE_VECTOR) {
+            finalExpr = cse->share(cseKey, finalExpr, dependencies);
+        }
         return finalExpr;
     }
     catch (const SerializableEEException &ex) {
@@ -214,4 +269,93 @@ AbstractExpression* AbstractExpression::buildExpressionTree_recurse(PlannerDomVa
     }
 }
 
+int AbstractExpression::nodeDependency(PlannerDomValue obj, ExpressionType type) {
+    switch (type) {
+    case EXPRESSION_TYPE_VALUE_PARAMETER:
+        return DEPENDS_ON_PARAMETERS;
+    case EXPRESSION_TYPE_VALUE_TUPLE:
+        return DEPENDS_ON_TUPLE;
+    case EXPRESSION_TYPE_OPERATOR_PLUS:
+    case EXPRESSION_TYPE_OPERATOR_MINUS:
+    case EXPRESSION_TYPE_OPERATOR_MULTIPLY:
+    case EXPRESSION_TYPE_OPERATOR_DIVIDE:
+    case EXPRESSION_TYPE_OPERATOR_CONCAT:
+    case EXPRESSION_TYPE_OPERATOR_MOD:
+    case EXPRESSION_TYPE_OPERATOR_CAST:
+    case EXPRESSION_TYPE_OPERATOR_NOT:
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+    case EXPRESSION_TYPE_OPERATOR_UNARY_MINUS:
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_LIKE:
+    case EXPRESSION_TYPE_COMPARE_IN:
+    case EXPRESSION_TYPE_COMPARE_NOTDISTINCT:
+    case EXPRESSION_TYPE_COMPARE_STARTSWITH:
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+    case EXPRESSION_TYPE_VALUE_NULL:
+    case EXPRESSION_TYPE_VALUE_VECTOR:
+    case EXPRESSION_TYPE_OPERATOR_CASE_WHEN:
+    case EXPRESSION_TYPE_OPERATOR_ALTERNATIVE:
+        return DEPENDS_ON_NOTHING;
+    case EXPRESSION_TYPE_FUNCTION: {
+        int functionId = obj.valueForKey("FUNCTION_ID").asInt();
+        if (IS_USER_DEFINED_ID(functionId)) {
+            return DEPENDS_ON_UNKNOWN;
+        }
+        if (functionId == FUNC_CURRENT_TIMESTAMP) {
+            return DEPENDS_ON_PARAMETERS;
+        }
+        if (functionId == FUNC_VOLT_MIGRATING) {
+            return DEPENDS_ON_TUPLE;
+        }
+        return DEPENDS_ON_NOTHING;
+    }
+    default:
+        return DEPENDS_ON_UNKNOWN;
+    }
+}
+
+AbstractExpression* AbstractExpression::foldSubtree(AbstractExpression *expr, int dependencies) {
+    if (expr == NULL || (dependencies & (DEPENDS_ON_TUPLE | DEPENDS_ON_UNKNOWN))) {
+        return expr;
+    }
+    switch (expr->getExpressionType()) {
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+    case EXPRESSION_TYPE_VALUE_NULL:
+    case EXPRESSION_TYPE_VALUE_PARAMETER:
+    case EXPRESSION_TYPE_OPERATOR_ALTERNATIVE:
+        return expr;
+    default:
+        break;
+    }
+
+    // A subtree of constants alone can be replaced by its value now, as
+    // long as the value does not live in the temp string pool.  If it
+    // fails, the error is left for the execution that reaches it.
+    if (dependencies == DEPENDS_ON_NOTHING && ExecutorContext::getExecutorContext() != NULL) {
+        try {
+            NValue value = expr->eval(NULL, NULL);
+            ValueType type = ValuePeeker::peekValueType(value);
+            if ( ! isVariableLengthType(type) && type != VALUE_TYPE_ARRAY) {
+                AbstractExpression *constant = new ConstantValueExpression(value);
+                constant->setValueType(expr->getValueType());
+                constant->setValueSize(expr->getValueSize());
+                constant->setInBytes(expr->getInBytes());
+                delete expr;
+                return constant;
+            }
+        }
+        catch (const SerializableEEException &) {
+            // fall through to folding per execution
+        }
+    }
+    return new FoldedExpression(expr);
+}
+
 }
@@ -144,7 +144,19 @@ class AbstractExpression {
                        AbstractExpression *right);
 
   private:
-    static AbstractExpression* buildExpressionTree_recurse(PlannerDomValue obj);
+    // What the value of a subtree depends on, as a bit set.  A subtree
+    // that depends on nothing or on parameters only is evaluated once per
+    // execution instead of once per tuple.
+    enum Dependency {
+        DEPENDS_ON_NOTHING = 0,
+        DEPENDS_ON_PARAMETERS = 1,  // includes the transaction's timestamp
+        DEPENDS_ON_TUPLE = 2,
+        DEPENDS_ON_UNKNOWN = 4      // subqueries, user functions, aggregates, ...
+    };
+
+    static AbstractExpression* buildExpressionTree_recurse(PlannerDomValue obj, int &dependencies);
+    static int nodeDependency(PlannerDomValue obj, ExpressionType type);
+    static AbstractExpression* foldSubtree(AbstractExpression *expr, int dependencies);
     bool initParamShortCircuits();
 
   protected:
@@ -0,0 +1,188 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/commonsubexpression.h"
+
+#include <pthread.h>
+
+namespace voltdb {
+
+namespace {
+pthread_once_t currentScopeKeyOnce = PTHREAD_ONCE_INIT;
+pthread_key_t currentScopeKey;
+
+void createCurrentScopeKey() {
+    (void) pthread_key_create(&currentScopeKey, NULL);
+}
+
+CommonSubexpressionScope* currentScope() {
+    (void) pthread_once(&currentScopeKeyOnce, createCurrentScopeKey);
+    return static_cast<CommonSubexpressionScope*>(pthread_getspecific(currentScopeKey));
+}
+
+void setCurrentScope(CommonSubexpressionScope* scope) {
+    (void) pthread_once(&currentScopeKeyOnce, createCurrentScopeKey);
+    pthread_setspecific(currentScopeKey, scope);
+}
+
+bool isCompound(PlannerDomValue expr) {
+    return expr.hasNonNullKey("LEFT") || expr.hasNonNullKey("RIGHT") || expr.hasNonNullKey("ARGS");
+}
+}
+
+CommonSubexpression::CommonSubexpression(const CommonSubexpressionStatePtr &state)
+    : AbstractExpression(state->m_expr->getExpressionType(), state->m_expr, NULL),
+      m_state(state)
+{
+    setValueType(state->m_expr->getValueType());
+    setValueSize(state->m_expr->getValueSize());
+    setInBytes(state->m_expr->getInBytes());
+}
+
+std::string CommonSubexpression::debugInfo(const std::string &spacer) const {
+    return spacer + "CommonSubexpression\n";
+}
+
+CommonSubexpressionRowStart::CommonSubexpressionRowStart(AbstractExpression *predicate,
+        const std::vector<CommonSubexpressionStatePtr> &states)
+    : AbstractExpression(predicate->getExpressionType(), predicate, NULL),
+      m_states(states)
+{
+    setValueType(predicate->getValueType());
+    setValueSize(predicate->getValueSize());
+    setInBytes(predicate->getInBytes());
+}
+
+std::string CommonSubexpressionRowStart::debugInfo(const std::string &spacer) const {
+    return spacer + "CommonSubexpressionRowStart\n";
+}
+
+CommonSubexpressionScope::CommonSubexpressionScope(PlannerDomValue planNodeObj, PlanNodeType type)
+    : m_outer(NULL), m_installed(false), m_enabled(false)
+{
+    if ((type != PLAN_NODE_TYPE_SEQSCAN && type != PLAN_NODE_TYPE_INDEXSCAN) ||
+            ! planNodeObj.hasNonNullKey("PREDICATE") ||
+            ! planNodeObj.hasNonNullKey("INLINE_NODES")) {
+        return;
+    }
+    PlannerDomValue inlineNodes = planNodeObj.valueForKey("INLINE_NODES");
+    bool hasProjection = false;
+    for (int i = 0; i < inlineNodes.arrayLen(); i++) {
+        PlannerDomValue inlineNode = inlineNodes.valueAtIndex(i);
+        if (stringToPlanNode(inlineNode.valueForKey("PLAN_NODE_TYPE").asStr()) != PLAN_NODE_TYPE_PROJECTION ||
+                ! inlineNode.hasNonNullKey("OUTPUT_SCHEMA")) {
+            continue;
+        }
+        hasProjection = true;
+        PlannerDomValue columns = inlineNode.valueForKey("OUTPUT_SCHEMA");
+        for (int j = 0; j < columns.arrayLen(); j++) {
+            PlannerDomValue column = columns.valueAtIndex(j);
+            if (column.hasNonNullKey("EXPRESSION")) {
+                countOccurrences(column.valueForKey("EXPRESSION"));
+            }
+        }
+    }
+    if ( ! hasProjection) {
+        return;
+    }
+    countOccurrences(planNodeObj.valueForKey("PREDICATE"));
+
+    for (std::map<std::string, int>::const_iterator it = m_occurrences.begin();
+            it != m_occurrences.end(); ++it) {
+        if (it->second > 1) {
+            m_outer = currentScope();
+            setCurrentScope(this);
+            m_installed = true;
+            return;
+        }
+    }
+}
+
+CommonSubexpressionScope::~CommonSubexpressionScope() {
+    if (m_installed) {
+        setCurrentScope(m_outer);
+    }
+}
+
+void CommonSubexpressionScope::countOccurrences(PlannerDomValue expr) {
+    if ( ! isCompound(expr)) {
+        return;
+    }
+    ++m_occurrences[expr.toJSONString()];
+    if (expr.hasNonNullKey("LEFT")) {
+        countOccurrences(expr.valueForKey("LEFT"));
+    }
+    if (expr.hasNonNullKey("RIGHT")) {
+        countOccurrences(expr.valueForKey("RIGHT"));
+    }
+    if (expr.hasNonNullKey("ARGS")) {
+        PlannerDomValue args = expr.valueForKey("ARGS");
+        for (int i = 0; i < args.arrayLen(); i++) {
+            countOccurrences(args.valueAtIndex(i));
+        }
+    }
+}
+
+CommonSubexpressionScope::Enabled::Enabled(bool enable)
+    : m_scope(enable ? currentScope() : NULL)
+{
+    if (m_scope) {
+        m_scope->m_enabled = true;
+    }
+}
+
+CommonSubexpressionScope::Enabled::~Enabled() {
+    if (m_scope) {
+        m_scope->m_enabled = false;
+    }
+}
+
+CommonSubexpressionScope* CommonSubexpressionScope::enabledScope() {
+    CommonSubexpressionScope* scope = currentScope();
+    return (scope && scope->m_enabled) ? scope : NULL;
+}
+
+AbstractExpression* CommonSubexpressionScope::lookup(const std::string &key, int &dependencies) const {
+    std::map<std::string, CommonSubexpressionStatePtr>::const_iterator it = m_shared.find(key);
+    if (it == m_shared.end()) {
+        return NULL;
+    }
+    dependencies = it->second->m_dependencies;
+    return new CommonSubexpression(it->second);
+}
+
+AbstractExpression* CommonSubexpressionScope::share(const std::string &key,
+        AbstractExpression *expr, int dependencies) {
+    CommonSubexpressionStatePtr state(new CommonSubexpressionState(expr, dependencies));
+    m_shared[key] = state;
+    return new CommonSubexpression(state);
+}
+
+AbstractExpression* CommonSubexpressionScope::startRowsAt(AbstractExpression *predicate) {
+    CommonSubexpressionScope* scope = currentScope();
+    if (predicate == NULL || scope == NULL || scope->m_shared.empty()) {
+        return predicate;
+    }
+    std::vector<CommonSubexpressionStatePtr> states;
+    for (std::map<std::string, CommonSubexpressionStatePtr>::const_iterator it = scope->m_shared.begin();
+            it != scope->m_shared.end(); ++it) {
+        states.push_back(it->second);
+    }
+    return new CommonSubexpressionRowStart(predicate, states);
+}
+
+}
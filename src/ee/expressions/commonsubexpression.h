@@ -0,0 +1,157 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTORECOMMONSUBEXPRESSION_H
+#define HSTORECOMMONSUBEXPRESSION_H
+
+#include "boost/shared_ptr.hpp"
+#include "common/NValue.hpp"
+#include "common/PlannerDomValue.h"
+#include "expressions/abstractexpression.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * One subexpression that occurs more than once in a scan's predicate and
+ * inline projection, built once and shared by all of its occurrences.
+ * The value is valid for the current row only.
+ */
+struct CommonSubexpressionState {
+    CommonSubexpressionState(AbstractExpression *expr, int dependencies)
+        : m_expr(expr), m_dependencies(dependencies), m_value(), m_valid(false) {}
+    ~CommonSubexpressionState() { delete m_expr; }
+
+    AbstractExpression * const m_expr;
+    const int m_dependencies;
+    NValue m_value;
+    bool m_valid;
+};
+
+typedef boost::shared_ptr<CommonSubexpressionState> CommonSubexpressionStatePtr;
+
+/**
+ * An occurrence of a shared subexpression.  The first occurrence to be
+ * evaluated for a row computes the value; the others reuse it.
+ */
+class CommonSubexpression : public AbstractExpression {
+  public:
+    CommonSubexpression(const CommonSubexpressionStatePtr &state);
+    // The shared state owns the subexpression, not this occurrence.
+    ~CommonSubexpression() { m_left = NULL; }
+
+    voltdb::NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        if ( ! m_state->m_valid) {
+            m_state->m_value = m_state->m_expr->eval(tuple1, tuple2);
+            m_state->m_valid = true;
+        }
+        return m_state->m_value;
+    }
+
+    std::string debugInfo(const std::string &spacer) const;
+
+  private:
+    CommonSubexpressionStatePtr m_state;
+};
+
+/**
+ * Root of a scan predicate whose subexpressions are shared.  The scan
+ * executors evaluate the predicate first for every candidate row and the
+ * inline projection only afterwards, so evaluating the predicate is where
+ * a new row starts and every shared value is forgotten.
+ */
+class CommonSubexpressionRowStart : public AbstractExpression {
+  public:
+    CommonSubexpressionRowStart(AbstractExpression *predicate,
+                                const std::vector<CommonSubexpressionStatePtr> &states);
+
+    voltdb::NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        for (size_t i = 0; i < m_states.size(); ++i) {
+            m_states[i]->m_valid = false;
+        }
+        return m_left->eval(tuple1, tuple2);
+    }
+
+    std::string debugInfo(const std::string &spacer) const;
+
+  private:
+    const std::vector<CommonSubexpressionStatePtr> m_states;
+};
+
+/**
+ * Finds the subexpressions repeated across a sequential or index scan's
+ * PREDICATE and the columns of its inline projection, which are all
+ * evaluated against the same scanned tuple.  A scope is created for every
+ * plan node loaded, but only such a scan with something to share becomes
+ * the thread's current scope while the node is being loaded.  Sharing
+ * applies only to the expressions built while an Enabled guard is alive, so that
+ * other expressions of the node (index keys, end expressions, inline
+ * aggregates) which see different tuples or run before the predicate are
+ * never tied to the same value.
+ */
+class CommonSubexpressionScope {
+  public:
+    CommonSubexpressionScope(PlannerDomValue planNodeObj, PlanNodeType type);
+    ~CommonSubexpressionScope();
+
+    class Enabled {
+      public:
+        Enabled(bool enable);
+        ~Enabled();
+      private:
+        CommonSubexpressionScope *m_scope;
+    };
+
+    /** The scope that expressions being built now should share in, or NULL. */
+    static CommonSubexpressionScope* enabledScope();
+
+    /** True if the (JSON) subexpression occurs more than once in the scope. */
+    bool isRepeated(const std::string &key) const {
+        std::map<std::string, int>::const_iterator it = m_occurrences.find(key);
+        return it != m_occurrences.end() && it->second > 1;
+    }
+
+    /**
+     * A new occurrence of an already shared subexpression, or NULL if
+     * the subexpression has not been built yet.
+     */
+    AbstractExpression* lookup(const std::string &key, int &dependencies) const;
+
+    /** Take ownership of a built subexpression and return its first occurrence. */
+    AbstractExpression* share(const std::string &key, AbstractExpression *expr, int dependencies);
+
+    /**
+     * Wrap a scan predicate so that it starts a new row for the
+     * subexpressions shared in the current scope, if there are any.
+     */
+    static AbstractExpression* startRowsAt(AbstractExpression *predicate);
+
+  private:
+    void countOccurrences(PlannerDomValue expr);
+
+    CommonSubexpressionScope *m_outer;
+    bool m_installed;
+    bool m_enabled;
+    std::map<std::string, int> m_occurrences;
+    std::map<std::string, CommonSubexpressionStatePtr> m_shared;
+};
+
+}
+#endif
@@ -0,0 +1,55 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/foldedexpression.h"
+#include "common/executorcontext.hpp"
+
+namespace voltdb {
+
+FoldedExpression::FoldedExpression(AbstractExpression *child)
+    : AbstractExpression(child->getExpressionType(), child, NULL),
+      m_value(),
+      m_context(NULL),
+      m_epoch(-1)
+{
+    setValueType(child->getValueType());
+    setValueSize(child->getValueSize());
+    setInBytes(child->getInBytes());
+}
+
+voltdb::NValue FoldedExpression::eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+{
+    ExecutorContext* exeContext = ExecutorContext::getExecutorContext();
+    if (exeContext == NULL) {
+        return m_left->eval(tuple1, tuple2);
+    }
+    // The context is part of the key because one thread can run on
+    // another site's context during replicated table writes.
+    int64_t epoch = exeContext->executionEpoch();
+    if (epoch != m_epoch || exeContext != m_context) {
+        m_value = m_left->eval(tuple1, tuple2);
+        m_context = exeContext;
+        m_epoch = epoch;
+    }
+    return m_value;
+}
+
+std::string FoldedExpression::debugInfo(const std::string &spacer) const {
+    return spacer + "FoldedExpression\n";
+}
+
+}
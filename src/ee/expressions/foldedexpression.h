@@ -0,0 +1,56 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HSTOREFOLDEDEXPRESSION_H
+#define HSTOREFOLDEDEXPRESSION_H
+
+#include "common/NValue.hpp"
+#include "expressions/abstractexpression.h"
+
+#include <string>
+
+namespace voltdb {
+
+class ExecutorContext;
+
+/**
+ * Wraps a subtree that reads no tuple columns, only constants and
+ * parameters, so that it is evaluated once per execution of its fragment
+ * rather than once per tuple.  The value is cached against the executor
+ * context's execution epoch, which moves every time the parameters can
+ * have changed.  Evaluation stays lazy, so a subtree that is never reached
+ * (a CASE branch, the far side of an AND) still cannot raise an error.
+ *
+ * buildExpressionTree inserts these when it loads a plan; they are not
+ * serialized by the planner.
+ */
+class FoldedExpression : public AbstractExpression {
+  public:
+    FoldedExpression(AbstractExpression *child);
+
+    voltdb::NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
+
+    std::string debugInfo(const std::string &spacer) const;
+
+  private:
+    mutable NValue m_value;
+    mutable const ExecutorContext *m_context;
+    mutable int64_t m_epoch;
+};
+
+}
+#endif
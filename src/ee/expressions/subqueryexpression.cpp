@@ -21,6 +21,8 @@
 
 #include "common/debuglog.h"
 #include "common/executorcontext.hpp"
+#include "executors/abstractexecutor.h"
+#include "storage/temptable.h"
 
 
 namespace voltdb {
@@ -102,14 +104,40 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
         }
     }
 
-    // Out of luck. Need to run the executors. Clean up the output tables with cached results
+    // Clean up the output tables with cached results
     exeContext->cleanupExecutorsForSubquery(m_subqueryId);
+
+    // The parameters changed, but maybe to values seen before.
+    // Only a subquery with parameters can produce different results.
+    bool cacheable = ! m_paramIdxs.empty() || ! m_otherParamIdxs.empty();
+    SubqueryResultCache* cache = (context == NULL) ? NULL : context->getResultCache();
+    std::vector<NValue> allParams;
+    if (cacheable) {
+        allParams.reserve(m_paramIdxs.size() + m_otherParamIdxs.size());
+        for (size_t i = 0; i < m_paramIdxs.size(); ++i) {
+            allParams.push_back(parameterContainer[m_paramIdxs[i]]);
+        }
+        for (size_t i = 0; i < m_otherParamIdxs.size(); ++i) {
+            allParams.push_back(parameterContainer[m_otherParamIdxs[i]]);
+        }
+    }
+    if (cache != NULL) {
+        AbstractTempTable* outputTable =
+            exeContext->getExecutors(m_subqueryId).back()->getPlanNode()->getTempOutputTable();
+        if (cache->restore(allParams, outputTable)) {
+            NValue retval = ValueFactory::getIntegerValue(m_subqueryId);
+            context->setResult(retval);
+            return retval;
+        }
+    }
+
+    // Out of luck. Need to run the executors.
     UniqueTempTableResult result = exeContext->executeExecutors(m_subqueryId);
 
     // We don't want this temp table to be cleaned up; we want it to
     // persist for use by the consumer, and to cache the result so it
     // can be reused.
-    result.release();
+    AbstractTempTable* outputTable = result.release();
 
     if (context == NULL) {
         // Preserve the value for the next run. Only 'other' parameters need to be copied
@@ -120,6 +148,16 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
             lastParams.push_back(prevParam.copyNValue());
         }
         context = exeContext->setSubqueryContext(m_subqueryId, lastParams);
+        // A large temp table result is not worth keeping in memory.
+        if (cacheable && dynamic_cast<TempTable*>(outputTable) != NULL) {
+            cache = new SubqueryResultCache(outputTable,
+                                            exeContext->getTempTableLimits(),
+                                            exeContext->accessSubqueryCacheCounters());
+            context->setResultCache(cache);
+        }
+    }
+    if (cache != NULL) {
+        cache->remember(allParams, outputTable);
     }
 
     // Update the cached result for the current params. All params are already updated
@@ -135,6 +135,27 @@ class CompactingHashUniqueIndex : public TableIndex
         return true;
     }
 
+    void moveToKeys(const TableTuple *searchKeys, IndexCursor *cursors, int count) const
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            keys.push_back(KeyType(&searchKeys[i]));
+        }
+        std::vector<MapIterator> results(count);
+        m_entries.find(keys.data(), results.data(), count);
+        for (int i = 0; i < count; ++i) {
+            MapIterator &mapIter = castToIter(cursors[i]);
+            mapIter = results[i];
+            if (mapIter.isEnd()) {
+                cursors[i].m_match.move(NULL);
+            }
+            else {
+                cursors[i].m_match.move(const_cast<void*>(mapIter.value()));
+            }
+        }
+    }
+
     bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const
     {
         MapIterator &mapIter = castToIter(cursor);
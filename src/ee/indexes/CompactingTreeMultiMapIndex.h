@@ -141,6 +141,32 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return true;
     }
 
+    void moveToKeys(const TableTuple *searchKeys, IndexCursor *cursors, int count) const
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            cursors[i].m_forward = true;
+            keys.push_back(KeyType(&searchKeys[i]));
+        }
+        std::vector<MapIterator> lowers(count);
+        std::vector<MapIterator> uppers(count);
+        m_entries.lowerBound(keys.data(), lowers.data(), count);
+        m_entries.upperBound(keys.data(), uppers.data(), count);
+        for (int i = 0; i < count; ++i) {
+            MapIterator &mapIter = castToIter(cursors[i]);
+            MapIterator &mapEndIter = castToEndIter(cursors[i]);
+            mapIter = lowers[i];
+            mapEndIter = uppers[i];
+            if (mapIter.equals(mapEndIter)) {
+                cursors[i].m_match.move(NULL);
+            }
+            else {
+                cursors[i].m_match.move(const_cast<void*>(mapIter.value()));
+            }
+        }
+    }
+
     bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const
     {
         cursor.m_forward = true;
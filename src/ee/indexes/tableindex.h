@@ -278,6 +278,19 @@ public:
      */
     virtual bool moveToKey(const TableTuple *searchKey, IndexCursor& cursor) const = 0;
 
+    /**
+     * Position cursors[i] exactly as moveToKey(&searchKeys[i], cursors[i])
+     * would, for each of count search keys. Index types that can overlap
+     * the memory accesses of independent lookups override this; the
+     * default simply looks the keys up one at a time.
+     */
+    virtual void moveToKeys(const TableTuple *searchKeys, IndexCursor *cursors, int count) const
+    {
+        for (int i = 0; i < count; ++i) {
+            moveToKey(&searchKeys[i], cursors[i]);
+        }
+    }
+
     /**
       * A slightly different to the previous function, this function requires
       * full tuple instead of just key as the search parameter.
@@ -46,6 +46,7 @@
 
 #include "common/TupleSchema.h"
 #include "executors/abstractexecutor.h"
+#include "expressions/commonsubexpression.h"
 #include "plannodeutil.h"
 #include "storage/persistenttable.h"
 #include "storage/TableCatalogDelegate.hpp"
@@ -258,15 +259,20 @@ AbstractPlanNode* AbstractPlanNode::fromJSONObject(PlannerDomValue obj)
 {
 
     string typeString = obj.valueForKey("PLAN_NODE_TYPE").asStr();
-    std::unique_ptr<AbstractPlanNode> node(
-        plannodeutil::getEmptyPlanNode(stringToPlanNode(typeString)));
+    PlanNodeType type = stringToPlanNode(typeString);
+    std::unique_ptr<AbstractPlanNode> node(plannodeutil::getEmptyPlanNode(type));
 
     node->m_planNodeId = obj.valueForKey("ID").asInt();
 
+    // Lets a scan's predicate and inline projection share subexpressions.
+    CommonSubexpressionScope cse(obj, type);
+
     if (obj.hasKey("INLINE_NODES")) {
         PlannerDomValue inlineNodesValue = obj.valueForKey("INLINE_NODES");
         for (int i = 0; i < inlineNodesValue.arrayLen(); i++) {
             PlannerDomValue inlineNodeObj = inlineNodesValue.valueAtIndex(i);
+            CommonSubexpressionScope::Enabled sharing(
+                stringToPlanNode(inlineNodeObj.valueForKey("PLAN_NODE_TYPE").asStr()) == PLAN_NODE_TYPE_PROJECTION);
             AbstractPlanNode *newNode = AbstractPlanNode::fromJSONObject(inlineNodeObj);
 
             // todo: if this throws, new Node can be leaked.
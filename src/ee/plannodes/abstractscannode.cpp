@@ -46,6 +46,7 @@
 #include "abstractscannode.h"
 
 #include "execution/VoltDBEngine.h"
+#include "expressions/commonsubexpression.h"
 #include "storage/TableCatalogDelegate.hpp"
 
 namespace voltdb {
@@ -93,7 +94,9 @@ void AbstractScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
 
     // Set the predicate (if any) only if it's not a trivial FALSE expression
     if (!m_isEmptyScan) {
-        m_predicate.reset(loadExpressionFromJSONObject("PREDICATE", obj));
+        CommonSubexpressionScope::Enabled sharing(true);
+        m_predicate.reset(CommonSubexpressionScope::startRowsAt(
+                loadExpressionFromJSONObject("PREDICATE", obj)));
     }
 
     m_tcd = NULL;
@@ -58,12 +58,14 @@ void CommonTablePlanNode::loadFromJSONObject(PlannerDomValue obj) {
     }
 
     m_commonTableName = obj.valueForKey("COMMON_TABLE_NAME").asStr();
+    m_unionDistinct = obj.hasKey("UNION_DISTINCT") && obj.valueForKey("UNION_DISTINCT").asBool();
 }
 
 std::string CommonTablePlanNode::debugInfo(const std::string& spacer) const {
     std::ostringstream oss;
     oss << spacer << "CommonTable[" << m_commonTableName
-        << "], with recursive stmt id[" << m_recursiveStmtId << "]\n";
+        << "], with recursive stmt id[" << m_recursiveStmtId << "]"
+        << (m_unionDistinct ? ", union distinct" : "") << "\n";
     return oss.str();
 }
 
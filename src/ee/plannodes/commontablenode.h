@@ -90,6 +90,10 @@ namespace voltdb {
  * output of the base query, and is then executed repeatedly, with
  * EMP_PATH containing the result of the previous iteration, until no
  * more rows are produced.
+ *
+ * If the base and recursive queries are combined with UNION rather
+ * than UNION ALL, each iteration only passes on the rows that have
+ * not been produced before, so recursion over cyclic data terminates.
  */
 class CommonTablePlanNode : public AbstractPlanNode {
 public:
@@ -116,9 +120,18 @@ public:
         return m_commonTableName;
     }
 
+    /**
+     * True if duplicate rows are removed from the result (UNION
+     * rather than UNION ALL).
+     */
+    bool isUnionDistinct() const {
+        return m_unionDistinct;
+    }
+
 private:
     int m_recursiveStmtId;
     std::string m_commonTableName;
+    bool m_unionDistinct;
 };
 
 } // end namespace voltdb
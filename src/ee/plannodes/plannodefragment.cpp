@@ -49,6 +49,7 @@
 #include <boost/foreach.hpp>
 
 #include "common/FatalException.hpp"
+#include "execution/SharedPlanCache.h"
 #include "plannodefragment.h"
 #include "abstractplannode.h"
 
@@ -106,9 +107,10 @@ PlanNodeFragment::createFromCatalog(const string value)
     //cout << "DEBUG PlanNodeFragment::createFromCatalog: value.size() == " << value.size() << endl;
     //cout << "DEBUG PlanNodeFragment::createFromCatalog: value == " << value << endl;
 
-    PlannerDomRoot domRoot(value.c_str());
+    // The parsed plan is shared with the other sites, which only read it.
+    boost::shared_ptr<PlannerDomRoot> domRoot = SharedPlanCache::instance().get(value);
     try {
-        PlanNodeFragment *retval = PlanNodeFragment::fromJSONObject(domRoot.rootObject());
+        PlanNodeFragment *retval = PlanNodeFragment::fromJSONObject(domRoot->rootObject());
         return retval;
     }
     catch (UnexpectedEEException& ue) {
@@ -17,7 +17,14 @@
 #include "StatsAgent.h"
 
 #include "StatsSource.h"
+#include "common/HugePageAllocatorStats.h"
+#include "common/SiteBarrierStats.h"
+#include "common/StreamBufferPoolStats.h"
+#include "common/StringPoolStats.h"
+#include "common/SubqueryCacheStats.h"
+#include "execution/PlanCacheStats.h"
 #include "indexes/IndexStats.h"
+#include "storage/CompactionStats.h"
 #include "storage/TableStats.h"
 #include "storage/temptable.h"
 
@@ -38,6 +45,20 @@ namespace
             return TableStats::generateEmptyTableStatsTable();
         case STATISTICS_SELECTOR_TYPE_INDEX:
             return IndexStats::generateEmptyIndexStatsTable();
+        case STATISTICS_SELECTOR_TYPE_SITE_BARRIER:
+            return SiteBarrierStats::generateEmptySiteBarrierStatsTable();
+        case STATISTICS_SELECTOR_TYPE_HUGE_PAGE_ALLOCATOR:
+            return HugePageAllocatorStats::generateEmptyHugePageAllocatorStatsTable();
+        case STATISTICS_SELECTOR_TYPE_STRING_POOL:
+            return StringPoolStats::generateEmptyStringPoolStatsTable();
+        case STATISTICS_SELECTOR_TYPE_COMPACTION:
+            return CompactionStats::generateEmptyCompactionStatsTable();
+        case STATISTICS_SELECTOR_TYPE_STREAM_BUFFER_POOL:
+            return StreamBufferPoolStats::generateEmptyStreamBufferPoolStatsTable();
+        case STATISTICS_SELECTOR_TYPE_PLAN_CACHE:
+            return PlanCacheStats::generateEmptyPlanCacheStatsTable();
+        case STATISTICS_SELECTOR_TYPE_SUBQUERY_CACHE:
+            return SubqueryCacheStats::generateEmptySubqueryCacheStatsTable();
         default:
             throwFatalException("Attempted to get unsupported stats type");
         }
@@ -16,6 +16,8 @@
  */
 
 #include "AbstractDRTupleStream.h"
+#include "DRTupleStream.h"
+
 #include "stdarg.h"
 #include <cassert>
 
@@ -33,7 +35,10 @@ AbstractDRTupleStream::AbstractDRTupleStream(int partitionId, size_t defaultBuff
           m_secondaryCapacity(SECONDARY_BUFFER_SIZE),
           m_rowTarget(-1),
           m_opened(false),
-          m_txnRowCount(0)
+          m_txnRowCount(0),
+          m_compressor(),
+          m_bytesBeforeCompression(0),
+          m_bytesAfterCompression(0)
 {}
 
 // for test purpose
@@ -52,15 +57,60 @@ void AbstractDRTupleStream::setSecondaryCapacity(size_t capacity)
 void AbstractDRTupleStream::pushStreamBuffer(DrStreamBlock *block, bool sync)
 {
     if (sync) return;
+    if (m_compressor) {
+        // The caller deletes the block once this returns, so queue a copy
+        DrStreamBlock *queued = new DrStreamBlock(block);
+        queued->recordLastCommittedSpHandle(block->lastCommittedSpHandle());
+        // Only consumers of a recent enough protocol can take compressed logs
+        m_compressor->submit(queued, block->drEventType() == NOT_A_EVENT &&
+                             m_drProtocolVersion >= DRTupleStream::COMPRESSED_LOG_PROTOCOL_VERSION);
+        handOffCompressedBlocks(false);
+        return;
+    }
+    pushToTopend(block);
+}
+
+void AbstractDRTupleStream::pushToTopend(DrStreamBlock *block)
+{
     int64_t rowTarget = ExecutorContext::getPhysicalTopend()->pushDRBuffer(m_partitionId, block);
     if (rowTarget >= 0) {
         m_rowTarget = rowTarget;
     }
 }
 
+void AbstractDRTupleStream::setCompressBuffers(bool compressBuffers)
+{
+    if (compressBuffers) {
+        if (!m_compressor) {
+            m_compressor.reset(new DRBlockCompressor());
+        }
+    }
+    else if (m_compressor) {
+        handOffCompressedBlocks(true);
+        m_compressor.reset();
+    }
+}
+
+void AbstractDRTupleStream::handOffCompressedBlocks(bool wait)
+{
+    if (!m_compressor) {
+        return;
+    }
+    int64_t bytesBefore;
+    int64_t bytesAfter;
+    DrStreamBlock *block;
+    while ((block = m_compressor->takeNext(wait, bytesBefore, bytesAfter)) != NULL) {
+        m_bytesBeforeCompression += bytesBefore;
+        m_bytesAfterCompression += bytesAfter;
+        pushToTopend(block);
+        delete block;
+    }
+}
+
 bool AbstractDRTupleStream::periodicFlush(int64_t timeInMillis,
                                           int64_t lastCommittedSpHandle)
 {
+    bool flushed = false;
     // negative timeInMillis instructs a mandatory flush
     if (timeInMillis < 0 || (m_flushInterval > 0 && timeInMillis - m_lastFlush > m_flushInterval)) {
         int64_t currentSpHandle = std::max(m_openSpHandle, lastCommittedSpHandle);
@@ -75,23 +125,23 @@ bool AbstractDRTupleStream::periodicFlush(int64_t timeInMillis,
             return false;
         }
 
-        // more data for an ongoing transaction with no new committed data
         if ((currentSpHandle == m_openSpHandle) &&
                 (lastCommittedSpHandle == m_committedSpHandle)) {
+            // more data for an ongoing transaction with no new committed data
             extendBufferChain(0);
-            return true;
         }
-
-        // the open transaction should be committed
-        if (m_openSpHandle <= lastCommittedSpHandle) {
+        else if (m_openSpHandle <= lastCommittedSpHandle) {
+            // the open transaction should be committed
             extendBufferChain(0);
-            return true;
         }
-
-        pushPendingBlocks();
-        return true;
+        else {
+            pushPendingBlocks();
+        }
+        flushed = true;
     }
-    return false;
+    // Blocks compressed since the last push go out now, and all of them on a mandatory flush
+    handOffCompressedBlocks(timeInMillis < 0);
+    return flushed;
 }
 
 void AbstractDRTupleStream::setLastCommittedSequenceNumber(int64_t sequenceNumber)
@@ -127,6 +177,8 @@ void AbstractDRTupleStream::fatalDRErrorWithPoisonPill(int64_t spHandle, int64_t
     vsnprintf(reallysuperbig_failure_message, 8192, format, arg);
     va_end(arg);
     std::string failureMessageForVoltLogger = reallysuperbig_failure_message;
+    // The poison pill must follow every buffer already pushed
+    handOffCompressedBlocks(true);
     ExecutorContext::getPhysicalTopend()->pushPoisonPill(m_partitionId, failureMessageForVoltLogger, m_currBlock);
     m_currBlock = NULL;
     extendBufferChain(0);
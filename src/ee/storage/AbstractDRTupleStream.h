@@ -22,9 +22,12 @@
 #include "common/tabletuple.h"
 #include "common/StreamBlock.h"
 #include "common/FatalException.hpp"
+#include "storage/DRBlockCompressor.h"
 #include "storage/TupleStreamBase.h"
 #include <deque>
 
+#include <boost/scoped_ptr.hpp>
+
 namespace voltdb {
 
 // Extra space to write a StoredProcedureInvocation wrapper in Java without copying
@@ -148,6 +151,22 @@ public:
         return m_drProtocolVersion;
     }
 
+    /**
+     * Compress the transactions of each buffer on a helper thread before it
+     * is handed to the top end.  Compressed buffers are pushed, in order,
+     * from later pushes and flushes; a mandatory flush waits for all of them.
+     * Event buffers and small buffers are always sent as is, and so is
+     * everything while the negotiated protocol predates compressed logs.
+     */
+    void setCompressBuffers(bool compressBuffers);
+
+    bool compressBuffers() const {
+        return m_compressor != NULL;
+    }
+
+    int64_t bytesBeforeCompression() const { return m_bytesBeforeCompression; }
+    int64_t bytesAfterCompression() const { return m_bytesAfterCompression; }
+
     bool m_enabled;
     bool m_guarded; // strongest guard, reject all actions for DRTupleStream
 
@@ -168,6 +187,16 @@ protected:
     size_t m_txnRowCount;
 
 private:
+    void pushToTopend(DrStreamBlock *block);
+
+    /** Push the blocks the compressor is done with, or wait for and push all of them. */
+    void handOffCompressedBlocks(bool wait);
+
+    boost::scoped_ptr<DRBlockCompressor> m_compressor;
+    // Payload bytes of the buffers offered for compression, and what they were sent as
+    int64_t m_bytesBeforeCompression;
+    int64_t m_bytesAfterCompression;
+
     // return true if stream state was switched from close to open
     virtual bool transactionChecks(int64_t spHandle, int64_t uniqueId) = 0;
 };
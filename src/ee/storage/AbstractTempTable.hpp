@@ -66,6 +66,11 @@ public:
         is complete) */
     virtual void deleteAllTempTuples() = 0;
 
+    /** Delete all tuples in this table because it is about to be
+        refilled; implementations may keep their memory for the new
+        tuples */
+    virtual void deleteAllTempTuplesForReuse() { deleteAllTempTuples(); }
+
     /** The temp table limits object for this table */
     virtual const TempTableLimits* getTempTableLimits() const = 0;
 
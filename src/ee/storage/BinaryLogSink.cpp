@@ -27,6 +27,7 @@
 #include "catalog/database.h"
 
 #include "common/debuglog.h"
+#include "common/FastBlockCompressor.h"
 #include "common/ExecuteWithMpMemory.h"
 #include "common/Pool.hpp"
 #include "common/tabletuple.h"
@@ -35,11 +36,13 @@
 #include "common/UniqueId.hpp"
 #include "indexes/tableindex.h"
 
+#include <boost/scoped_array.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
 #include <crc/crc32c.h>
 
+#include <memory>
 #include <string>
 
 #define throwDRTableNotFoundException(tableHash, ...) \
@@ -58,6 +61,7 @@ const static int DR_LOG_ACTION_COLUMN_INDEX = 1;
 const static int DR_CONFLICT_COLUMN_INDEX = 2;
 const static int DR_CONFLICTS_ON_PK_COLUMN_INDEX = 3;
 const static int DR_ACTION_DECISION_COLUMN_INDEX = 4;
+
 const static int DR_REMOTE_CLUSTER_ID_COLUMN_INDEX = 5;
 const static int DR_REMOTE_TIMESTAMP_COLUMN_INDEX = 6;
 const static int DR_DIVERGENCE_COLUMN_INDEX = 7;
@@ -531,10 +535,7 @@ public:
      *
      * @param log array containing the binary log. Must not have a log of length 0.
      */
-    BinaryLog(const char *log) :
-            m_taskInfo(log + sizeof(int32_t), readRawInt(log)) {
-        initialize(readRawInt(log));
-    }
+    BinaryLog(const char *log) : BinaryLog(log, readRawInt(log)) {}
 
     /**
      * Skip any remaining logs in a transaction and call BinaryLog::validateEndTxn
@@ -608,6 +609,49 @@ public:
         return type;
     }
 
+    /**
+     * Decode the next record of the current transaction without applying it
+     *
+     * @return false once DR_RECORD_END_TXN has been consumed
+     */
+    bool readRecord(DRRecordReference &record) {
+        record.m_type = readRecordType();
+        record.m_newRowData = NULL;
+        record.m_newRowLength = 0;
+        switch (record.m_type) {
+        case DR_RECORD_END_TXN:
+            return false;
+        case DR_RECORD_INSERT:
+        case DR_RECORD_DELETE:
+            record.m_tableHandle = m_taskInfo.readLong();
+            record.m_rowLength = m_taskInfo.readInt();
+            record.m_rowData = reinterpret_cast<const char *>(m_taskInfo.getRawPointer(record.m_rowLength));
+            break;
+        case DR_RECORD_UPDATE:
+            record.m_tableHandle = m_taskInfo.readLong();
+            record.m_rowLength = m_taskInfo.readInt();
+            record.m_rowData = reinterpret_cast<const char *>(m_taskInfo.getRawPointer(record.m_rowLength));
+            record.m_newRowLength = m_taskInfo.readInt();
+            record.m_newRowData = reinterpret_cast<const char *>(m_taskInfo.getRawPointer(record.m_newRowLength));
+            break;
+        case DR_RECORD_TRUNCATE_TABLE:
+            record.m_tableHandle = m_taskInfo.readLong();
+            record.m_tableName = m_taskInfo.readTextString();
+            record.m_rowData = NULL;
+            record.m_rowLength = 0;
+            break;
+        case DR_RECORD_DELETE_BY_INDEX:
+            throwSerializableEEException("Delete by index is not supported for DR");
+        case DR_RECORD_UPDATE_BY_INDEX:
+            throwSerializableEEException("Update by index is not supported for DR");
+        case DR_RECORD_BEGIN_TXN:
+            throwFatalException("Unexpected BEGIN_TXN before END_TXN");
+        default:
+            throwFatalException("Unrecognized DR record type %d", record.m_type);
+        }
+        return true;
+    }
+
     bool isReplicatedTableLog() {
         return m_hashFlag == TXN_PAR_HASH_REPLICATED;
     }
@@ -617,8 +661,46 @@ public:
 
 private:
     BinaryLog(const char *log, int32_t logLength) :
-            m_taskInfo(log + sizeof(int32_t), logLength) {
-        initialize(logLength);
+            m_decompressedLog(decompress(log + sizeof(int32_t), logLength)),
+            m_taskInfo(m_decompressedLog ? m_decompressedLog.get() : log + sizeof(int32_t),
+                       logicalLength(log + sizeof(int32_t), logLength)),
+            m_nextLog(log + sizeof(int32_t) + logLength) {
+        initialize(logicalLength(log + sizeof(int32_t), logLength));
+    }
+
+    static bool isCompressed(const char *logData, int32_t logLength) {
+        return logLength >= static_cast<int32_t>(DR_COMPRESSED_LOG_HEADER_SIZE) &&
+                static_cast<uint8_t>(logData[0]) == DR_COMPRESSED_LOG_MARKER;
+    }
+
+    /**
+     * @return the length of the log's transactions once decompressed
+     */
+    static int32_t logicalLength(const char *logData, int32_t logLength) {
+        if (!isCompressed(logData, logLength)) {
+            return logLength;
+        }
+        ReferenceSerializeInputLE header(logData + 1, sizeof(int32_t));
+        return header.readInt();
+    }
+
+    /**
+     * @return the decompressed transactions of a compressed log, otherwise NULL
+     */
+    static char *decompress(const char *logData, int32_t logLength) {
+        if (!isCompressed(logData, logLength)) {
+            return NULL;
+        }
+        int32_t length = logicalLength(logData, logLength);
+        if (length <= 0) {
+            throwSerializableEEException("Invalid uncompressed length %d in compressed binary log", length);
+        }
+        std::unique_ptr<char[]> decompressed(new char[length]);
+        if (!FastBlockCompressor::decompress(logData + DR_COMPRESSED_LOG_HEADER_SIZE,
+                logLength - DR_COMPRESSED_LOG_HEADER_SIZE, decompressed.get(), length)) {
+            throwSerializableEEException("Corrupt compressed binary log of length %d", logLength);
+        }
+        return decompressed.release();
     }
 
     void initialize(int32_t logLength) {
@@ -633,7 +715,11 @@ private:
         return ntohl(*reinterpret_cast<const int32_t*>(log));
     }
 
+    // Owns the transactions of a compressed log. Declared before m_taskInfo, which reads them.
+    boost::scoped_array<char> m_decompressedLog;
     ReferenceSerializeInputLE m_taskInfo;
+    // Start of the next log in the buffer the log came from
+    const char *m_nextLog;
     const char *m_txnStart;
     int64_t m_uniqueId;
     int64_t m_sequenceNumber;
@@ -643,7 +729,7 @@ private:
     const char *m_logEnd;
 };
 
-BinaryLogSink::BinaryLogSink() {}
+BinaryLogSink::BinaryLogSink() : m_batchedApply(true) {}
 
 // Shared success boolean used when applying binary logs for replicated table
 bool s_replicatedApplySuccess;
@@ -699,7 +785,7 @@ int64_t BinaryLogSink::applyMpTxn(const char *rawLogs, int32_t logCount,
             }
         }
 
-        position = logs[i]->m_logEnd;
+        position = logs[i]->m_nextLog;
 
         // Handle the replicated table transaction up front to reduce the required site coordination
         if (logs[i]->isReplicatedTableLog()) {
@@ -752,33 +838,33 @@ int64_t BinaryLogSink::applyMpTxn(const char *rawLogs, int32_t logCount,
                 continue;
             }
 
-            DRRecordType type;
+            DRRecordReference record;
+            bool truncated = false;
 
-            while ((type = logs[i]->readRecordType()) != DR_RECORD_END_TXN) {
-                if (type == DR_RECORD_TRUNCATE_TABLE) {
+            while (logs[i]->readRecord(record)) {
+                if (record.m_type == DR_RECORD_TRUNCATE_TABLE) {
                     ++truncateCount;
                     if (i == 0) {
                         assert(truncateTableName.size() == 0);
-                        truncateTableHandle = logs[i]->m_taskInfo.readLong();
-                        truncateTableName = logs[i]->m_taskInfo.readTextString();
-                    } else {
-                        int64_t tempTableHandle = logs[i]->m_taskInfo.readLong();
-                        std::string tempTableName = logs[i]->m_taskInfo.readTextString();
-
-                        if (truncateTableHandle != tempTableHandle || truncateTableName.compare(tempTableName) != 0) {
-                            throwFatalException("Table id or name not the same for all truncate transactions:"
-                                    "table ID %jd != %jd or name '%s' != '%s' log %d", (intmax_t ) truncateTableHandle,
-                                    (intmax_t ) tempTableHandle, truncateTableName.c_str(), tempTableName.c_str(), i);
-                        }
+                        truncateTableHandle = record.m_tableHandle;
+                        truncateTableName = record.m_tableName;
+                    } else if (truncateTableHandle != record.m_tableHandle ||
+                               truncateTableName.compare(record.m_tableName) != 0) {
+                        throwFatalException("Table id or name not the same for all truncate transactions:"
+                                "table ID %jd != %jd or name '%s' != '%s' log %d", (intmax_t ) truncateTableHandle,
+                                (intmax_t ) record.m_tableHandle, truncateTableName.c_str(),
+                                record.m_tableName.c_str(), i);
                     }
+                    truncated = true;
                     break;
                 }
 
-                bool skipRow = !engine->isLocalSite(logs[i]->m_partitionHash);
-                rowCount += applyRecord(logs[i].get(), type, tables, pool, engine, remoteClusterId, false, skipRow);
+                if (engine->isLocalSite(logs[i]->m_partitionHash)) {
+                    rowCount += applyRecord(logs[i].get(), record, tables, pool, engine, remoteClusterId, false);
+                }
             }
 
-            if (type == DR_RECORD_END_TXN) {
+            if (!truncated) {
                 assert(truncateCount == 0);
 
                 logs[i]->validateEndTxn();
@@ -826,35 +912,89 @@ int64_t BinaryLogSink::applyTxn(BinaryLog *log, boost::unordered_map<int64_t, Pe
                  Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
                  int64_t localUniqueId, bool replicatedTable) {
 
-    DRRecordType type;
     int64_t rowCount = 0;
     bool checkForSkip = !log->isReplicatedTableLog();
     bool canSkip = UniqueId::isMpUniqueId(localUniqueId);
 
     START_TIMER(timer);
 
-    while ((type = log->readRecordType()) != DR_RECORD_END_TXN) {
+    // Decode the whole transaction first so that it can be applied one table at a time
+    m_records.clear();
+    DRRecordReference record;
+    while (log->readRecord(record)) {
         assert(log->m_hashFlag != TXN_PAR_HASH_PLACEHOLDER);
-        bool skipRow = false;
+        record.m_skip = false;
         if (checkForSkip && !engine->isLocalSite(log->m_partitionHash)) {
             if (canSkip) {
-                skipRow = true;
+                record.m_skip = true;
             } else {
                 throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_TXN_MISPARTITIONED,
                     "Binary log txns were sent to the wrong partition");
             }
         }
-        rowCount += applyRecord(log, type, tables, pool, engine, remoteClusterId, replicatedTable, skipRow);
+        m_records.push_back(record);
     }
 
     log->validateEndTxn();
 
+    if (m_batchedApply && groupRecordsByTable() > 1) {
+        // Records for different tables are independent, so applying each table's records back to back keeps
+        // that table's indexes warm in cache. Within a table the log order (and so the conflict detection
+        // outcome) is unchanged, but conflicts on different tables are exported grouped by table.
+        BOOST_FOREACH(uint32_t recordIndex, m_applyOrder) {
+            const DRRecordReference &current = m_records[recordIndex];
+            if (!current.m_skip) {
+                rowCount += applyRecord(log, current, tables, pool, engine, remoteClusterId, replicatedTable);
+            }
+        }
+    } else {
+        BOOST_FOREACH(const DRRecordReference &current, m_records) {
+            if (!current.m_skip) {
+                rowCount += applyRecord(log, current, tables, pool, engine, remoteClusterId, replicatedTable);
+            }
+        }
+    }
+
     STOP_TIMER(timer, applyLogs, "applied %ld rows from %d uniqueId: %ld, sequenceNumber: %ld", rowCount,
             remoteClusterId, log->m_uniqueId, log->m_sequenceNumber);
 
     return rowCount;
 }
 
+uint32_t BinaryLogSink::groupRecordsByTable() {
+    // A transaction touches few tables, so a linear search beats hashing here
+    m_txnTableHandles.clear();
+    BOOST_FOREACH(DRRecordReference &record, m_records) {
+        uint32_t ordinal = 0;
+        while (ordinal < m_txnTableHandles.size() && m_txnTableHandles[ordinal] != record.m_tableHandle) {
+            ++ordinal;
+        }
+        if (ordinal == m_txnTableHandles.size()) {
+            m_txnTableHandles.push_back(record.m_tableHandle);
+        }
+        record.m_tableOrdinal = ordinal;
+    }
+
+    uint32_t tableCount = static_cast<uint32_t>(m_txnTableHandles.size());
+    if (tableCount <= 1) {
+        return tableCount;
+    }
+
+    // Counting sort on the table ordinal, which is stable and so keeps log order within each table
+    m_tableRecordOffsets.assign(tableCount + 1, 0);
+    BOOST_FOREACH(const DRRecordReference &record, m_records) {
+        ++m_tableRecordOffsets[record.m_tableOrdinal + 1];
+    }
+    for (uint32_t ordinal = 1; ordinal <= tableCount; ++ordinal) {
+        m_tableRecordOffsets[ordinal] += m_tableRecordOffsets[ordinal - 1];
+    }
+    m_applyOrder.resize(m_records.size());
+    for (uint32_t ii = 0; ii < m_records.size(); ++ii) {
+        m_applyOrder[m_tableRecordOffsets[m_records[ii].m_tableOrdinal]++] = ii;
+    }
+    return tableCount;
+}
+
 int64_t BinaryLogSink::applyReplicatedTxn(BinaryLog *log, boost::unordered_map<int64_t, PersistentTable*> &tables,
         Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId, int64_t localUniqueId) {
     ConditionalSynchronizedExecuteWithMpMemory possiblySynchronizedUseMpMemory(true, engine->isLowestSite(),
@@ -880,14 +1020,14 @@ int64_t BinaryLogSink::applyReplicatedTxn(BinaryLog *log, boost::unordered_map<i
 }
 
 int64_t BinaryLogSink::applyRecord(BinaryLog *log,
-                             const DRRecordType type,
+                             const DRRecordReference &record,
                              boost::unordered_map<int64_t, PersistentTable*> &tables,
                              Pool *pool,
                              VoltDBEngine *engine,
                              int32_t remoteClusterId,
-                             bool replicatedTable,
-                             bool skipRow) {
-    ReferenceSerializeInputLE *taskInfo = &log->m_taskInfo;
+                             bool replicatedTable) {
+    const DRRecordType type = record.m_type;
+    int64_t tableHandle = record.m_tableHandle;
     int64_t uniqueId = log->m_uniqueId;
     int64_t sequenceNumber = log->m_sequenceNumber;
 
@@ -899,12 +1039,8 @@ int64_t BinaryLogSink::applyRecord(BinaryLog *log,
 
     switch (type) {
     case DR_RECORD_INSERT: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t rowLength = taskInfo->readInt();
-        const char *rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(rowLength));
-        if (skipRow) {
-            break;
-        }
+        int32_t rowLength = record.m_rowLength;
+        const char *rowData = record.m_rowData;
 
         boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
         if (tableIter == tables.end()) {
@@ -938,12 +1074,8 @@ int64_t BinaryLogSink::applyRecord(BinaryLog *log,
         break;
     }
     case DR_RECORD_DELETE: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t rowLength = taskInfo->readInt();
-        const char *rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(rowLength));
-        if (skipRow) {
-            break;
-        }
+        int32_t rowLength = record.m_rowLength;
+        const char *rowData = record.m_rowData;
 
         boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
         if (tableIter == tables.end()) {
@@ -992,14 +1124,10 @@ int64_t BinaryLogSink::applyRecord(BinaryLog *log,
         break;
     }
     case DR_RECORD_UPDATE: {
-        int64_t tableHandle = taskInfo->readLong();
-        int32_t oldRowLength = taskInfo->readInt();
-        const char *oldRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(oldRowLength));
-        int32_t newRowLength = taskInfo->readInt();
-        const char *newRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(newRowLength));
-        if (skipRow) {
-            break;
-        }
+        int32_t oldRowLength = record.m_rowLength;
+        const char *oldRowData = record.m_rowData;
+        int32_t newRowLength = record.m_newRowLength;
+        const char *newRowData = record.m_newRowData;
 
         boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
         if (tableIter == tables.end()) {
@@ -1078,25 +1206,14 @@ int64_t BinaryLogSink::applyRecord(BinaryLog *log,
         STOP_TIMER_OP("UPDATE in %s of %s to %s", table->name().c_str(), oldTuple.toJsonArray().c_str(), tempTuple.toJsonArray().c_str());
         break;
     }
-    case DR_RECORD_DELETE_BY_INDEX: {
-        throwSerializableEEException("Delete by index is not supported for DR");
-    }
-    case DR_RECORD_UPDATE_BY_INDEX: {
-        throwSerializableEEException("Update by index is not supported for DR");
-    }
     case DR_RECORD_TRUNCATE_TABLE: {
-        int64_t tableHandle = taskInfo->readLong();
-        std::string tableName = taskInfo->readTextString();
+        std::string tableName = record.m_tableName;
 
         truncateTable(tables, engine, replicatedTable, tableHandle, &tableName);
         STOP_TIMER_OP("TRUNCATE TABLE %s", tableName.c_str());
 
         break;
     }
-    case DR_RECORD_BEGIN_TXN: {
-        throwFatalException("Unexpected BEGIN_TXN before END_TXN");
-        break;
-    }
     default:
         throwFatalException("Unrecognized DR record type %d", type);
         break;
@@ -19,10 +19,14 @@
 #define BINARYLOGSINK_H
 
 #include "common/serializeio.h"
+#include "common/types.h"
 
 #include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <string>
+#include <vector>
+
 namespace voltdb {
 
 class PersistentTable;
@@ -31,6 +35,24 @@ class VoltDBEngine;
 
 class BinaryLog;
 
+/*
+ * One decoded binary log record. The row pointers reference the log buffer, which outlives the apply.
+ */
+struct DRRecordReference {
+    DRRecordType m_type;
+    int64_t m_tableHandle;
+    const char *m_rowData;
+    int32_t m_rowLength;
+    // Only set for DR_RECORD_UPDATE
+    const char *m_newRowData;
+    int32_t m_newRowLength;
+    // Only set for DR_RECORD_TRUNCATE_TABLE
+    std::string m_tableName;
+    bool m_skip;
+    // Position of the record's table among the tables the transaction touches
+    uint32_t m_tableOrdinal;
+};
+
 /*
  * Responsible for applying binary logs to table data
  */
@@ -50,6 +72,14 @@ public:
     int64_t apply(const char *logs, boost::unordered_map<int64_t, PersistentTable*> &tables, Pool *pool,
             VoltDBEngine *engine, int32_t remoteClusterId, int64_t localUniqueId);
 
+    /**
+     * When enabled (the default) each transaction is decoded in full and its records are applied grouped by
+     * target table, keeping the order of the records within each table. Conflicts are then exported in that
+     * same table grouped order rather than log order. When disabled records are applied in log order.
+     */
+    void setBatchedApply(bool batchedApply) { m_batchedApply = batchedApply; }
+    bool isBatchedApply() const { return m_batchedApply; }
+
 private:
     /**
      * Apply all transactions within one log
@@ -78,9 +108,22 @@ private:
     /**
      * Apply a single record from a binary log performing any necessary conflict handling.
      */
-    int64_t applyRecord(BinaryLog *log, const DRRecordType type,
+    int64_t applyRecord(BinaryLog *log, const DRRecordReference &record,
             boost::unordered_map<int64_t, PersistentTable*> &tables, Pool *pool, VoltDBEngine *engine,
-            int32_t remoteClusterId, bool replicatedTable, bool skipRow);
+            int32_t remoteClusterId, bool replicatedTable);
+
+    /**
+     * Order m_records by table into m_applyOrder, keeping log order within each table.
+     * @return the number of distinct tables in the transaction
+     */
+    uint32_t groupRecordsByTable();
+
+    bool m_batchedApply;
+    // Scratch space reused across transactions
+    std::vector<DRRecordReference> m_records;
+    std::vector<int64_t> m_txnTableHandles;
+    std::vector<uint32_t> m_tableRecordOffsets;
+    std::vector<uint32_t> m_applyOrder;
 };
 
 
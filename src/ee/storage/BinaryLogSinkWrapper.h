@@ -38,6 +38,8 @@ public:
     int64_t apply(const char *logs,
             boost::unordered_map<int64_t, PersistentTable*> &tables, Pool *pool, VoltDBEngine *engine,
             int32_t remoteClusterId, int64_t localUniqueId);
+
+    void setBatchedApply(bool batchedApply) { m_sink.setBatchedApply(batchedApply); }
 private:
     BinaryLogSink m_sink;
 };
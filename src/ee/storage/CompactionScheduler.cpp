@@ -0,0 +1,98 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/CompactionScheduler.h"
+#include "storage/persistenttable.h"
+
+#include "boost/foreach.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace voltdb {
+
+namespace {
+struct SparsestFirst {
+    bool operator()(PersistentTable* a, PersistentTable* b) const {
+        // Compare activeA/allocatedA < activeB/allocatedB without dividing.
+        return a->activeTupleCount() * b->allocatedTupleCount() <
+               b->activeTupleCount() * a->allocatedTupleCount();
+    }
+};
+}
+
+const int32_t CompactionScheduler::TUPLES_PER_SLICE;
+
+CompactionScheduler::CompactionScheduler(int32_t maxTuplesPerTick, int64_t maxMicrosPerTick)
+  : m_maxTuplesPerTick(maxTuplesPerTick), m_maxMicrosPerTick(maxMicrosPerTick)
+{
+}
+
+int32_t CompactionScheduler::compact(const std::vector<PersistentTable*>& tables) {
+    std::vector<PersistentTable*> candidates;
+    BOOST_FOREACH (auto table, tables) {
+        if (table->compactionPredicate()) {
+            candidates.push_back(table);
+        }
+    }
+    m_counters.tablesPending = candidates.size();
+    if (candidates.empty() || m_maxTuplesPerTick <= 0) {
+        return 0;
+    }
+    std::sort(candidates.begin(), candidates.end(), SparsestFirst());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int64_t elapsedMicros = 0;
+    int32_t tupleBudget = m_maxTuplesPerTick;
+    int64_t tablesPending = 0;
+    bool exhausted = false;
+    BOOST_FOREACH (auto table, candidates) {
+        PersistentTableStats* stats = table->getPersistentTableStats();
+        int64_t blocksBefore = stats->getCompactedBlocks();
+        int64_t bytesBefore = stats->getCompactedBytes();
+        int32_t movedFromTable = 0;
+        while ( ! exhausted) {
+            int32_t moved = table->doIncrementalCompaction(std::min(tupleBudget, TUPLES_PER_SLICE));
+            tupleBudget -= moved;
+            movedFromTable += moved;
+            m_counters.tuplesMoved += moved;
+            elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            exhausted = tupleBudget <= 0 || elapsedMicros >= m_maxMicrosPerTick;
+            if (moved == 0 || ! table->compactionPredicate()) {
+                break;
+            }
+        }
+        if (movedFromTable > 0) {
+            m_counters.tableSteps++;
+        }
+        m_counters.blocksReclaimed += stats->getCompactedBlocks() - blocksBefore;
+        m_counters.bytesReclaimed += stats->getCompactedBytes() - bytesBefore;
+        if (table->compactionPredicate()) {
+            tablesPending++;
+        }
+    }
+    m_counters.ticks++;
+    if (exhausted && tablesPending > 0) {
+        m_counters.exhaustedTicks++;
+    }
+    m_counters.totalMicros += elapsedMicros;
+    m_counters.tablesPending = tablesPending;
+    return m_maxTuplesPerTick - tupleBudget;
+}
+
+}
@@ -0,0 +1,85 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTIONSCHEDULER_H_
+#define COMPACTIONSCHEDULER_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace voltdb {
+class PersistentTable;
+
+/**
+ * Site-wide totals of the work done by a CompactionScheduler.
+ */
+struct CompactionSchedulerCounters {
+    CompactionSchedulerCounters()
+      : ticks(0), exhaustedTicks(0), tableSteps(0),
+        tuplesMoved(0), blocksReclaimed(0), bytesReclaimed(0),
+        totalMicros(0), tablesPending(0)
+    {}
+
+    // Ticks that found at least one table worth compacting.
+    int64_t ticks;
+    // Ticks that ran out of tuple or time budget before every table was compacted.
+    int64_t exhaustedTicks;
+    int64_t tableSteps;
+    int64_t tuplesMoved;
+    int64_t blocksReclaimed;
+    int64_t bytesReclaimed;
+    int64_t totalMicros;
+    // Tables still over their compaction threshold at the end of the last tick.
+    int64_t tablesPending;
+};
+
+/**
+ * Incrementally compacts the partitioned tables of a site from tick().
+ *
+ * Each call moves at most maxTuplesPerTick tuples and stops once
+ * maxMicrosPerTick have elapsed, across all tables.  Tables whose blocks are
+ * the sparsest (lowest ratio of active to allocated tuples) go first, and
+ * within a table the lightest blocks of the load buckets are merged into the
+ * fullest ones.  Work is handed out in slices of TUPLES_PER_SLICE so the time
+ * budget is checked regularly.
+ */
+class CompactionScheduler {
+public:
+    static const int32_t TUPLES_PER_SLICE = 256;
+
+    CompactionScheduler(int32_t maxTuplesPerTick, int64_t maxMicrosPerTick);
+
+    /**
+     * Spend at most one tick's budget compacting the given tables.  Tables
+     * that do not satisfy their compaction predicate are skipped.
+     * @return the number of tuples moved.
+     */
+    int32_t compact(const std::vector<PersistentTable*>& tables);
+
+    const CompactionSchedulerCounters& counters() const {
+        return m_counters;
+    }
+
+private:
+    const int32_t m_maxTuplesPerTick;
+    const int64_t m_maxMicrosPerTick;
+    CompactionSchedulerCounters m_counters;
+};
+
+}
+
+#endif /* COMPACTIONSCHEDULER_H_ */
@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/CompactionStats.h"
+
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> CompactionStats::generateCompactionStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("TABLES_PENDING");
+    columnNames.push_back("TICKS");
+    columnNames.push_back("EXHAUSTED_TICKS");
+    columnNames.push_back("TABLE_STEPS");
+    columnNames.push_back("TUPLES_MOVED");
+    columnNames.push_back("BLOCKS_RECLAIMED");
+    columnNames.push_back("BYTES_RECLAIMED");
+    columnNames.push_back("TOTAL_MICROS");
+    return columnNames;
+}
+
+void CompactionStats::populateCompactionStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 8; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* CompactionStats::generateEmptyCompactionStatsTable() {
+    string name = "Compaction stats temp table";
+    vector<string> columnNames = CompactionStats::generateCompactionStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    CompactionStats::populateCompactionStatsSchema(columnTypes, columnLengths,
+                                                   columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name, schema, columnNames, NULL);
+}
+
+CompactionStats::CompactionStats(const CompactionSchedulerCounters& counters)
+    : StatsSource(), m_counters(counters)
+{
+}
+
+CompactionStats::~CompactionStats() {
+    m_tableName.free();
+}
+
+void CompactionStats::configure(string name) {
+    StatsSource::configure(name);
+    updateTableName(name);
+}
+
+vector<string> CompactionStats::generateStatsColumnNames() {
+    return CompactionStats::generateCompactionStatsColumnNames();
+}
+
+void CompactionStats::updateStatsTuple(TableTuple *tuple) {
+    CompactionSchedulerCounters counters = m_counters;
+    if (interval()) {
+        counters.ticks -= m_lastCounters.ticks;
+        counters.exhaustedTicks -= m_lastCounters.exhaustedTicks;
+        counters.tableSteps -= m_lastCounters.tableSteps;
+        counters.tuplesMoved -= m_lastCounters.tuplesMoved;
+        counters.blocksReclaimed -= m_lastCounters.blocksReclaimed;
+        counters.bytesReclaimed -= m_lastCounters.bytesReclaimed;
+        counters.totalMicros -= m_lastCounters.totalMicros;
+        m_lastCounters = m_counters;
+    }
+    // The number of pending tables is a level, not a counter.
+    tuple->setNValue(StatsSource::m_columnName2Index["TABLES_PENDING"],
+                     ValueFactory::getBigIntValue(counters.tablesPending));
+    tuple->setNValue(StatsSource::m_columnName2Index["TICKS"],
+                     ValueFactory::getBigIntValue(counters.ticks));
+    tuple->setNValue(StatsSource::m_columnName2Index["EXHAUSTED_TICKS"],
+                     ValueFactory::getBigIntValue(counters.exhaustedTicks));
+    tuple->setNValue(StatsSource::m_columnName2Index["TABLE_STEPS"],
+                     ValueFactory::getBigIntValue(counters.tableSteps));
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLES_MOVED"],
+                     ValueFactory::getBigIntValue(counters.tuplesMoved));
+    tuple->setNValue(StatsSource::m_columnName2Index["BLOCKS_RECLAIMED"],
+                     ValueFactory::getBigIntValue(counters.blocksReclaimed));
+    tuple->setNValue(StatsSource::m_columnName2Index["BYTES_RECLAIMED"],
+                     ValueFactory::getBigIntValue(counters.bytesReclaimed));
+    tuple->setNValue(StatsSource::m_columnName2Index["TOTAL_MICROS"],
+                     ValueFactory::getBigIntValue(counters.totalMicros));
+}
+
+void CompactionStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    CompactionStats::populateCompactionStatsSchema(types, columnLengths, allowNull, inBytes);
+}
@@ -0,0 +1,137 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/DRBlockCompressor.h"
+
+#include "common/ExportSerializeIo.h"
+#include "common/FastBlockCompressor.h"
+#include "common/StreamBlock.h"
+#include "common/StreamBufferPool.h"
+
+#include <boost/foreach.hpp>
+
+#include <cstring>
+
+namespace voltdb {
+
+DRBlockCompressor::DRBlockCompressor()
+  : m_mutex(), m_workReady(), m_jobDone(), m_jobs(), m_nextJob(0), m_stopping(false), m_scratch(),
+    m_thread(&DRBlockCompressor::run, this)
+{
+}
+
+DRBlockCompressor::~DRBlockCompressor() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopping = true;
+    }
+    m_workReady.notify_one();
+    m_thread.join();
+    BOOST_FOREACH (Job &job, m_jobs) {
+        StreamBufferPool::release(job.block->rawPtr());
+        delete job.block;
+    }
+}
+
+void DRBlockCompressor::submit(DrStreamBlock *block, bool compress) {
+    Job job;
+    job.block = block;
+    job.compress = compress;
+    job.done = false;
+    job.bytesBefore = 0;
+    job.bytesAfter = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_jobs.push_back(job);
+    }
+    m_workReady.notify_one();
+}
+
+DrStreamBlock *DRBlockCompressor::takeNext(bool wait, int64_t &bytesBefore, int64_t &bytesAfter) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_jobs.empty()) {
+        return NULL;
+    }
+    if (wait) {
+        m_jobDone.wait(lock, [this]() { return m_jobs.front().done; });
+    }
+    else if (!m_jobs.front().done) {
+        return NULL;
+    }
+    Job &job = m_jobs.front();
+    DrStreamBlock *block = job.block;
+    bytesBefore = job.bytesBefore;
+    bytesAfter = job.bytesAfter;
+    m_jobs.pop_front();
+    --m_nextJob;
+    return block;
+}
+
+bool DRBlockCompressor::empty() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_jobs.empty();
+}
+
+void DRBlockCompressor::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_workReady.wait(lock, [this]() { return m_stopping || m_nextJob < m_jobs.size(); });
+        if (m_stopping) {
+            return;
+        }
+        // References into a deque survive pushes at the back, and the site
+        // only pops jobs that are done.
+        Job &job = m_jobs[m_nextJob];
+        lock.unlock();
+        if (job.compress) {
+            compressBlock(job);
+        }
+        lock.lock();
+        job.done = true;
+        ++m_nextJob;
+        m_jobDone.notify_one();
+    }
+}
+
+void DRBlockCompressor::compressBlock(Job &job) {
+    DrStreamBlock *block = job.block;
+    size_t length = block->offset();
+    if (length < DR_MIN_COMPRESSIBLE_SIZE) {
+        return;
+    }
+    // Only keep the compressed form if it is smaller, header included
+    size_t capacity = length - DR_COMPRESSED_LOG_HEADER_SIZE - 1;
+    if (m_scratch.size() < capacity) {
+        m_scratch.resize(capacity);
+    }
+    char *payload = block->rawPtr() + block->headerSize();
+    size_t compressedLength = FastBlockCompressor::compress(payload, length, &m_scratch[0], capacity);
+    job.bytesBefore = length;
+    if (compressedLength == 0) {
+        job.bytesAfter = length;
+        return;
+    }
+
+    ExportSerializeOutput out(payload, length);
+    out.writeByte(static_cast<int8_t>(DR_COMPRESSED_LOG_MARKER));
+    out.writeInt(static_cast<int32_t>(length));
+    ::memcpy(payload + DR_COMPRESSED_LOG_HEADER_SIZE, &m_scratch[0], compressedLength);
+    block->recordCompressed(DR_COMPRESSED_LOG_HEADER_SIZE + compressedLength);
+    job.bytesAfter = block->offset();
+}
+
+}
@@ -0,0 +1,99 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DRBLOCKCOMPRESSOR_H_
+#define DRBLOCKCOMPRESSOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace voltdb {
+
+class DrStreamBlock;
+
+// Takes the place of the protocol version as the first byte of a compressed binary log
+const uint8_t DR_COMPRESSED_LOG_MARKER = 0xFF;
+// Marker(1), uncompressed length(4)
+const size_t DR_COMPRESSED_LOG_HEADER_SIZE = 1 + 4;
+// Smaller buffers are not worth compressing
+const size_t DR_MIN_COMPRESSIBLE_SIZE = 4096;
+
+/**
+ * Compresses sealed DR stream blocks on a helper thread of its own.
+ *
+ * The site thread submits each block as it would have pushed it to the top
+ * end, and later takes the blocks back, in submission order, to push them.
+ * A block is never touched by the site after it is sealed and committed, so
+ * the helper can rewrite it in place.  Blocks that are not to be compressed,
+ * such as DR events, pass through untouched but keep their place in line.
+ */
+class DRBlockCompressor {
+public:
+    DRBlockCompressor();
+
+    /** Stop the helper thread and free any block not taken back yet. */
+    ~DRBlockCompressor();
+
+    /** Queue a block, taking ownership of it until it is taken back. */
+    void submit(DrStreamBlock *block, bool compress);
+
+    /**
+     * Take back the oldest queued block once the helper is done with it.
+     *
+     * @param wait block until the oldest block is done instead of returning NULL
+     * @param bytesBefore set to the payload length offered for compression
+     * @param bytesAfter set to the payload length the block is sent with
+     * @return the block, or NULL if none is ready
+     */
+    DrStreamBlock *takeNext(bool wait, int64_t &bytesBefore, int64_t &bytesAfter);
+
+    bool empty() const;
+
+private:
+    struct Job {
+        DrStreamBlock *block;
+        bool compress;
+        bool done;
+        int64_t bytesBefore;
+        int64_t bytesAfter;
+    };
+
+    void run();
+    void compressBlock(Job &job);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workReady;
+    std::condition_variable m_jobDone;
+    // Jobs in submission order; those before m_nextJob are done.  Only the
+    // site thread adds or removes jobs, so the helper can work on a job
+    // without holding the lock.
+    std::deque<Job> m_jobs;
+    size_t m_nextJob;
+    bool m_stopping;
+    // Only used by the helper thread
+    std::vector<char> m_scratch;
+    std::thread m_thread;
+};
+
+}
+
+#endif // DRBLOCKCOMPRESSOR_H_
@@ -184,17 +184,31 @@ int64_t ElasticContext::handleStreamMore(TupleOutputStreamProcessor &outputStrea
 
     // Populate index with current tuples.
     // Table changes are tracked through notifications.
+    // When the predicate is the usual hash range on the partition column
+    // each tuple is hashed once, both to test the ranges and for its key.
+    HashRangeExpression *hashRange = dynamic_cast<HashRangeExpression*>(&getPredicates()[0]);
+    if (hashRange != NULL && hashRange->getColumnId() != getTable().partitionColumn()) {
+        hashRange = NULL;
+    }
+    m_pendingKeys.clear();
     size_t i = 0;
     TableTuple tuple(getTable().schema());
     while (m_scanner->next(tuple)) {
-        if (getPredicates()[0].eval(&tuple).isTrue()) {
-            m_surgeon.indexAdd(tuple);
+        if (hashRange != NULL) {
+            ElasticHash hash = tuple.getNValue(hashRange->getColumnId()).murmurHash3();
+            if (hashRange->binarySearch(hash).isTrue()) {
+                m_pendingKeys.push_back(ElasticIndexKey(hash, tuple.address()));
+            }
+        }
+        else if (getPredicates()[0].eval(&tuple).isTrue()) {
+            m_pendingKeys.push_back(ElasticIndex::generateKey(getTable(), tuple));
         }
         // Take a breather after every chunk of m_nTuplesPerCall tuples.
         if (++i == m_nTuplesPerCall) {
             break;
         }
     }
+    m_surgeon.indexAddAll(m_pendingKeys);
 
     // Done with indexing?
     bool indexingComplete = m_scanner->isScanComplete();
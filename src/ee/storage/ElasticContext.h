@@ -20,6 +20,7 @@
 #include <vector>
 #include <string>
 #include <boost/scoped_ptr.hpp>
+#include "storage/ElasticIndex.h"
 #include "storage/ElasticScanner.h"
 #include "storage/TableStreamerContext.h"
 #include "storage/TupleBlock.h"
@@ -138,6 +139,12 @@ private:
      */
     bool m_indexActive;
 
+    /**
+     * Keys found by the current handleStreamMore() call, added to the index
+     * in one sorted batch. Kept to reuse the allocation.
+     */
+    std::vector<ElasticIndexKey> m_pendingKeys;
+
     static const size_t DEFAULT_TUPLES_PER_CALL = 10000;
 };
 
@@ -17,8 +17,10 @@
 #ifndef ELASTIC_INDEX_H_
 #define ELASTIC_INDEX_H_
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
+#include <vector>
 #include <stx/btree.h>
 #include <boost/iterator/iterator_facade.hpp>
 #include "storage/TupleBlock.h"
@@ -132,6 +134,13 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
      */
     bool add(const ElasticIndexKey &key);
 
+    /**
+     * Add a batch of keys (direct), sorting them first so that the inserts
+     * walk along the leaves instead of descending to a random one per key.
+     * Keys already present are skipped.
+     */
+    void addAll(std::vector<ElasticIndexKey> &keys);
+
     /**
      * Remove key from index.
      * Return true if the key was present and removed.
@@ -173,11 +182,14 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
      */
     void printKeys(std::ostream &os, int32_t limit, const TupleSchema *schema, const PersistentTable &table) const;
 
+    /**
+     * Generate the key for a tuple.
+     */
+    static ElasticIndexKey generateKey(const PersistentTable &table, const TableTuple &tuple);
+
   private:
 
     static ElasticHash generateHash(const PersistentTable &table, const TableTuple &tuple);
-
-    static ElasticIndexKey generateKey(const PersistentTable &table, const TableTuple &tuple);
 };
 
 /**
@@ -401,6 +413,14 @@ inline bool ElasticIndex::add(const ElasticIndexKey &key)
  * Remove key from index.
  * Return true if the key was present and removed.
  */
+inline void ElasticIndex::addAll(std::vector<ElasticIndexKey> &keys)
+{
+    std::sort(keys.begin(), keys.end(), ElasticIndexComparator());
+    for (std::vector<ElasticIndexKey>::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+        insert(*it);
+    }
+}
+
 inline bool ElasticIndex::remove(const PersistentTable &table, const TableTuple &tuple)
 {
     bool removed = false;
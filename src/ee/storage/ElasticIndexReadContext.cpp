@@ -15,6 +15,8 @@
  * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include "common/MiscUtil.h"
 #include "common/TupleOutputStream.h"
@@ -38,6 +40,8 @@ ElasticIndexReadContext::ElasticIndexReadContext(
         const std::vector<std::string> &predicateStrings) :
     TableStreamerContext(table, surgeon, partitionId),
     m_predicateStrings(predicateStrings),
+    m_nextTuple(0),
+    m_activated(false),
     m_materialized(false)
 {}
 
@@ -67,13 +71,25 @@ ElasticIndexReadContext::handleActivation(TableStreamType streamType)
         return ACTIVATION_FAILED;
     }
 
-    ElasticIndexHashRange range;
-    if (!parseHashRange(m_predicateStrings, range)) {
+    if (!parseHashRange(m_predicateStrings, m_range)) {
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, "Activation failed because parsing the hash range showed a conflict.");
         return ACTIVATION_FAILED;
     }
 
-    m_iter = m_surgeon.getIndexTupleRangeIterator(range);
+    // Take the range from the index, then stream it in block order rather
+    // than hash order.
+    boost::shared_ptr<ElasticIndexTupleRangeIterator> iter = m_surgeon.getIndexTupleRangeIterator(m_range);
+    m_tuples.clear();
+    m_extraPendingTuples.clear();
+    m_extraStreamedTuples.clear();
+    m_nextTuple = 0;
+    TableTuple tuple;
+    while (iter->next(tuple)) {
+        m_tuples.push_back(tuple.address());
+    }
+    std::sort(m_tuples.begin(), m_tuples.end());
+    m_removedTuples.assign(m_tuples.size(), false);
+    m_activated = true;
     return ACTIVATION_SUCCEEDED;
 }
 
@@ -104,7 +120,7 @@ int64_t ElasticIndexReadContext::handleStreamMore(
     int64_t remaining = 1;
 
     // Check that activation happened.
-    if (m_iter == NULL) {
+    if (!m_activated) {
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
             "Attempted to begin serialization without activating the context.");
         remaining = TABLE_STREAM_SERIALIZATION_ERROR;
@@ -119,8 +135,8 @@ int64_t ElasticIndexReadContext::handleStreamMore(
 
     else {
         // Anything left?
-        TableTuple tuple;
-        if (!m_iter->next(tuple)) {
+        TableTuple tuple(getTable().schema());
+        if (!nextTuple(tuple)) {
             remaining = 0;
         }
 
@@ -147,7 +163,7 @@ int64_t ElasticIndexReadContext::handleStreamMore(
                 }
 
                 if (!yield) {
-                    if (!m_iter->next(tuple)) {
+                    if (!nextTuple(tuple)) {
                         yield = true;
                         remaining = 0;
                     }
@@ -165,10 +181,8 @@ int64_t ElasticIndexReadContext::handleStreamMore(
          */
         /*
         std::ostringstream os;
-        ElasticIndexHashRange range = m_iter->range();
-        os << "Moved " << outputStreams.at(0).getSerializedRowCount() << " rows for range ["
-           << range.getLowerBound() << ", " << range.getUpperBound()
-           << "], elastic index size is " << m_surgeon.indexSize();
+        os << "Moved " << outputStreams.at(0).getSerializedRowCount() << " rows for range "
+           << m_predicateStrings.at(0) << ", elastic index size is " << m_surgeon.indexSize();
 
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_INFO, os.str().c_str());
          */
@@ -231,14 +245,127 @@ void ElasticIndexReadContext::deleteStreamedTuples()
     // Delete the indexed tuples that were streamed.
     // Undo token release will cause the index to delete the corresponding items
     // via notifications.
+    // The deletes notify back into this context, so work from a copy.
     DRTupleStreamDisableGuard guard(ExecutorContext::getExecutorContext());
-    m_iter->reset();
-    TableTuple tuple;
-    while (m_iter->next(tuple)) {
+    std::vector<char*> streamed(m_extraStreamedTuples.begin(), m_extraStreamedTuples.end());
+    for (size_t i = 0; i < m_nextTuple; ++i) {
+        if (!m_removedTuples[i]) {
+            streamed.push_back(m_tuples[i]);
+        }
+    }
+    m_tuples.clear();
+    m_removedTuples.clear();
+    m_nextTuple = 0;
+    m_extraPendingTuples.clear();
+    m_extraStreamedTuples.clear();
+    TableTuple tuple(getTable().schema());
+    BOOST_FOREACH(char *address, streamed) {
+        tuple.move(address);
         if (!tuple.isPendingDelete()) {
             m_surgeon.deleteTuple(tuple);
         }
     }
 }
 
+/**
+ * Position the tuple on the next address of the range.
+ */
+bool ElasticIndexReadContext::nextTuple(TableTuple &tuple)
+{
+    while (m_nextTuple < m_tuples.size() && m_removedTuples[m_nextTuple]) {
+        ++m_nextTuple;
+    }
+    char *address;
+    if (m_nextTuple < m_tuples.size()) {
+        address = m_tuples[m_nextTuple++];
+    }
+    else if (!m_extraPendingTuples.empty()) {
+        address = *m_extraPendingTuples.begin();
+        m_extraPendingTuples.erase(m_extraPendingTuples.begin());
+        m_extraStreamedTuples.insert(address);
+    }
+    else {
+        return false;
+    }
+    tuple.move(address);
+    return true;
+}
+
+/**
+ * Binary search of the activation snapshot of the range.
+ */
+size_t ElasticIndexReadContext::findTuple(char *address) const
+{
+    std::vector<char*>::const_iterator it = std::lower_bound(m_tuples.begin(), m_tuples.end(), address);
+    if (it == m_tuples.end() || *it != address) {
+        return m_tuples.size();
+    }
+    return it - m_tuples.begin();
+}
+
+/**
+ * Tuple insert handler adds tuples that the elastic index puts in the range.
+ */
+bool ElasticIndexReadContext::notifyTupleInsert(TableTuple &tuple)
+{
+    if (m_activated && !m_materialized && m_surgeon.indexHas(tuple)) {
+        ElasticHash hash = m_surgeon.generateTupleHash(tuple);
+        if (hash >= m_range.getLowerBound() && hash <= m_range.getUpperBound()) {
+            m_extraPendingTuples.insert(tuple.address());
+        }
+    }
+    return false;
+}
+
+/**
+ * Tuple delete handler drops the tuple whether or not it was streamed yet.
+ */
+bool ElasticIndexReadContext::notifyTupleDelete(TableTuple &tuple)
+{
+    // A freed slot can be reused, so the address may also be a removed entry.
+    size_t index = findTuple(tuple.address());
+    if (index < m_tuples.size() && !m_removedTuples[index]) {
+        m_removedTuples[index] = true;
+    }
+    else if (m_extraPendingTuples.erase(tuple.address()) == 0) {
+        m_extraStreamedTuples.erase(tuple.address());
+    }
+    return true;
+}
+
+/**
+ * Tuple compaction handler moves the tuple's address along with it.
+ */
+void ElasticIndexReadContext::notifyTupleMovement(TBPtr sourceBlock,
+                                                  TBPtr targetBlock,
+                                                  TableTuple &sourceTuple,
+                                                  TableTuple &targetTuple)
+{
+    bool streamed;
+    size_t index = findTuple(sourceTuple.address());
+    if (index < m_tuples.size() && !m_removedTuples[index]) {
+        m_removedTuples[index] = true;
+        streamed = index < m_nextTuple;
+    }
+    else if (m_extraPendingTuples.erase(sourceTuple.address()) != 0) {
+        streamed = false;
+    }
+    else if (m_extraStreamedTuples.erase(sourceTuple.address()) != 0) {
+        streamed = true;
+    }
+    else {
+        return;
+    }
+    // If the tuple is pending delete, it's held on by COW but shouldn't be
+    // accessible anymore, so it leaves the range like it leaves the index.
+    if (!targetTuple.isPendingDelete()) {
+        if (streamed) {
+            m_extraStreamedTuples.insert(targetTuple.address());
+        }
+        else {
+            m_extraPendingTuples.insert(targetTuple.address());
+        }
+    }
+}
+
 } // namespace voltdb
@@ -17,6 +17,7 @@
 #ifndef ELASTIC_INDEX_READ_CONTEXT_H_
 #define ELASTIC_INDEX_READ_CONTEXT_H_
 
+#include <set>
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -59,6 +60,22 @@ public:
     virtual int64_t handleStreamMore(TupleOutputStreamProcessor &outputStreams,
                                      std::vector<int> &retPositions);
 
+    /**
+     * Tuple insert handler picks up new tuples of the range.
+     */
+    virtual bool notifyTupleInsert(TableTuple &tuple);
+
+    /**
+     * Tuple delete handler forgets deleted tuples.
+     */
+    virtual bool notifyTupleDelete(TableTuple &tuple);
+
+    /**
+     * Tuple compaction handler follows tuples to their new address.
+     */
+    virtual void notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
+                                     TableTuple &sourceTuple, TableTuple &targetTuple);
+
 private:
     /**
      * Construct a copy on write context for the specified table that will
@@ -84,11 +101,44 @@ private:
      */
     void deleteStreamedTuples();
 
+    /**
+     * Advance to the next tuple of the range. Return false at the end.
+     */
+    bool nextTuple(TableTuple &tuple);
+
+    /**
+     * Index of the address in m_tuples, or m_tuples.size() if absent.
+     */
+    size_t findTuple(char *address) const;
+
     /// Predicate strings (parsed in handleActivation()/handleReactivation()).
     const std::vector<std::string> &m_predicateStrings;
 
-    /// Elastic index iterator
-    boost::shared_ptr<ElasticIndexTupleRangeIterator> m_iter;
+    /// Hash range (parsed in handleActivation()).
+    ElasticIndexHashRange m_range;
+
+    /// Addresses of the tuples of the range taken at activation, sorted in
+    /// storage order so that consecutive rows are read from the same block.
+    /// Entries before m_nextTuple were streamed unless removed since.
+    std::vector<char*> m_tuples;
+
+    /// One bit per entry of m_tuples, set when the tuple was deleted or
+    /// moved away by compaction.
+    std::vector<bool> m_removedTuples;
+
+    /// Index of the next entry of m_tuples to stream.
+    size_t m_nextTuple;
+
+    /// Tuples inserted into the range or moved by compaction after
+    /// activation, still to be streamed. Only rows touched while the range
+    /// is streaming end up here.
+    std::set<char*> m_extraPendingTuples;
+
+    /// Tuples moved by compaction after they were streamed.
+    std::set<char*> m_extraStreamedTuples;
+
+    /// Set to true after a successful activation.
+    bool m_activated;
 
     /// Set to true after index was completely materialized.
     bool m_materialized;
@@ -30,6 +30,7 @@ using namespace std;
 using namespace voltdb;
 
 const size_t ExportTupleStream::s_EXPORT_BUFFER_HEADER_SIZE = 12; // row count(4) + uniqueId(8)
+const size_t ExportTupleStream::METADATA_DATA_SIZE;
 
 ExportTupleStream::ExportTupleStream(CatalogId partitionId, int64_t siteId, int64_t generation,
                                      std::string signature, const std::string &tableName,
@@ -59,26 +60,8 @@ void ExportTupleStream::setSignatureAndGeneration(std::string signature, int64_t
     m_generation = generation;
 }
 
-/*
- * If SpHandle represents a new transaction, commit previous data.
- * Always serialize the supplied tuple in to the stream.
- * Return m_uso before this invocation - this marks the point
- * in the stream the caller can rollback to if this append
- * should be rolled back.
- */
-size_t ExportTupleStream::appendTuple(
-        VoltDBEngine* engine,
-        int64_t spHandle,
-        int64_t seqNo,
-        int64_t uniqueId,
-        const TableTuple &tuple,
-        int partitionColumn,
-        ExportTupleStream::Type type)
+void ExportTupleStream::openTransaction(int64_t spHandle, int64_t uniqueId)
 {
-    assert(m_columnNames.size() == tuple.columnCount());
-    size_t streamHeaderSz = 0;
-    size_t tupleMaxLength = 0;
-
     // Transaction IDs for transactions applied to this tuple stream
     // should always be moving forward in time.
     if (spHandle < m_openSpHandle)
@@ -90,69 +73,178 @@ size_t ExportTupleStream::appendTuple(
     }
     m_openSpHandle = spHandle;
     m_openUniqueId = uniqueId;
+}
 
-    // Compute the upper bound on bytes required to serialize tuple.
-    // exportxxx: can memoize this calculation.
-    tupleMaxLength = computeOffsets(tuple, &streamHeaderSz);
-    //First time always include schema.
-    if (!m_currBlock) {
-        extendBufferChain(m_defaultCapacity);
-    }
-    if ((m_currBlock->remaining() < tupleMaxLength)) {
-        //If we can not fit the data get a new block with size that includes schemaSize as well.
-        extendBufferChain(tupleMaxLength);
-    }
-
+size_t ExportTupleStream::serializeRow(char *dest, size_t capacity, size_t streamHeaderSz,
+                                       int64_t spHandle, int64_t timestamp, int64_t seqNo, int8_t operation,
+                                       const TableTuple &tuple, int partitionColumn)
+{
     // initialize the full row header to 0. This also
     // has the effect of setting each column non-null.
-    ::memset(m_currBlock->mutableDataPtr(), 0, streamHeaderSz);
+    ::memset(dest, 0, streamHeaderSz);
 
     // the nullarray lives in rowheader after the 4 byte header length prefix + 4 bytes for column count +
     // 4 partition index
     uint8_t *nullArray =
-      reinterpret_cast<uint8_t*>(m_currBlock->mutableDataPtr()
+      reinterpret_cast<uint8_t*>(dest
               + sizeof(int32_t)         // row length
               + sizeof(int32_t)         // partition index
               + sizeof(int32_t)         // column count
               );
 
     // position the serializer after the full rowheader
-    ExportSerializeOutput io(m_currBlock->mutableDataPtr() + streamHeaderSz, m_currBlock->remaining() - streamHeaderSz);
+    ExportSerializeOutput io(dest + streamHeaderSz, capacity - streamHeaderSz);
 
     // write metadata columns - data we always write this.
     io.writeLong(spHandle);
-    io.writeLong(UniqueId::ts(uniqueId));
+    io.writeLong(timestamp);
     io.writeLong(seqNo);
     io.writeLong(m_partitionId);
     io.writeLong(m_siteId);
-    // use 1 for INSERT EXPORT op, 0 for DELETE EXPORT op
-    io.writeByte(static_cast<int8_t>((type == INSERT) ? 1L : 0L));
+    io.writeByte(operation);
     // write the tuple's data
     tuple.serializeToExport(io, METADATA_COL_CNT, nullArray);
 
     // row size, generation, partition-index, column count and hasSchema flag (byte)
-    ExportSerializeOutput hdr(m_currBlock->mutableDataPtr(), streamHeaderSz);
+    ExportSerializeOutput hdr(dest, streamHeaderSz);
     // write the row size in to the row header rowlength does not include
     // the 4 byte row header but does include the null array.
     hdr.writeInt((int32_t)(io.position()) + (int32_t)streamHeaderSz - 4);
     hdr.writeInt(METADATA_COL_CNT + partitionColumn);           // partition index
     hdr.writeInt(METADATA_COL_CNT + tuple.columnCount());      // column count
 
+    return streamHeaderSz + io.position();
+}
+
+/*
+ * If SpHandle represents a new transaction, commit previous data.
+ * Always serialize the supplied tuple in to the stream.
+ * Return m_uso before this invocation - this marks the point
+ * in the stream the caller can rollback to if this append
+ * should be rolled back.
+ */
+size_t ExportTupleStream::appendTuple(
+        VoltDBEngine* engine,
+        int64_t spHandle,
+        int64_t seqNo,
+        int64_t uniqueId,
+        const TableTuple &tuple,
+        int partitionColumn,
+        ExportTupleStream::Type type)
+{
+    assert(m_columnNames.size() == tuple.columnCount());
+    size_t streamHeaderSz = 0;
+    size_t tupleMaxLength = 0;
+
+    openTransaction(spHandle, uniqueId);
+
+    // Compute the upper bound on bytes required to serialize tuple.
+    tupleMaxLength = computeOffsets(tuple, &streamHeaderSz);
+    //First time always include schema.
+    if (!m_currBlock) {
+        extendBufferChain(m_defaultCapacity);
+    }
+    if ((m_currBlock->remaining() < tupleMaxLength)) {
+        //If we can not fit the data get a new block with size that includes schemaSize as well.
+        extendBufferChain(tupleMaxLength);
+    }
+
+    // use 1 for INSERT EXPORT op, 0 for DELETE EXPORT op
+    size_t rowLength = serializeRow(m_currBlock->mutableDataPtr(), m_currBlock->remaining(), streamHeaderSz,
+                                    spHandle, UniqueId::ts(uniqueId), seqNo,
+                                    static_cast<int8_t>((type == INSERT) ? 1L : 0L),
+                                    tuple, partitionColumn);
+
     // update m_offset
-    m_currBlock->consumed(streamHeaderSz + io.position());
+    m_currBlock->consumed(rowLength);
 
     // update uso.
     const size_t startingUso = m_uso;
-    m_uso += (streamHeaderSz + io.position());
+    m_uso += rowLength;
     assert(seqNo > 0 && m_nextSequenceNumber == seqNo);
     m_nextSequenceNumber++;
     m_currBlock->recordCompletedSpTxn(uniqueId);
-//    cout << "Appending row " << streamHeaderSz + io.position() << " to uso " << m_currBlock->uso()
+//    cout << "Appending row " << rowLength << " to uso " << m_currBlock->uso()
 //            << " sequence number " << seqNo
 //            << " offset " << m_currBlock->offset() << std::endl;
     return startingUso;
 }
 
+/*
+ * Batched form of appendTuple for multi-row statements.  The per-row
+ * bookkeeping (transaction check, block space check, metadata values)
+ * is done once per batch or once per block instead of once per row.
+ */
+size_t ExportTupleStream::appendTuples(
+        VoltDBEngine* engine,
+        int64_t spHandle,
+        int64_t firstSeqNo,
+        int64_t uniqueId,
+        const std::vector<TableTuple> &tuples,
+        int partitionColumn,
+        ExportTupleStream::Type type)
+{
+    assert(!tuples.empty());
+    assert(m_columnNames.size() == tuples[0].columnCount());
+    assert(firstSeqNo > 0 && m_nextSequenceNumber == firstSeqNo);
+
+    openTransaction(spHandle, uniqueId);
+
+    // Every row has the same schema, so the row header size and the
+    // metadata column values are computed once for the batch.
+    const size_t streamHeaderSz = rowHeaderSize(tuples[0].columnCount() + METADATA_COL_CNT);
+    const int64_t timestamp = UniqueId::ts(uniqueId);
+    const int8_t operation = static_cast<int8_t>((type == INSERT) ? 1L : 0L);
+
+    const size_t rowCount = tuples.size();
+    m_batchRowLengths.resize(rowCount);
+    for (size_t i = 0; i < rowCount; ++i) {
+        // returns 0 if corrupt tuple detected
+        size_t dataSz = tuples[i].maxExportSerializationSize();
+        if (dataSz == 0) {
+            throwFatalException("Invalid tuple passed to appendTuples. Crashing System.");
+        }
+        m_batchRowLengths[i] = streamHeaderSz + METADATA_DATA_SIZE + dataSz;
+    }
+
+    if (!m_currBlock) {
+        extendBufferChain(m_defaultCapacity);
+    }
+
+    const size_t startingUso = m_uso;
+    size_t next = 0;
+    while (next < rowCount) {
+        if (m_currBlock->remaining() < m_batchRowLengths[next]) {
+            extendBufferChain(m_batchRowLengths[next]);
+        }
+        // Claim the longest run of rows that is sure to fit in this block
+        size_t available = m_currBlock->remaining();
+        size_t reserved = m_batchRowLengths[next];
+        size_t end = next + 1;
+        while (end < rowCount && reserved + m_batchRowLengths[end] <= available) {
+            reserved += m_batchRowLengths[end];
+            ++end;
+        }
+
+        char *blockStart = m_currBlock->mutableDataPtr();
+        char *position = blockStart;
+        for (size_t i = next; i < end; ++i) {
+            position += serializeRow(position, available - (position - blockStart), streamHeaderSz,
+                                     spHandle, timestamp, firstSeqNo + i, operation,
+                                     tuples[i], partitionColumn);
+        }
+        size_t written = position - blockStart;
+        m_currBlock->consumedRows(written, end - next);
+        // Stamp every block the batch touches, as appendTuple does, before
+        // a later run of rows seals it
+        m_currBlock->recordCompletedSpTxn(uniqueId);
+        m_uso += written;
+        m_nextSequenceNumber += end - next;
+        next = end;
+    }
+    return startingUso;
+}
+
 void ExportTupleStream::appendToList(ExportTupleStream** oldest, ExportTupleStream** newest)
 {
     assert(!m_prevFlushStream && !m_nextFlushStream);
@@ -258,15 +350,8 @@ void ExportTupleStream::commit(VoltDBEngine* engine, int64_t currentSpHandle, in
 
 size_t
 ExportTupleStream::computeOffsets(const TableTuple &tuple, size_t *streamHeaderSz) const {
-    // round-up columncount to next multiple of 8 and divide by 8
-    int columnCount = tuple.columnCount() + METADATA_COL_CNT;
-    int nullMaskLength = ((columnCount + 7) & -8) >> 3;
-
     // tuple stream header
-    *streamHeaderSz = sizeof (int32_t)      // row size
-            + sizeof (int32_t)           // partition index
-            + sizeof (int32_t)           // column count
-            + nullMaskLength;           // null array
+    *streamHeaderSz = rowHeaderSize(tuple.columnCount() + METADATA_COL_CNT);
 
     // returns 0 if corrupt tuple detected
     size_t dataSz = tuple.maxExportSerializationSize();
@@ -274,7 +359,7 @@ ExportTupleStream::computeOffsets(const TableTuple &tuple, size_t *streamHeaderS
         throwFatalException("Invalid tuple passed to computeTupleMaxLength. Crashing System.");
     }
     //Data size for metadata columns.
-    dataSz += (5 * sizeof(int64_t)) + 1;
+    dataSz += METADATA_DATA_SIZE;
 
     return *streamHeaderSz              // row header
             + dataSz;                   // non-null tuple data
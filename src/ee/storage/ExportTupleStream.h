@@ -23,6 +23,7 @@
 #include "common/FatalException.hpp"
 #include "storage/TupleStreamBase.h"
 #include <deque>
+#include <vector>
 #include <cassert>
 namespace voltdb {
 
@@ -95,6 +96,21 @@ public:
             int partitionColumn,
             ExportTupleStream::Type type);
 
+    /**
+     * Write a batch of tuples sharing one schema to the stream, numbering
+     * them consecutively from firstSeqNo.  All the rows are sized up front
+     * and space is claimed a block at a time rather than row by row.
+     * Return m_uso before the batch, the mark the whole batch rolls back to.
+     */
+    size_t appendTuples(
+            VoltDBEngine* engine,
+            int64_t spHandle,
+            int64_t firstSeqNo,
+            int64_t uniqueId,
+            const std::vector<TableTuple> &tuples,
+            int partitionColumn,
+            ExportTupleStream::Type type);
+
     /** Close Txn and send full buffers with committed data to the top end. */
     void commit(VoltDBEngine* engine, int64_t spHandle, int64_t uniqueId);
     inline void rollbackExportTo(size_t mark, int64_t seqNo) {
@@ -145,6 +161,23 @@ public:
     static const size_t s_EXPORT_BUFFER_HEADER_SIZE;
 
 private:
+    void openTransaction(int64_t spHandle, int64_t uniqueId);
+
+    /** Size of the row header (length, partition index, column count and null mask) */
+    static size_t rowHeaderSize(int columnCount) {
+        // round-up columncount to next multiple of 8 and divide by 8
+        int nullMaskLength = ((columnCount + 7) & -8) >> 3;
+        return sizeof (int32_t)         // row size
+                + sizeof (int32_t)      // partition index
+                + sizeof (int32_t)      // column count
+                + nullMaskLength;       // null array
+    }
+
+    /** Serialize one row with its metadata columns at dest, returning the bytes written */
+    size_t serializeRow(char *dest, size_t capacity, size_t streamHeaderSz,
+                        int64_t spHandle, int64_t timestamp, int64_t seqNo, int8_t operation,
+                        const TableTuple &tuple, int partitionColumn);
+
     // cached catalog values
     const CatalogId m_partitionId;
     const int64_t m_siteId;
@@ -157,6 +190,9 @@ private:
     int64_t m_nextSequenceNumber;
     int64_t m_committedSequenceNumber;
 
+    // Upper bound on the serialized size of each row of the batch being appended
+    std::vector<size_t> m_batchRowLengths;
+
     // Used to track what streams have partial blocks that could be flushed
     bool m_flushPending;
     ExportTupleStream* m_nextFlushStream;
@@ -166,6 +202,8 @@ private:
     static const uint8_t s_EXPORT_BUFFER_VERSION;
     // meta-data column count
     static const int METADATA_COL_CNT = 6;
+    // serialized size of the meta-data columns: five longs and the operation byte
+    static const size_t METADATA_DATA_SIZE = (5 * sizeof(int64_t)) + 1;
 
     // column names of meta data columns
     static const std::string VOLT_TRANSACTION_ID;
@@ -24,7 +24,9 @@
 namespace voltdb {
 
 PersistentTableStats::PersistentTableStats(voltdb::PersistentTable* table)
-  : voltdb::TableStats(table)
+  : voltdb::TableStats(table),
+    m_compactedTuples(0), m_compactedBlocks(0), m_compactedBytes(0),
+    m_incrementalCompactionSteps(0)
 {
 }
 
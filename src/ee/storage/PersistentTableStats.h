@@ -26,13 +26,40 @@ namespace voltdb {
 class PersistentTable;
 
 /**
- * Further specialization of TableStats that currently adds no extra functionality.
+ * Further specialization of TableStats that also keeps the block compaction
+ * counters of a persistent table.  The TABLE statistics schema is shared
+ * with streamed tables, so the counters are not added as columns here; they
+ * are summed per site by the CompactionScheduler and reported by CompactionStats.
  */
 class PersistentTableStats : public voltdb::TableStats {
   public:
     PersistentTableStats(voltdb::PersistentTable* table);
+
+    void recordCompaction(int64_t tuplesMoved, int64_t blocksReclaimed, int64_t bytesReclaimed) {
+        m_compactedTuples += tuplesMoved;
+        m_compactedBlocks += blocksReclaimed;
+        m_compactedBytes += bytesReclaimed;
+    }
+
+    void recordIncrementalCompactionStep() {
+        m_incrementalCompactionSteps++;
+    }
+
+    /** Tuples moved from sparse blocks into fuller ones. */
+    int64_t getCompactedTuples() const { return m_compactedTuples; }
+    /** Blocks emptied by compaction and returned to the allocator. */
+    int64_t getCompactedBlocks() const { return m_compactedBlocks; }
+    int64_t getCompactedBytes() const { return m_compactedBytes; }
+    int64_t getIncrementalCompactionSteps() const { return m_incrementalCompactionSteps; }
+
   protected:
     virtual std::vector<std::string> generateStatsColumnNames();
+
+  private:
+    int64_t m_compactedTuples;
+    int64_t m_compactedBlocks;
+    int64_t m_compactedBytes;
+    int64_t m_incrementalCompactionSteps;
 };
 
 }
@@ -45,6 +45,12 @@ public:
     void reduceAllocated(int bytes);
 
     int64_t getAllocated() const { return m_currMemoryInBytes; }
+    int64_t getMemoryLimit() const { return m_memoryLimit; }
+
+    /** True if allocating this many more bytes would not exceed the memory limit. */
+    bool hasRoomFor(int64_t bytes) const {
+        return m_memoryLimit <= 0 || m_currMemoryInBytes + bytes <= m_memoryLimit;
+    }
     int64_t getPeakMemoryInBytes() const { return m_peakMemoryInBytes; }
     void resetPeakMemory() { m_peakMemoryInBytes = m_currMemoryInBytes; }
 
@@ -18,6 +18,7 @@
 #include "storage/table.h"
 #include <sys/mman.h>
 #include <errno.h>
+#include "common/HugePageAllocator.h"
 #include "common/ThreadLocalPool.h"
 
 namespace voltdb {
@@ -26,6 +27,7 @@ volatile int tupleBlocksAllocated = 0;
 
 TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_storage(NULL),
+        m_mappedSize(0),
         m_references(0),
         m_tupleLength(table->m_tupleLength),
         m_tuplesPerBlock(table->m_tuplesPerBlock),
@@ -43,7 +45,7 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         throwFatalException("Failed mmap");
     }
 #else
-    m_storage = new char[table->m_tableAllocationSize];
+    m_storage = HugePageAllocator::allocate(table->m_tableAllocationSize, m_mappedSize);
 #endif
     tupleBlocksAllocated++;
 }
@@ -56,11 +58,12 @@ TupleBlock::~TupleBlock() {
         throwFatalException("Failed munmap");
     }
 #else
-    delete []m_storage;
+    HugePageAllocator::release(m_storage, m_mappedSize);
 #endif
 }
 
-std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener) {
+std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener,
+                                      uint32_t maxTuples) {
     assert(source != this);
     /*
       std::cout << "Attempting to merge " << static_cast<void*> (this)
@@ -72,7 +75,8 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
 
     uint32_t nextTupleInSourceOffset = source->lastCompactionOffset();
     int sourceTuplesPendingDeleteOnUndoRelease = 0;
-    while (hasFreeTuples() && !source->isEmpty()) {
+    uint32_t movedTuples = 0;
+    while (hasFreeTuples() && !source->isEmpty() && movedTuples < maxTuples) {
         TableTuple sourceTupleWithNewValues(table->schema());
         TableTuple destinationTuple(table->schema());
 
@@ -116,6 +120,7 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
         }
 
         source->freeTuple(sourceTupleWithNewValues.address());
+        movedTuples++;
     }
     source->lastCompactionOffset(nextTupleInSourceOffset);
 
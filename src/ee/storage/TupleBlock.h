@@ -168,9 +168,10 @@ public:
         return m_bucketIndex;
     }
 
-    /** Merge this block with the given block. Returns the new bucket
-        index for this and the other block. */
-    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL);
+    /** Merge this block with the given block, moving at most maxTuples
+        tuples. Returns the new bucket index for this and the other block. */
+    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL,
+                              uint32_t maxTuples = UINT32_MAX);
 
     /**
      * Find next free tuple storage address and its tupleblock's bucket index,
@@ -286,6 +287,8 @@ public:
     }
 private:
     char*   m_storage;
+    // Length of the huge page mapping backing m_storage, 0 if it is on the heap.
+    size_t  m_mappedSize;
     std::atomic<uint32_t> m_references;
     uint32_t m_tupleLength;
     uint32_t m_tuplesPerBlock;
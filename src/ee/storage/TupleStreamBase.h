@@ -30,6 +30,7 @@
 #include "common/tabletuple.h"
 #include "common/ExportSerializeIo.h"
 #include "common/StreamBlock.h"
+#include "common/StreamBufferPool.h"
 #include "storage/TupleStreamException.h"
 
 #include <cstdio>
@@ -283,7 +284,7 @@ template <class SB>
 void TupleStreamBase<SB>::discardBlock(SB *sb)
 {
     if (sb != NULL) {
-        delete [] sb->rawPtr();
+        StreamBufferPool::release(sb->rawPtr());
         delete sb;
     }
 }
@@ -317,7 +318,8 @@ void TupleStreamBase<SB>::commonExtendBufferChain(size_t blockSize, size_t start
         throw TupleStreamException(SQLException::volt_output_buffer_overflow, "Transaction is bigger than DR Buffer size");
     }
 
-    char *buffer = new char[blockSize];
+    ExecutorContext *context = ExecutorContext::getExecutorContext();
+    char *buffer = (context != NULL) ? context->getStreamBufferPool().acquire(blockSize) : new char[blockSize];
     if (!buffer) {
         throwFatalException("Failed to claim managed buffer for Export.");
     }
@@ -68,6 +68,8 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <algorithm>
+
 namespace voltdb {
 
 #define TABLE_BLOCKSIZE 2097152
@@ -118,6 +120,7 @@ PersistentTable::PersistentTable(int partitionColumn,
     , m_blocksWithSpace()
     , m_tableStreamer()
     , m_failedCompactionCount(0)
+    , m_contentDigest(0)
     , m_invisibleTuplesPendingDeleteCount(0)
     , m_surgeon(*this)
     , m_tableForStreamIndexing(NULL)
@@ -807,6 +810,72 @@ void PersistentTable::insertPersistentTuple(TableTuple& source, bool fallible, b
     }
 }
 
+namespace {
+// Spread a tuple hash over all 64 bits (the MurmurHash3 finalizer) so that
+// summing the hashes of many tuples does not cancel structure out.
+inline size_t tupleDigest(const TableTuple& tuple) {
+    uint64_t h = tuple.hashCode();
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+// Orders tuples by the values of a set of key columns.
+struct KeyColumnsLess {
+    KeyColumnsLess(const std::vector<int>& columns) : m_columns(columns) {}
+
+    int compare(const TableTuple& a, const TableTuple& b) const {
+        BOOST_FOREACH (int column, m_columns) {
+            int cmp = a.getNValue(column).compare(b.getNValue(column));
+            if (cmp != VALUE_COMPARE_EQUAL) {
+                return cmp;
+            }
+        }
+        return VALUE_COMPARE_EQUAL;
+    }
+
+    bool operator()(const TableTuple& a, const TableTuple& b) const {
+        return compare(a, b) == VALUE_COMPARE_LESSTHAN;
+    }
+
+    bool hasNull(const TableTuple& tuple) const {
+        BOOST_FOREACH (int column, m_columns) {
+            if (tuple.getNValue(column).isNull()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::vector<int>& m_columns;
+};
+}
+
+void PersistentTable::insertPersistentTuples(std::vector<TableTuple>& sources) {
+    // Only a primary key on plain columns gives a sort key that can be
+    // computed from the source tuples without evaluating expressions.
+    // Rows of a DR'd table are streamed per row as they are inserted, so
+    // they keep statement order to leave the DR stream unchanged.
+    if (sources.size() > 1 && m_pkeyIndex != NULL &&
+            m_pkeyIndex->getIndexedExpressions().empty() && ! m_pkeyIndex->isPartialIndex() &&
+            ! doDRActions(getDRTupleStream(ExecutorContext::getExecutorContext()))) {
+        KeyColumnsLess keyLess(m_pkeyIndex->getColumnIndices());
+        std::stable_sort(sources.begin(), sources.end(), keyLess);
+        for (size_t ii = 1; ii < sources.size(); ++ii) {
+            if (keyLess.compare(sources[ii - 1], sources[ii]) == VALUE_COMPARE_EQUAL &&
+                    ! keyLess.hasNull(sources[ii])) {
+                throw ConstraintFailureException(this, sources[ii], sources[ii - 1], CONSTRAINT_TYPE_UNIQUE);
+            }
+        }
+    }
+    BOOST_FOREACH (TableTuple& source, sources) {
+        insertPersistentTuple(source, true);
+    }
+}
+
 void PersistentTable::doInsertTupleCommon(TableTuple& source, TableTuple& target,
                                         bool fallible, bool shouldDRStream, bool delayTupleDelete) {
     if (fallible) {
@@ -887,6 +956,9 @@ void PersistentTable::doInsertTupleCommon(TableTuple& source, TableTuple& target
             SynchronizedThreadLock::addUndoAction(isReplicatedTable(), uq, undoAction);
         }
     }
+    // Count the tuple together with its undo action, which takes it back out
+    // of the digest if a view handler or the delta table fails later on.
+    m_contentDigest += tupleDigest(target);
 
     // Insert the tuple into the delta table first.
     //
@@ -938,6 +1010,7 @@ void PersistentTable::insertTupleForUndo(char* tuple) {
                             " unique constraint violation\n%s\n", m_name.c_str(),
                             target.debugNoHeader().c_str());
     }
+    m_contentDigest += tupleDigest(target);
 }
 
 /*
@@ -1083,7 +1156,9 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
     std::vector<char*> newObjects;
 
     // this is the actual write of the new values
+    m_contentDigest -= tupleDigest(targetTupleToUpdate);
     targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects);
+    m_contentDigest += tupleDigest(targetTupleToUpdate);
 
     if (uq) {
         /*
@@ -1173,7 +1248,9 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
 
     bool dirty = targetTupleToUpdate.isDirty();
     // this is the actual in-place revert to the old version
+    m_contentDigest -= tupleDigest(targetTupleToUpdate);
     targetTupleToUpdate.copy(sourceTupleWithNewValues);
+    m_contentDigest += tupleDigest(targetTupleToUpdate);
     if (dirty) {
         targetTupleToUpdate.setDirtyTrue();
     }
@@ -1222,6 +1299,7 @@ void PersistentTable::deleteTuple(TableTuple& target, bool fallible) {
 
     // Just like insert, we want to remove this tuple from all of our indexes
     deleteFromAllIndexes(&target);
+    m_contentDigest -= tupleDigest(target);
 
     if (createUndoAction) {
         target.setPendingDeleteOnUndoReleaseTrue();
@@ -1358,6 +1436,7 @@ void PersistentTable::deleteTupleForUndo(char* tupleData, bool skipLookup) {
     assert(target.isActive());
 
     deleteFromAllIndexes(&target);
+    m_contentDigest -= tupleDigest(target);
     deleteTupleFinalize(target); // also frees object columns
 }
 
@@ -1793,26 +1872,16 @@ void PersistentTable::processRecoveryMessage(RecoveryProtoMsg* message, Pool* po
  * Create a tree index on the primary key and then iterate it and hash
  * the tuple data.
  */
-size_t PersistentTable::hashCode() {
-    boost::scoped_ptr<TableIndex> pkeyIndex(TableIndexFactory::cloneEmptyTreeIndex(*m_pkeyIndex));
+size_t PersistentTable::recomputeHashCode() {
+    // The iterator skips tuples pending delete, which have already been
+    // taken out of the digest.
     TableIterator iter(this, m_data.begin());
     TableTuple tuple(schema());
+    size_t digest = 0;
     while (iter.next(tuple)) {
-        pkeyIndex->addEntry(&tuple, NULL);
-    }
-
-    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
-    pkeyIndex->moveToEnd(true, indexCursor);
-
-    size_t hashCode = 0;
-    while (true) {
-         tuple = pkeyIndex->nextValue(indexCursor);
-         if (tuple.isNullTuple()) {
-             break;
-         }
-         tuple.hashCode(hashCode);
+        digest += tupleDigest(tuple);
     }
-    return hashCode;
+    return digest;
 }
 
 void PersistentTable::notifyBlockWasCompactedAway(TBPtr block) {
@@ -1867,7 +1936,7 @@ void PersistentTable::swapTuples(TableTuple& originalTuple,
     }
 }
 
-bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector) {
+bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector, int32_t* tupleBudget) {
     /**
      * First find the two best candidate blocks
      */
@@ -1888,7 +1957,10 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
     }
 
     int fullestBucketChange = NO_NEW_BUCKET_INDEX;
-    while (fullest->hasFreeTuples()) {
+    uint32_t fullestTuplesBefore = fullest->activeTuples();
+    int64_t blocksReclaimed = 0;
+    bool foundWork = true;
+    while (fullest->hasFreeTuples() && (tupleBudget == NULL || *tupleBudget > 0)) {
         TBPtr lightest;
         TBBucketI lightestIterator;
         bool foundLightest = false;
@@ -1912,10 +1984,19 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
         }
         if (!foundLightest) {
             //could not find a lightest block for compaction
-            return false;
+            foundWork = false;
+            break;
         }
 
-        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this);
+        uint32_t maxTuples = UINT32_MAX;
+        uint32_t tuplesBeforeMerge = fullest->activeTuples();
+        if (tupleBudget != NULL) {
+            maxTuples = static_cast<uint32_t>(*tupleBudget);
+        }
+        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this, maxTuples);
+        if (tupleBudget != NULL) {
+            *tupleBudget -= static_cast<int32_t>(fullest->activeTuples() - tuplesBeforeMerge);
+        }
         int tempFullestBucketChange = bucketChanges.first;
         if (tempFullestBucketChange != NO_NEW_BUCKET_INDEX) {
             fullestBucketChange = tempFullestBucketChange;
@@ -1928,6 +2009,7 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
             m_blocksNotPendingSnapshot.erase(lightest);
             m_blocksPendingSnapshot.erase(lightest);
             lightest->swapToBucket(TBBucketPtr());
+            blocksReclaimed++;
         }
         else {
             int lightestBucketChange = bucketChanges.second;
@@ -1943,7 +2025,9 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
     if (!fullest->hasFreeTuples()) {
         m_blocksWithSpace.erase(fullest);
     }
-    return true;
+    m_stats.recordCompaction(fullest->activeTuples() - fullestTuplesBefore, blocksReclaimed,
+                             blocksReclaimed * m_tableAllocationSize);
+    return foundWork;
 }
 
 void PersistentTable::doIdleCompaction() {
@@ -1955,6 +2039,30 @@ void PersistentTable::doIdleCompaction() {
     }
 }
 
+int32_t PersistentTable::doIncrementalCompaction(int32_t maxTuples) {
+    if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
+        return 0;
+    }
+    int32_t tupleBudget = maxTuples;
+    while (tupleBudget > 0 && compactionPredicate()) {
+        int32_t budgetBefore = tupleBudget;
+        if (!m_blocksNotPendingSnapshot.empty()) {
+            doCompactionWithinSubset(&m_blocksNotPendingSnapshotLoad, &tupleBudget);
+        }
+        if (tupleBudget > 0 && !m_blocksPendingSnapshot.empty()) {
+            doCompactionWithinSubset(&m_blocksPendingSnapshotLoad, &tupleBudget);
+        }
+        if (tupleBudget == budgetBefore) {
+            // Nothing in the load buckets could be merged; see doForcedCompaction().
+            break;
+        }
+    }
+    if (tupleBudget != maxTuples) {
+        m_stats.recordIncrementalCompactionStep();
+    }
+    return maxTuples - tupleBudget;
+}
+
 bool PersistentTable::doForcedCompaction() {
     if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
         LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO,
@@ -2089,21 +2197,34 @@ int64_t PersistentTable::validatePartitioning(TheHashinator* hashinator, int32_t
 
     int64_t mispartitionedRows = 0;
 
+    // Hashinate the partition keys a batch of rows at a time
+    const int32_t batchSize = 256;
+    std::vector<TableTuple> tuples(batchSize, TableTuple(schema()));
+    std::vector<NValue> keys(batchSize);
+    std::vector<int32_t> partitions(batchSize);
+
     while (iter.hasNext()) {
-        TableTuple tuple(schema());
-        iter.next(tuple);
-        int32_t newPartitionId = hashinator->hashinate(tuple.getNValue(m_partitionColumn));
-        if (newPartitionId != partitionId) {
-            std::ostringstream buffer;
-            buffer << "@ValidPartitioning found a mispartitioned row (hash: "
-                    << m_surgeon.generateTupleHash(tuple)
-                    << " should in "<< partitionId
-                    << ", but in " << newPartitionId << "):\n"
-                    << tuple.debug(name())
-                    << std::endl;
-            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
-                    buffer.str().c_str());
-            mispartitionedRows++;
+        int32_t count = 0;
+        while (count < batchSize && iter.next(tuples[count])) {
+            keys[count] = tuples[count].getNValue(m_partitionColumn);
+            count++;
+        }
+        hashinator->hashinateBatch(&keys[0], count, &partitions[0]);
+        for (int32_t i = 0; i < count; i++) {
+            TableTuple &tuple = tuples[i];
+            int32_t newPartitionId = partitions[i];
+            if (newPartitionId != partitionId) {
+                std::ostringstream buffer;
+                buffer << "@ValidPartitioning found a mispartitioned row (hash: "
+                        << m_surgeon.generateTupleHash(tuple)
+                        << " should in "<< partitionId
+                        << ", but in " << newPartitionId << "):\n"
+                        << tuple.debug(name())
+                        << std::endl;
+                LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
+                        buffer.str().c_str());
+                mispartitionedRows++;
+            }
         }
     }
     if (mispartitionedRows > 0) {
@@ -73,6 +73,7 @@
 
 class CompactionTest_BasicCompaction;
 class CompactionTest_CompactionWithCopyOnWrite;
+class CompactionTest_IncrementalCompactionWithinBudget;
 class CopyOnWriteTest;
 
 namespace catalog {
@@ -131,6 +132,7 @@ public:
     void setIndexingComplete();
     bool indexHas(TableTuple& tuple) const;
     bool indexAdd(TableTuple& tuple);
+    void indexAddAll(std::vector<ElasticIndexKey>& keys);
     bool indexRemove(TableTuple& tuple);
     void initTableStreamer(TableStreamerInterface* streamer);
     bool hasStreamType(TableStreamType streamType) const;
@@ -207,6 +209,7 @@ class PersistentTable : public Table, public UndoQuantumReleaseInterest,
     friend class ::CopyOnWriteTest;
     friend class ::CompactionTest_BasicCompaction;
     friend class ::CompactionTest_CompactionWithCopyOnWrite;
+    friend class ::CompactionTest_IncrementalCompactionWithinBudget;
     friend class CoveringCellIndexTest_TableCompaction;
     friend class MaterializedViewHandler;
     friend class ScopedDeltaTableContext;
@@ -329,6 +332,18 @@ public:
 
     void insertPersistentTuple(TableTuple& source, bool fallible, bool ignoreTupleLimit = false);
 
+    /**
+     * Insert a batch of tuples with the same effect as calling insertTuple()
+     * on each of them.  The batch is first sorted by primary key, so that
+     * index maintenance walks each tree in key order, and rows that repeat
+     * a primary key within the batch fail the whole batch before any of it
+     * is inserted.  The order of the sources vector is not preserved.
+     * Only index insertion benefits: DR, undo and view maintenance still
+     * run per row, and a table with an active DR stream is not sorted so
+     * that its DR records keep statement order.
+     */
+    void insertPersistentTuples(std::vector<TableTuple>& sources);
+
     /// This is not used in any production code path -- it is a convenient wrapper used by tests.
     bool updateTuple(TableTuple& targetTupleToUpdate, TableTuple& sourceTupleWithNewValues) {
         updateTupleWithSpecificIndexes(targetTupleToUpdate, sourceTupleWithNewValues, m_indexes, true);
@@ -417,10 +432,20 @@ public:
     void processRecoveryMessage(RecoveryProtoMsg* message, Pool* pool);
 
     /**
-     * Create a tree index on the primary key and then iterate it and hash
-     * the tuple data.
+     * Order independent digest of the visible tuples, used to compare
+     * replicas.  It is the sum of a mixed hash of every tuple and is kept
+     * up to date by insert, update, delete and their undo, so reading it
+     * is O(1).
+     */
+    size_t hashCode() const {
+        return m_contentDigest;
+    }
+
+    /**
+     * Compute the same digest from scratch by scanning the blocks.
+     * Allocates nothing; used to verify the maintained value.
      */
-    size_t hashCode();
+    size_t recomputeHashCode();
 
     size_t getBlocksNotPendingSnapshotCount() {
         return m_blocksNotPendingSnapshot.size();
@@ -428,6 +453,15 @@ public:
 
     void doIdleCompaction();
 
+    /**
+     * Merge the sparsest blocks into fuller ones, moving at most maxTuples
+     * tuples.  Does nothing unless the compaction predicate holds.
+     * Returns the number of tuples moved.
+     */
+    int32_t doIncrementalCompaction(int32_t maxTuples);
+
+    PersistentTableStats* getPersistentTableStats() { return &m_stats; }
+
     void printBucketInfo();
 
     void increaseStringMemCount(size_t bytes) {
@@ -621,7 +655,9 @@ private:
 
     void nextFreeTuple(TableTuple* tuple);
 
-    bool doCompactionWithinSubset(TBBucketPtrVector* bucketVector);
+    // When tupleBudget is given, stop after moving that many tuples and
+    // subtract the tuples moved from it.
+    bool doCompactionWithinSubset(TBBucketPtrVector* bucketVector, int32_t* tupleBudget = NULL);
 
     bool doForcedCompaction();  // Returns true if a compaction was performed
 
@@ -793,6 +829,9 @@ private:
 
     int m_failedCompactionCount;
 
+    // See hashCode().
+    size_t m_contentDigest;
+
     // This is a testability feature not intended for use in product logic.
     int m_invisibleTuplesPendingDeleteCount;
 
@@ -964,6 +1003,11 @@ inline bool PersistentTableSurgeon::indexAdd(TableTuple& tuple) {
     return m_index->add(m_table, tuple);
 }
 
+inline void PersistentTableSurgeon::indexAddAll(std::vector<ElasticIndexKey>& keys) {
+    assert (m_index != NULL);
+    m_index->addAll(keys);
+}
+
 inline bool PersistentTableSurgeon::indexRemove(TableTuple& tuple) {
     assert (m_index != NULL);
     return m_index->remove(m_table, tuple);
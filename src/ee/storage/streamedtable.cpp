@@ -177,6 +177,45 @@ bool StreamedTable::insertTuple(TableTuple &source)
     return true;
 }
 
+void StreamedTable::insertTuples(std::vector<TableTuple> &sources)
+{
+    if (sources.empty()) {
+        return;
+    }
+    // not null checks at first
+    BOOST_FOREACH (TableTuple &source, sources) {
+        FAIL_IF(!checkNulls(source)) {
+            throw ConstraintFailureException(this, source, TableTuple(), CONSTRAINT_TYPE_NOT_NULL);
+        }
+    }
+
+    // handle any materialized views
+    BOOST_FOREACH (const TableTuple &source, sources) {
+        for (int i = 0; i < m_views.size(); i++) {
+            m_views[i]->processTupleInsert(source, true);
+        }
+    }
+
+    if (m_wrapper) {
+        int64_t firstSequenceNo = m_sequenceNo + 1;
+        size_t mark = m_wrapper->appendTuples(m_executorContext->getContextEngine(),
+                                              m_executorContext->currentSpHandle(),
+                                              firstSequenceNo,
+                                              m_executorContext->currentUniqueId(),
+                                              sources,
+                                              partitionColumn(),
+                                              ExportTupleStream::INSERT);
+        m_sequenceNo += sources.size();
+
+        UndoQuantum *uq = m_executorContext->getCurrentUndoQuantum();
+        if (!uq) {
+            // With no active UndoLog, there is no undo support.
+            return;
+        }
+        uq->registerUndoAction(new (*uq) StreamedTableUndoAction(this, mark, firstSequenceNo), this);
+    }
+}
+
 void StreamedTable::loadTuplesFrom(SerializeInputBE&, Pool*) {
     throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
                                   "May not update a streamed table.");
@@ -200,12 +239,14 @@ void StreamedTable::setSignatureAndGeneration(std::string signature, int64_t gen
 
 void StreamedTable::undo(size_t mark, int64_t seqNo) {
     if (m_wrapper) {
-        assert(seqNo == m_sequenceNo);
+        // seqNo is the first sequence number of the rows being undone,
+        // which is the last one for a single row insert.
+        assert(seqNo > 0 && seqNo <= m_sequenceNo);
         m_wrapper->rollbackExportTo(mark, seqNo);
         //Decrementing the sequence number should make the stream of tuples
         //contiguous outside of actual system failures. Should be more useful
         //than having gaps.
-        m_sequenceNo--;
+        m_sequenceNo = seqNo - 1;
     }
 }
 
@@ -70,6 +70,13 @@ public:
     // TODO: change meaningless bool return type to void (starting in class Table) and migrate callers.
     virtual bool insertTuple(TableTuple &tuple);
 
+    /**
+     * Insert a batch of tuples with the same effect as calling insertTuple()
+     * on each of them in order, but appending them to the export stream in
+     * one call and registering a single undo action for the batch.
+     */
+    void insertTuples(std::vector<TableTuple> &sources);
+
     virtual void loadTuplesFrom(SerializeInputBE &serialize_in, Pool *stringPool = NULL);
     virtual void flushOldTuples(int64_t timeInMillis);
     void setSignatureAndGeneration(std::string signature, int64_t generation);
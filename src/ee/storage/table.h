@@ -77,6 +77,7 @@ const size_t COLUMN_DESCRIPTOR_SIZE = 1 + 4 + 4; // type, name offset, name leng
  */
 class Table {
     friend class TableFactory;
+    friend class CompactionScheduler;
     friend class TableIterator;
     friend class LargeTempTableIterator;
     friend class TableTupleFilter;
@@ -100,6 +100,13 @@ class TempTable : public AbstractTempTable {
 
     virtual void deleteAllTempTuples();
 
+    /**
+     * Empties the table but keeps its blocks, which are handed out again
+     * before any new block is allocated.  They stay charged to the temp
+     * table limits until deleteAllTempTuples() releases them.
+     */
+    virtual void deleteAllTempTuplesForReuse();
+
     /**
      * Uses the pool to do a deep copy of the tuple including allocations
      * for all uninlined columns. Used by CopyOnWriteContext to back up tuples
@@ -112,6 +119,13 @@ class TempTable : public AbstractTempTable {
      */
     virtual void insertTempTuple(TableTuple &source);
 
+    /**
+     * Same as insertTempTuple, returning the copy in this table.
+     * Tuples are never moved, so it stays valid until the table is
+     * emptied.
+     */
+    TableTuple appendTempTuple(const TableTuple &source);
+
     virtual void finishInserts() {}
 
     bool isTempTableEmpty() { return m_tupleCount == 0; }
@@ -159,14 +173,20 @@ class TempTable : public AbstractTempTable {
 
     virtual void onSetColumns() {
         m_data.clear();
+        releaseSpareBlocks();
     };
 
     std::vector<uint64_t> getBlockAddresses() const;
 
   private:
+    void releaseSpareBlocks();
+
     // pointers to chunks of data. Specific to table impl. Don't leak this type.
     std::vector<TBPtr> m_data;
 
+    // emptied blocks kept by deleteAllTempTuplesForReuse()
+    std::vector<TBPtr> m_spareBlocks;
+
     // ptr to global integer tracking temp table memory allocated per frag
     TempTableLimits* m_limits;
 };
@@ -190,6 +210,10 @@ inline void TempTable::insertTempTupleDeepCopy(const TableTuple &source, Pool *p
 }
 
 inline void TempTable::insertTempTuple(TableTuple &source) {
+    appendTempTuple(source);
+}
+
+inline TableTuple TempTable::appendTempTuple(const TableTuple &source) {
     //
     // First get the next free tuple
     // This will either give us one from the free slot list, or
@@ -210,9 +234,20 @@ inline void TempTable::insertTempTuple(TableTuple &source) {
     target.setPendingDeleteOnUndoReleaseFalse();
     target.setInlinedDataIsVolatileFalse();
     target.setNonInlinedDataIsVolatileFalse();
+    return target;
+}
+
+inline void TempTable::releaseSpareBlocks() {
+    // Spare blocks are still charged to the limits.
+    if (m_limits && ! m_spareBlocks.empty()) {
+        m_limits->reduceAllocated(m_tableAllocationSize * static_cast<int>(m_spareBlocks.size()));
+    }
+    m_spareBlocks.clear();
 }
 
 inline void TempTable::deleteAllTempTuples() {
+    releaseSpareBlocks();
+
     if (m_tupleCount == 0) {
         return;
     }
@@ -235,7 +270,26 @@ inline void TempTable::deleteAllTempTuples() {
     }
 }
 
+inline void TempTable::deleteAllTempTuplesForReuse() {
+    // Blocks already freed by a deleting iterator are null.
+    for (std::vector<TBPtr>::reverse_iterator it = m_data.rbegin(); it != m_data.rend(); ++it) {
+        if (*it) {
+            (*it)->reset();
+            m_spareBlocks.push_back(*it);
+        }
+    }
+    m_data.clear();
+    m_tupleCount = 0;
+}
+
 inline TBPtr TempTable::allocateNextBlock() {
+    if ( ! m_spareBlocks.empty()) {
+        TBPtr block = m_spareBlocks.back();
+        m_spareBlocks.pop_back();
+        m_data.push_back(block);
+        return block;
+    }
+
     TBPtr block(new TupleBlock(this, TBBucketPtr()));
     m_data.push_back(block);
 
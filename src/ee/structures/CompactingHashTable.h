@@ -23,6 +23,7 @@
 #include <cstdlib>
 #include <utility>
 #include <cassert>
+#include <algorithm>
 #include <climits>
 #include <iostream>
 #include <cstring>
@@ -162,6 +163,8 @@ namespace voltdb {
         iterator find(const Key &key) const;
         /** find an exact key/value match (optionaly searching by value first) */
         iterator find(const Key &key, const Data &value) const;
+        /** batched simple find, with the bucket loads of a group of keys issued before any chain is walked */
+        void find(const Key *keys, iterator *results, int count) const;
         /** simple insert */
         const Data *insert(const Key &key, const Data &value);
         /** delete by key (unique only) */
@@ -293,6 +296,30 @@ namespace voltdb {
         return iterator(foundNode);
     }
 
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::find(const Key *keys, iterator *results, int count) const {
+        const int GROUP_SIZE = 16;
+        uint64_t bucketOffsets[GROUP_SIZE];
+        for (int base = 0; base < count; base += GROUP_SIZE) {
+            int groupCount = std::min(GROUP_SIZE, count - base);
+            // hash the whole group and start loading its bucket slots
+            for (int i = 0; i < groupCount; ++i) {
+                bucketOffsets[i] = m_hasher(keys[base + i]) % TABLE_SIZES[m_sizeIndex];
+                __builtin_prefetch(&m_buckets[bucketOffsets[i]]);
+            }
+            // then the first node of each chain
+            for (int i = 0; i < groupCount; ++i) {
+                const HashNode *head = m_buckets[bucketOffsets[i]];
+                if (head) {
+                    __builtin_prefetch(head);
+                }
+            }
+            for (int i = 0; i < groupCount; ++i) {
+                results[base + i] = iterator(find(m_buckets[bucketOffsets[i]], keys[base + i]));
+            }
+        }
+    }
+
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key, const Data &value) const {
         uint64_t hash = m_hasher(key);
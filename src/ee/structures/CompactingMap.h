@@ -25,6 +25,8 @@
 #include <utility>
 #include <limits>
 #include <cassert>
+#include <algorithm>
+#include <vector>
 
 typedef u_int32_t NodeCount;
 
@@ -224,6 +226,14 @@ public:
 
     std::pair<iterator, iterator> equalRange(const Key &key) const;
 
+    // Batched forms of find/lowerBound/upperBound: each fills results[i]
+    // for keys[i]. The descents for a group of keys are stepped down the
+    // tree together, prefetching the next node of each, so the cache
+    // misses of the independent lookups overlap instead of serializing.
+    void find(const Key *keys, iterator *results, int count) const;
+    void lowerBound(const Key *keys, iterator *results, int count) const;
+    void upperBound(const Key *keys, iterator *results, int count) const;
+
     size_t bytesAllocated() const { return m_allocator.bytesAllocated(); }
 
     // Must pass a key that already in map, or else return -1
@@ -243,6 +253,7 @@ protected:
     void erase(TreeNode *z);
     TreeNode *lookup(const Key &key) const;
     TreeNode *lookupRank(int64_t ith) const;
+    void interleavedBound(const Key *keys, iterator *results, int count, bool upper) const;
 
     inline int64_t getSubct(const TreeNode* x) const;
     inline void incSubct(TreeNode* x);
@@ -429,6 +440,78 @@ CompactingMap<KeyValuePair, Compare, hasRank>::equalRange(const Key &key) const
     return std::pair<iterator, iterator>(lowerBound(key), upperBound(key));
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingMap<KeyValuePair, Compare, hasRank>::find(const Key *keys, iterator *results, int count) const
+{
+    lowerBound(keys, results, count);
+    for (int i = 0; i < count; ++i) {
+        if (!results[i].isEnd() && m_comper(results[i].key(), keys[i]) != 0) {
+            results[i] = iterator(this, const_cast<TreeNode*>(&NIL));
+        }
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingMap<KeyValuePair, Compare, hasRank>::lowerBound(const Key *keys, iterator *results, int count) const
+{
+    interleavedBound(keys, results, count, false);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingMap<KeyValuePair, Compare, hasRank>::upperBound(const Key *keys, iterator *results, int count) const
+{
+    std::vector<Key> tmpKeys(keys, keys + count);
+    for (int i = 0; i < count; ++i) {
+        setPointerValue(tmpKeys[i], MAXPOINTER);
+    }
+    interleavedBound(tmpKeys.data(), results, count, true);
+}
+
+/**
+ * Walk the lowerBound (or, with upper set, the upperBound) descent for
+ * up to GROUP_SIZE keys at a time, one tree level per pass, so that the
+ * prefetch of one key's next node is in flight while the others compare.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingMap<KeyValuePair, Compare, hasRank>::interleavedBound(const Key *keys, iterator *results,
+                                                                      int count, bool upper) const
+{
+    const int GROUP_SIZE = 16;
+    TreeNode *x[GROUP_SIZE];
+    TreeNode *y[GROUP_SIZE];
+    for (int base = 0; base < count; base += GROUP_SIZE) {
+        int groupCount = std::min(GROUP_SIZE, count - base);
+        for (int i = 0; i < groupCount; ++i) {
+            x[i] = m_root;
+            y[i] = const_cast<TreeNode*>(&NIL);
+        }
+        bool descending = (m_root != &NIL);
+        while (descending) {
+            descending = false;
+            for (int i = 0; i < groupCount; ++i) {
+                if (x[i] == &NIL) {
+                    continue;
+                }
+                int cmp = m_comper(x[i]->key(), keys[base + i]);
+                if (upper ? (cmp <= 0) : (cmp < 0)) {
+                    x[i] = x[i]->right;
+                }
+                else {
+                    y[i] = x[i];
+                    x[i] = x[i]->left;
+                }
+                if (x[i] != &NIL) {
+                    __builtin_prefetch(x[i]);
+                    descending = true;
+                }
+            }
+        }
+        for (int i = 0; i < groupCount; ++i) {
+            results[base + i] = iterator(this, y[i]);
+        }
+    }
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 void CompactingMap<KeyValuePair, Compare, hasRank>::erase(TreeNode *z)
 {
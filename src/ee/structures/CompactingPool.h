@@ -44,14 +44,20 @@ namespace voltdb
 // Whenever Compacting Pool code is passed control on the current thread,
 // it reserves the right to relocate past allocations on the thread and reset
 // their forward pointers to copied versions of their allocations.
-// Currently, this only happens when (other) allocations are freed.
+// By default, this happens when (other) allocations are freed.
+// A pool with deferred compaction instead leaves a hole behind each freed
+// allocation. Holes are reused by later allocations and filled in by
+// compact(), which the owner calls when no transaction is running, so that
+// a delete never pays for copying a (possibly 1MB) string.
     class CompactingPool
     {
     public:
         // Create a compacting pool.  As memory is required, it will
         // allocate buffers of size elementSize * elementsPerBuffer bytes.
-    CompactingPool(int32_t elementSize, int32_t elementsPerBuffer)
-      : m_allocator(elementSize + FIXED_OVERHEAD_PER_ENTRY(), elementsPerBuffer)
+    CompactingPool(int32_t elementSize, int32_t elementsPerBuffer, bool deferCompaction = false)
+      : m_allocator(elementSize + FIXED_OVERHEAD_PER_ENTRY(), elementsPerBuffer),
+        m_deferCompaction(deferCompaction),
+        m_relocations(0)
     { }
 
 #ifdef VOLT_POOL_CHECKING
@@ -70,8 +76,16 @@ namespace voltdb
     public:
     void* malloc(char** referrer)
     {
-        Relocatable* result =
-            Relocatable::fromAllocation(m_allocator.alloc(), referrer);
+        void* allocation;
+        if (m_holes.empty()) {
+            allocation = m_allocator.alloc();
+        }
+        else {
+            HoleSet::iterator hole = m_holes.begin();
+            allocation = *hole;
+            m_holes.erase(hole);
+        }
+        Relocatable* result = Relocatable::fromAllocation(allocation, referrer);
         // Going forward, the compacting pool manages the value of
         // *referrer -- "the pointer to the allocation",
         // but it's initial value is set by the caller BASED ON --
@@ -95,33 +109,99 @@ namespace voltdb
         if (!clrPtr(element))
             return;
         Relocatable* vacated = Relocatable::backtrackFromCallerData(element);
-        Relocatable* last = reinterpret_cast<Relocatable*>(m_allocator.last());
-        if (last != vacated) {
-            // Notify last's referrer that it is about to relocate
-            // to the location vacated by element.
-            // Use relative addresses to maintain the same byte offset between
-            // *(last->m_referringPtr) and its referent.
-            // This allows layered allocators to have injected their own header
-            // structures between the start of the Relocatable's m_data and the
-            // address that the top allocator returned to its caller to store
-            // and use for its own data.
-            movePtr(last->m_data, element);
-            *(last->m_referringPtr) += (vacated->m_data - last->m_data);
-            // copy the last entry into the newly vacated spot
-            ::memcpy(vacated, last, m_allocator.allocationSize());
+        if (m_deferCompaction) {
+            if (vacated == m_allocator.last()) {
+                m_allocator.trim();
+                trimTrailingHoles();
+            }
+            else {
+                vacated->m_referringPtr = NULL;
+                m_holes.insert(vacated);
+            }
+            return;
+        }
+        relocateLastInto(vacated);
+    }
+
+    // Fill in up to maxRelocations holes by moving the last allocations
+    // into them. Returns the number of allocations moved.
+    int32_t compact(int32_t maxRelocations)
+    {
+        int32_t relocated = 0;
+        while (relocated < maxRelocations && !m_holes.empty()) {
+            HoleSet::iterator hole = m_holes.begin();
+            Relocatable* vacated = *hole;
+            m_holes.erase(hole);
+            // Trailing holes are always trimmed, so the last entry is live.
+            relocateLastInto(vacated);
+            trimTrailingHoles();
+            ++relocated;
+        }
+        if (m_allocator.count() == 0) {
+            m_allocator.releaseCachedBuffer();
         }
-        // retire the last entry.
-        m_allocator.trim();
+        return relocated;
     }
 
     std::size_t getBytesAllocated() const
     { return m_allocator.bytesAllocated(); }
 
+    // Allocations handed out, including the ones sitting in holes.
+    int64_t getSlotCount() const
+    { return m_allocator.count(); }
+
+    int64_t getHoleCount() const
+    { return static_cast<int64_t>(m_holes.size()); }
+
+    int32_t getSlotSize() const
+    { return m_allocator.allocationSize(); }
+
+    // Allocations moved to keep the pool compact.
+    int64_t getRelocationCount() const
+    { return m_relocations; }
+
     static int32_t FIXED_OVERHEAD_PER_ENTRY()
     { return static_cast<int32_t>(sizeof(Relocatable)); }
 
     private:
+        struct Relocatable;
+        typedef std::unordered_set<Relocatable*> HoleSet;
+
+        void relocateLastInto(Relocatable* vacated)
+        {
+            Relocatable* last = reinterpret_cast<Relocatable*>(m_allocator.last());
+            if (last != vacated) {
+                // Notify last's referrer that it is about to relocate
+                // to the location vacated by element.
+                // Use relative addresses to maintain the same byte offset between
+                // *(last->m_referringPtr) and its referent.
+                // This allows layered allocators to have injected their own header
+                // structures between the start of the Relocatable's m_data and the
+                // address that the top allocator returned to its caller to store
+                // and use for its own data.
+                movePtr(last->m_data, vacated->m_data);
+                *(last->m_referringPtr) += (vacated->m_data - last->m_data);
+                // copy the last entry into the newly vacated spot
+                ::memcpy(vacated, last, m_allocator.allocationSize());
+                ++m_relocations;
+            }
+            // retire the last entry.
+            m_allocator.trim();
+        }
+
+        // Keep the last entry live by retiring any holes at the end.
+        void trimTrailingHoles()
+        {
+            while (m_allocator.count() > 0 &&
+                   m_holes.erase(reinterpret_cast<Relocatable*>(m_allocator.last())) != 0) {
+                m_allocator.trim();
+            }
+        }
+
         ContiguousAllocator m_allocator;
+        const bool m_deferCompaction;
+        HoleSet m_holes;
+        int64_t m_relocations;
 #ifdef VOLT_POOL_CHECKING
 #ifdef VOLT_TRACE_ALLOCATIONS
         typedef std::unordered_map<void *, StackTrace*> AllocTraceMap_t;
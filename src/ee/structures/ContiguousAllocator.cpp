@@ -17,15 +17,35 @@
 
 #include "ContiguousAllocator.h"
 
+#include "common/HugePageAllocator.h"
 #include "common/ThreadLocalPool.h"
 
 
 using namespace voltdb;
 
+namespace {
+/**
+ * With huge pages enabled, stretch blocks that would already take up a
+ * good part of a huge page so that they fill whole huge pages instead of
+ * leaving the rest of the last one unused.  Smaller blocks stay on the heap.
+ */
+int32_t allocationsPerBlock(int32_t allocSize, int32_t chunkSize, size_t overhead) {
+    if (!HugePageAllocator::hugePagesEnabled()) {
+        return chunkSize;
+    }
+    size_t blockSize = overhead + static_cast<size_t>(allocSize) * chunkSize;
+    if (blockSize < HugePageAllocator::HUGE_PAGE_SIZE / 4) {
+        return chunkSize;
+    }
+    size_t hugePages = (blockSize + HugePageAllocator::HUGE_PAGE_SIZE - 1) / HugePageAllocator::HUGE_PAGE_SIZE;
+    return static_cast<int32_t>((hugePages * HugePageAllocator::HUGE_PAGE_SIZE - overhead) / allocSize);
+}
+}
+
 ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize)
     : m_count(0),
       m_allocationSize(allocSize),
-      m_numberAllocationsPerBlock(chunkSize),
+      m_numberAllocationsPerBlock(allocationsPerBlock(allocSize, chunkSize, sizeof(Buffer))),
       m_tail(NULL),
       m_blockCount(0),
       m_cachedBuffer(0) {}
@@ -33,14 +53,27 @@ ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize)
 ContiguousAllocator::~ContiguousAllocator() {
     while (m_tail) {
         Buffer *buf = m_tail->prev;
-        free(m_tail);
+        freeBuffer(m_tail);
         m_tail = buf;
     }
     if (m_cachedBuffer != NULL) {
-        free(m_cachedBuffer);
+        freeBuffer(m_cachedBuffer);
     }
 }
 
+ContiguousAllocator::Buffer *ContiguousAllocator::allocateBuffer() {
+    size_t mappedSize;
+    char *memory = HugePageAllocator::allocate(
+            sizeof(Buffer) + static_cast<size_t>(m_allocationSize) * m_numberAllocationsPerBlock, mappedSize);
+    Buffer *buf = reinterpret_cast<Buffer*>(memory);
+    buf->mappedSize = mappedSize;
+    return buf;
+}
+
+void ContiguousAllocator::freeBuffer(Buffer *buf) {
+    HugePageAllocator::release(reinterpret_cast<char*>(buf), buf->mappedSize);
+}
+
 void *ContiguousAllocator::alloc() {
     m_count++;
 
@@ -49,16 +82,14 @@ void *ContiguousAllocator::alloc() {
 
     // if a new block is needed...
     if (blockOffset == 0) {
-        void *memory;
+        Buffer *buf;
         if (m_cachedBuffer != NULL) {
-            memory = static_cast<void *>(m_cachedBuffer);
+            buf = m_cachedBuffer;
             m_cachedBuffer = NULL;
         } else {
-            memory = static_cast<void *>(malloc(sizeof(Buffer) + m_allocationSize * m_numberAllocationsPerBlock));
+            buf = allocateBuffer();
         }
 
-        Buffer *buf = reinterpret_cast<Buffer*>(memory);
-
         // for debugging
         //memset(buf, 0, sizeof(sizeof(Buffer) + m_allocSize * m_chunkSize));
 
@@ -100,12 +131,19 @@ void ContiguousAllocator::trim() {
         if (m_blockCount == 0) {
             m_cachedBuffer = m_tail;
         } else {
-            free(m_tail);
+            freeBuffer(m_tail);
         }
         m_tail = buf;
     }
 }
 
+void ContiguousAllocator::releaseCachedBuffer() {
+    if (m_cachedBuffer != NULL) {
+        freeBuffer(m_cachedBuffer);
+        m_cachedBuffer = NULL;
+    }
+}
+
 size_t ContiguousAllocator::bytesAllocated() const {
     size_t total = static_cast<size_t>(m_blockCount) *
         static_cast<size_t>(m_allocationSize) *
@@ -32,8 +32,10 @@ namespace voltdb {
  * allocation's data may be recovered.  The clients all do this.
  *
  * A *block* is a fixed size allocation, which has been obtained from
- * malloc(3). These are chained together.  They are all the same size
- * in bytes.  This size is set when the allocator is constructed.
+ * the HugePageAllocator. These are chained together.  They are all the
+ * same size in bytes.  This size is set when the allocator is constructed.
+ * When huge pages are enabled, blocks of a quarter huge page or more are
+ * grown to fill whole huge pages.
  *
  * The head of the chain of blocks is the *tail block*.  Blocks which
  * are not the tail block are completely full.
@@ -50,6 +52,8 @@ class ContiguousAllocator {
      */
     struct Buffer {
         Buffer *prev;
+        /** Length of the huge page mapping, or 0 for a heap block. */
+        size_t mappedSize;
         char data[0];
     };
     /** This is the total number of allocations in use in all blocks. */
@@ -73,6 +77,9 @@ class ContiguousAllocator {
      */
     Buffer *m_cachedBuffer;
 
+    Buffer *allocateBuffer();
+    static void freeBuffer(Buffer *buf);
+
 public:
 
     /**
@@ -118,6 +125,9 @@ public:
 
     /** Do we have a cached last buffer?  This is used in testing. */
     bool hasCachedLastBuffer() const { return (m_cachedBuffer != NULL); }
+
+    /** Give the cached last buffer, if any, back to the system. */
+    void releaseCachedBuffer();
 };
 
 } // namespace voltdb
@@ -37,6 +37,7 @@
 #include "common/RecoveryProtoMessage.h"
 #include "common/serializeio.h"
 #include "common/SegvException.hpp"
+#include "common/StreamBufferPool.h"
 #include "common/SynchronizedThreadLock.h"
 #include "common/types.h"
 
@@ -659,6 +660,14 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
         int64_t logLevels;
         int64_t tempTableMemory;
         int32_t isLowestSiteId;
+        int32_t compactionThreshold;
+        int32_t exportFlushTimeout;
+        int32_t replicatedBarrierType;
+        int32_t hugePageMode;
+        int32_t bindToNumaNode;
+        int32_t deferStringCompaction;
+        int32_t prefaultedStreamBuffers;
+        int32_t compressDRBuffers;
         int32_t hostnameLength;
         char data[0];
     }__attribute__((packed));
@@ -679,6 +688,14 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
     cs->tempTableMemory = ntohll(cs->tempTableMemory);
     cs->isLowestSiteId = ntohl(cs->isLowestSiteId);
     bool isLowestSiteId = cs->isLowestSiteId != 0;
+    cs->compactionThreshold = ntohl(cs->compactionThreshold);
+    cs->exportFlushTimeout = ntohl(cs->exportFlushTimeout);
+    cs->replicatedBarrierType = ntohl(cs->replicatedBarrierType);
+    cs->hugePageMode = ntohl(cs->hugePageMode);
+    cs->bindToNumaNode = ntohl(cs->bindToNumaNode);
+    cs->deferStringCompaction = ntohl(cs->deferStringCompaction);
+    cs->prefaultedStreamBuffers = ntohl(cs->prefaultedStreamBuffers);
+    cs->compressDRBuffers = ntohl(cs->compressDRBuffers);
     cs->hostnameLength = ntohl(cs->hostnameLength);
 
     std::string hostname(cs->data, cs->hostnameLength);
@@ -709,7 +726,15 @@ int8_t VoltDBIPC::initialize(struct ipc_command *cmd) {
                              cs->drClusterId,
                              cs->defaultDrBufferSize,
                              cs->tempTableMemory,
-                             isLowestSiteId);
+                             isLowestSiteId,
+                             cs->compactionThreshold,
+                             cs->exportFlushTimeout,
+                             static_cast<ReplicatedBarrierType>(cs->replicatedBarrierType),
+                             static_cast<HugePageMode>(cs->hugePageMode),
+                             cs->bindToNumaNode != 0,
+                             cs->deferStringCompaction != 0,
+                             cs->prefaultedStreamBuffers,
+                             cs->compressDRBuffers != 0);
         return kErrorCode_Success;
     }
     catch (const FatalException &e) {
@@ -1639,8 +1664,8 @@ void VoltDBIPC::pushExportBuffer(
         // Memset the first 8 bytes to initialize the MAGIC_HEADER_SPACE_FOR_JAVA
         ::memset(block->rawPtr(), 0, 8);
         writeOrDie(m_fd, (unsigned char*)block->rawPtr(), block->rawLength());
-        // Need the delete in the if statement for valgrind
-        delete [] block->rawPtr();
+        // The buffer has been written out, so hand it back for reuse
+        StreamBufferPool::release(block->rawPtr());
     } else {
         *reinterpret_cast<int32_t*>(&m_reusedResultBuffer[index]) = htonl(0);
         writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, index + 4);
@@ -1700,14 +1725,14 @@ void VoltDBIPC::applyBinaryLog(struct ipc_command *cmd) {
 
 int64_t VoltDBIPC::pushDRBuffer(int32_t partitionId, DrStreamBlock *block) {
     if (block != NULL) {
-        delete []block->rawPtr();
+        StreamBufferPool::release(block->rawPtr());
     }
     return -1;
 }
 
 void VoltDBIPC::pushPoisonPill(int32_t partitionId, std::string& reason, voltdb::DrStreamBlock *block) {
     if (block != NULL) {
-        delete []block->rawPtr();
+        StreamBufferPool::release(block->rawPtr());
     }
 }
 
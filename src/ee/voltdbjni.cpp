@@ -110,6 +110,7 @@
 #include "common/SegvException.hpp"
 #include "common/RecoveryProtoMessage.h"
 #include "common/ElasticHashinator.h"
+#include "common/StreamBufferPool.h"
 #include "common/ThreadLocalPool.h"
 #include "storage/DRTupleStream.h"
 #include "murmur3/MurmurHash3.h"
@@ -282,7 +283,13 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
     jlong tempTableMemory,
     jboolean createDrReplicatedStream,
     jint compactionThreshold,
-    jint exportFlushTimeout)
+    jint exportFlushTimeout,
+    jint replicatedBarrierType,
+    jint hugePageMode,
+    jboolean bindToNumaNode,
+    jboolean deferStringCompaction,
+    jint prefaultedStreamBuffers,
+    jboolean compressDRBuffers)
 {
     VOLT_DEBUG("nativeInitialize() start");
     VoltDBEngine *engine = castToEngine(enginePtr);
@@ -311,7 +318,13 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
                            tempTableMemory,
                            createDrReplicatedStream,
                            static_cast<int32_t>(compactionThreshold),
-                           exportFlushTimeout);
+                           exportFlushTimeout,
+                           static_cast<ReplicatedBarrierType>(replicatedBarrierType),
+                           static_cast<HugePageMode>(hugePageMode),
+                           bindToNumaNode,
+                           deferStringCompaction,
+                           prefaultedStreamBuffers,
+                           compressDRBuffers);
         VOLT_DEBUG("initialize succeeded");
         return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
     }
@@ -1307,7 +1320,8 @@ SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetR
  */
 SHAREDLIB_JNIEXPORT void JNICALL Java_org_voltcore_utils_DBBPool_nativeDeleteCharArrayMemory
   (JNIEnv *env, jclass clazz, jlong ptr) {
-    delete[] reinterpret_cast<char*>(ptr);
+    // Export and DR stream buffers go back to their site's pool; anything else is deleted
+    StreamBufferPool::release(reinterpret_cast<char*>(ptr));
 }
 
 /*
@@ -19,13 +19,14 @@ package org.voltdb.dr2;
 
 public interface DRProtocol {
     // Also update DRTupleStream.h if version changes
-    public static final int PROTOCOL_VERSION = 8;
+    public static final int PROTOCOL_VERSION = 9;
     public static final int COMPATIBLE_PROTOCOL_VERSION = 7;
 
     // constant versions that don't change across releases
     public static final int MIXED_SIZE_PROTOCOL_VERSION = 4;
     public static final int MULTICLUSTER_PROTOCOL_VERSION = 7;
     public static final int ELASTICADD_PROTOCOL_VERSION = 8;
+    public static final int COMPRESSED_LOG_PROTOCOL_VERSION = 9;
 
     // all partial MP txns go into SP streams
     public static final int DR_NO_MP_START_PROTOCOL_VERSION = 3;
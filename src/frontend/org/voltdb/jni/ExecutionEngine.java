@@ -130,6 +130,50 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
     /** For now sync this value with the value in the EE C++ code to get good stats. */
     public static final int EE_PLAN_CACHE_SIZE = 1000;
 
+    /*
+     * Engine options that stay off unless they are set as system properties.
+     *
+     * EE_REPLICATED_BARRIER_TYPE picks how the sites hand the replicated table
+     * context to each other on multi-partition writes: 0 (the default) for the
+     * mutex barrier, 1 for the spin-then-futex barrier.
+     *
+     * EE_HUGE_PAGE_MODE backs tuple blocks and index buffers with huge pages:
+     * 0 (the default) for none, 1 for transparent huge pages, 2 for explicit
+     * hugetlbfs pages.  EE_BIND_NUMA_NODE makes each site prefer memory from
+     * its own NUMA node.
+     *
+     * EE_DEFER_STRING_COMPACTION makes freed strings leave holes that are
+     * compacted a little at a time from tick(), rather than on every free.
+     *
+     * EE_PREFAULTED_STREAM_BUFFERS is how many export stream buffers each site
+     * allocates and faults in at startup, so that the first blocks pushed do
+     * not page fault on the site thread.  It defaults to 0.
+     *
+     * EE_COMPRESS_DR_BUFFERS compresses DR buffers on a helper thread before
+     * they are pushed, rather than leaving that to Java.
+     */
+    protected static final int EE_REPLICATED_BARRIER_TYPE;
+    protected static final int EE_HUGE_PAGE_MODE;
+    protected static final boolean EE_BIND_NUMA_NODE = Boolean.getBoolean("EE_BIND_NUMA_NODE");
+    protected static final boolean EE_DEFER_STRING_COMPACTION = Boolean.getBoolean("EE_DEFER_STRING_COMPACTION");
+    protected static final int EE_PREFAULTED_STREAM_BUFFERS;
+    protected static final boolean EE_COMPRESS_DR_BUFFERS = Boolean.getBoolean("EE_COMPRESS_DR_BUFFERS");
+
+    static {
+        EE_REPLICATED_BARRIER_TYPE = Integer.getInteger("EE_REPLICATED_BARRIER_TYPE", 0);
+        if (EE_REPLICATED_BARRIER_TYPE < 0 || EE_REPLICATED_BARRIER_TYPE > 1) {
+            VoltDB.crashLocalVoltDB("EE_REPLICATED_BARRIER_TYPE " + EE_REPLICATED_BARRIER_TYPE + " is not valid, must be 0 or 1", false, null);
+        }
+        EE_HUGE_PAGE_MODE = Integer.getInteger("EE_HUGE_PAGE_MODE", 0);
+        if (EE_HUGE_PAGE_MODE < 0 || EE_HUGE_PAGE_MODE > 2) {
+            VoltDB.crashLocalVoltDB("EE_HUGE_PAGE_MODE " + EE_HUGE_PAGE_MODE + " is not valid, must be between 0 and 2", false, null);
+        }
+        EE_PREFAULTED_STREAM_BUFFERS = Integer.getInteger("EE_PREFAULTED_STREAM_BUFFERS", 0);
+        if (EE_PREFAULTED_STREAM_BUFFERS < 0) {
+            VoltDB.crashLocalVoltDB("EE_PREFAULTED_STREAM_BUFFERS " + EE_PREFAULTED_STREAM_BUFFERS + " is not valid, must not be negative", false, null);
+        }
+    }
+
     /** Partition ID */
     protected final int m_partitionId;
 
@@ -899,6 +943,12 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      * @param partitionId id of partitioned assigned to this EE
      * @param hostId id of the host this EE is running on
      * @param hostname name of the host this EE is running on
+     * @param replicatedBarrierType see EE_REPLICATED_BARRIER_TYPE
+     * @param hugePageMode see EE_HUGE_PAGE_MODE
+     * @param bindToNumaNode see EE_BIND_NUMA_NODE
+     * @param deferStringCompaction see EE_DEFER_STRING_COMPACTION
+     * @param prefaultedStreamBuffers see EE_PREFAULTED_STREAM_BUFFERS
+     * @param compressDRBuffers see EE_COMPRESS_DR_BUFFERS
      * @return error code
      */
     protected native int nativeInitialize(
@@ -914,7 +964,13 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             long tempTableMemory,
             boolean createDrReplicatedStream,
             int compactionThreshold,
-            int exportFlushTimeout);
+            int exportFlushTimeout,
+            int replicatedBarrierType,
+            int hugePageMode,
+            boolean bindToNumaNode,
+            boolean deferStringCompaction,
+            int prefaultedStreamBuffers,
+            boolean compressDRBuffers);
 
     /**
      * Sets (or re-sets) all the shared direct byte buffers in the EE.
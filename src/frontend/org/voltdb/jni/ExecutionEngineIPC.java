@@ -933,6 +933,14 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         m_data.putLong(EELoggers.getLogLevels());
         m_data.putLong(tempTableMemory);
         m_data.putInt(createDrReplicatedStream ? 1 : 0);
+        m_data.putInt(ExecutionEngineJNI.EE_COMPACTION_THRESHOLD);
+        m_data.putInt((int)exportFlushTimeout);
+        m_data.putInt(EE_REPLICATED_BARRIER_TYPE);
+        m_data.putInt(EE_HUGE_PAGE_MODE);
+        m_data.putInt(EE_BIND_NUMA_NODE ? 1 : 0);
+        m_data.putInt(EE_DEFER_STRING_COMPACTION ? 1 : 0);
+        m_data.putInt(EE_PREFAULTED_STREAM_BUFFERS);
+        m_data.putInt(EE_COMPRESS_DR_BUFFERS ? 1 : 0);
         m_data.putInt((short)hostname.length());
         m_data.put(hostname.getBytes(Charsets.UTF_8));
         try {
@@ -181,7 +181,13 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                     tempTableMemory * 1024 * 1024,
                     isLowestSiteId,
                     EE_COMPACTION_THRESHOLD,
-                    exportFlushTimeout);
+                    exportFlushTimeout,
+                    EE_REPLICATED_BARRIER_TYPE,
+                    EE_HUGE_PAGE_MODE,
+                    EE_BIND_NUMA_NODE,
+                    EE_DEFER_STRING_COMPACTION,
+                    EE_PREFAULTED_STREAM_BUFFERS,
+                    EE_COMPRESS_DR_BUFFERS);
         checkErrorCode(errorCode);
 
         setupPsetBuffer(smallBufferSize);
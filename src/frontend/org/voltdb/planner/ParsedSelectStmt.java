@@ -2650,6 +2650,8 @@ public class ParsedSelectStmt extends AbstractParsedStmt {
                 AbstractParsedStmt recursiveQuery
                         = parseCommonTableStatement(recursiveQueryXML, false);
                 tableScanShared.setRecursiveQuery(recursiveQuery);
+                String distinctStr = withElementXML.attributes.get("uniondistinct");
+                tableScanShared.setUnionDistinct(distinctStr != null && Boolean.valueOf(distinctStr));
             }
         }
     }
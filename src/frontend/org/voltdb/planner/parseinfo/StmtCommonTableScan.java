@@ -192,6 +192,10 @@ public class StmtCommonTableScan extends StmtEphemeralTableScan {
         return nextId;
     }
 
+    public boolean isUnionDistinct() {
+        return m_sharedScan.isUnionDistinct();
+    }
+
     public boolean isRecursiveCTE() {
         return m_sharedScan.getBestCostRecursiveStmtId() != null;
     }
@@ -56,6 +56,9 @@ public class StmtCommonTableScanShared {
     private Boolean m_isReplicated = null;
     private AbstractParsedStmt m_baseQuery;
     private AbstractParsedStmt m_recursiveQuery;
+    // True for UNION (rather than UNION ALL) between the base and
+    // recursive queries: rows already produced are not produced again.
+    private boolean m_unionDistinct = false;
     // This is the equivalent of m_table in StmtTargetTableScan.
     // We don't actually have a catalog Table object for this
     // table.  All we have is this very scan node, which is
@@ -133,6 +136,14 @@ public class StmtCommonTableScanShared {
         m_recursiveQuery = recursiveQuery;
     }
 
+    public final boolean isUnionDistinct() {
+        return m_unionDistinct;
+    }
+
+    public final void setUnionDistinct(boolean unionDistinct) {
+        m_unionDistinct = unionDistinct;
+    }
+
     public final CompiledPlan getBestCostBasePlan() {
         return m_bestCostBasePlan;
     }
@@ -43,6 +43,7 @@ public class CommonTablePlanNode extends AbstractPlanNode {
     private String m_commonTableName;
     private StmtCommonTableScan m_tableScan;
     private Integer m_recursiveStatementId;
+    private boolean m_unionDistinct = false;
     private AbstractPlanNode m_recurseNode;
 
     // Flags to help generate proper explain string outputs.
@@ -51,7 +52,8 @@ public class CommonTablePlanNode extends AbstractPlanNode {
 
     public enum Members {
         COMMON_TABLE_NAME,
-        RECURSIVE_STATEMENT_ID
+        RECURSIVE_STATEMENT_ID,
+        UNION_DISTINCT
     };
 
     public CommonTablePlanNode() {
@@ -61,6 +63,7 @@ public class CommonTablePlanNode extends AbstractPlanNode {
         m_tableScan = scan;
         // The table name and alias are the same here.
         m_commonTableName = scan.getTableName();
+        m_unionDistinct = scan.isUnionDistinct();
     }
 
     @Override
@@ -111,7 +114,7 @@ public class CommonTablePlanNode extends AbstractPlanNode {
 
         if (m_recurseNode != null) {
             m_explainingRecurseNode = true;
-            sb.append(indent).append("ITERATE UNTIL EMPTY ");
+            sb.append(indent).append(m_unionDistinct ? "ITERATE UNTIL NO NEW ROWS " : "ITERATE UNTIL EMPTY ");
             m_recurseNode.setSkipInitalIndentationForExplain(true);
             m_recurseNode.explainPlan_recurse(sb, indent);
             m_explainingRecurseNode = false;
@@ -128,6 +131,9 @@ public class CommonTablePlanNode extends AbstractPlanNode {
         }
         if (m_recursiveStatementId != null) {
             stringer.key(Members.RECURSIVE_STATEMENT_ID.name()).value(m_recursiveStatementId);
+            if (m_unionDistinct) {
+                stringer.key(Members.UNION_DISTINCT.name()).value(true);
+            }
         }
     }
 
@@ -141,6 +147,7 @@ public class CommonTablePlanNode extends AbstractPlanNode {
         else {
             m_recursiveStatementId = null;
         }
+        m_unionDistinct = jobj.optBoolean(Members.UNION_DISTINCT.name(), false);
     }
 
     public Integer getRecursiveNodeId() {
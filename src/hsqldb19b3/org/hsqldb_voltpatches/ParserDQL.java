@@ -676,7 +676,7 @@ public class ParserDQL extends ParserBase {
             readThis(Tokens.AS);
             readThis(Tokens.OPENBRACKET);
             // Read a query.  If it's recursive it has to be of the form:
-            //    Q1 union all Q2.
+            //    Q1 union [all | distinct] Q2.
             // In Q1 we can't use an order by or limit.  It's ok
             // to use group by, aggregates and having, though.  The
             // query name will be visible in Q2 but not in Q1.
@@ -728,9 +728,13 @@ public class ParserDQL extends ParserBase {
             }
             // Now, define it.
             Table newTable = session.defineLocalTable(queryName, colNames, colTypes);
+            boolean unionDistinct = false;
             if (recursive) {
                 readThis(Tokens.UNION);
-                readThis(Tokens.ALL);
+                if (! readIfThis(Tokens.ALL)) {
+                    readIfThis(Tokens.DISTINCT);
+                    unionDistinct = true;
+                }
                 recursionQueryExpression = XreadQueryExpressionBody();
             }
             readThis(Tokens.CLOSEBRACKET);
@@ -738,6 +742,7 @@ public class ParserDQL extends ParserBase {
             withExpression.setQueryName(queryName);
             withExpression.setBaseQuery(baseQueryExpression);
             withExpression.setRecursiveQuery(recursionQueryExpression);
+            withExpression.setUnionDistinct(unionDistinct);
             withExpression.setTable(newTable);
             withList.add(withExpression);
         }
@@ -1001,6 +1001,9 @@ public abstract class StatementDMQL extends Statement {
         withExprXML.children.add(voltGetXMLExpression(baseQuery, parameters, session));
         if (recursiveQuery != null) {
             withExprXML.children.add(voltGetXMLExpression(recursiveQuery, parameters, session));
+            if (withExpr.isUnionDistinct()) {
+                withExprXML.attributes.put("uniondistinct", "true");
+            }
         }
         return withExprXML;
     }
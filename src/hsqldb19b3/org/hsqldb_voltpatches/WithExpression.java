@@ -26,6 +26,7 @@ public class WithExpression {
     private boolean m_isRecursive = false;
     private QueryExpression m_baseQuery;
     private QueryExpression m_recursiveQuery;
+    private boolean m_unionDistinct = false;
     private Table m_table;
     private boolean m_baseQueryResolved = false;
 
@@ -53,6 +54,12 @@ public class WithExpression {
     public final void setRecursiveQuery(QueryExpression recursiveQuery) {
         m_recursiveQuery = recursiveQuery;
     }
+    public final boolean isUnionDistinct() {
+        return m_unionDistinct;
+    }
+    public final void setUnionDistinct(boolean unionDistinct) {
+        m_unionDistinct = unionDistinct;
+    }
     public final Table getTable() {
         return m_table;
     }
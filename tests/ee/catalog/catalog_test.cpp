@@ -54,8 +54,12 @@
 #include "catalog/catalog.h"
 #include "catalog/cluster.h"
 #include "catalog/database.h"
+#include "catalog/table.h"
+#include "catalog/catalogcommands.h"
+#include "common/SerializableEEException.h"
 
 using namespace catalog;
+using namespace voltdb;
 using namespace std;
 
 class CatalogTest : public Test {
@@ -1098,6 +1102,74 @@ TEST_F(CatalogTest, HexDecode) {
     Catalog::hexDecodeString(val, output);
     output[len / 2] = '\0';
 }
+
+static const char *SMALL_CATALOG =
+"add / clusters cluster"
+"\nset /clusters#cluster localepoch 1199145600"
+"\nset $PREV drRole \"xdcr\""
+"\nadd /clusters#cluster databases database"
+"\nadd /clusters#cluster/databases#database tables THINGS"
+"\nset /clusters#cluster/databases#database/tables#THINGS isreplicated true"
+"\nset $PREV tuplelimit 100"
+"\nadd /clusters#cluster/databases#database tables PEOPLE"
+"\nset /clusters#cluster/databases#database/tables#PEOPLE isreplicated false\n";
+
+TEST_F(CatalogTest, DecodedCommands) {
+    CatalogCommands commands(SMALL_CATALOG);
+    ASSERT_EQ(9, commands.size());
+    ASSERT_EQ(CatalogCommands::PREVIOUS_REF, commands.at(2).ref);
+
+    Catalog catalog;
+    catalog.execute(commands);
+    Cluster *cluster = catalog.clusters().get("cluster");
+    ASSERT_TRUE(cluster != NULL);
+    ASSERT_EQ(1199145600, cluster->localepoch());
+    ASSERT_EQ(string("xdcr"), cluster->drRole());
+    Database *database = cluster->databases().get("database");
+    ASSERT_EQ(2, database->tables().size());
+    ASSERT_TRUE(database->tables().get("THINGS")->isreplicated());
+    ASSERT_EQ(100, database->tables().get("THINGS")->tuplelimit());
+    ASSERT_FALSE(database->tables().get("PEOPLE")->isreplicated());
+
+    // A delta goes through the same decode.
+    catalog.execute("delete /clusters#cluster/databases#database tables PEOPLE");
+    ASSERT_EQ(1, database->tables().size());
+    vector<string> deletions;
+    catalog.getDeletedPaths(deletions);
+    ASSERT_EQ(1, deletions.size());
+    ASSERT_EQ(string("/clusters#cluster/databases#database/tables#PEOPLE"), deletions[0]);
+}
+
+TEST_F(CatalogTest, SharedCommands) {
+    string payload = SMALL_CATALOG;
+    boost::shared_ptr<const CatalogCommands> first = CatalogCommands::parseShared(payload);
+    boost::shared_ptr<const CatalogCommands> second = CatalogCommands::parseShared(string(SMALL_CATALOG));
+    ASSERT_EQ(first.get(), second.get());
+    boost::shared_ptr<const CatalogCommands> other = CatalogCommands::parseShared("add / clusters cluster");
+    ASSERT_NE(first.get(), other.get());
+}
+
+TEST_F(CatalogTest, TextSkipsEmptyLines) {
+    string payload = string("\n") + SMALL_CATALOG + "\n\n";
+    CatalogCommands text(payload);
+    ASSERT_EQ(CatalogCommands(SMALL_CATALOG).size(), text.size());
+
+    Catalog catalog;
+    catalog.execute(payload);
+    ASSERT_EQ(1199145600, catalog.clusters().get("cluster")->localepoch());
+}
+
+TEST_F(CatalogTest, InvalidCommand) {
+    bool thrown = false;
+    try {
+        CatalogCommands text("drop / clusters cluster");
+    }
+    catch (const SerializableEEException &e) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,166 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Compares DECIMAL arithmetic through NValue, which uses native 128 bit
+ * integers where the compiler has them, with the same operations done on
+ * ttmath integers the way NValue did them before, and with BIGINT as a
+ * reference point.
+ *
+ * Run with a row count, e.g. "DecimalArithmeticBenchmark 10000000".
+ */
+
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/time.h>
+#include <vector>
+
+using namespace voltdb;
+
+namespace {
+
+int64_t getMicrosNow() {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+const int64_t SCALE = 1000000000000LL;   // 10**12, NValue::kMaxScaleFactor
+
+TTInt maxDecimal() {
+    return ValuePeeker::peekDecimal(
+            ValueFactory::getDecimalValueFromString("99999999999999999999999999.999999999999"));
+}
+
+void report(const char* name, int64_t micros, int rows, const std::string& result) {
+    printf("%-28s %10lld us  %7.2f ns/row  result %s\n", name, (long long)micros,
+           rows > 0 ? micros * 1000.0 / rows : 0.0, result.c_str());
+}
+
+// Money-like amounts: up to a billion with two decimal places.
+void generate(int rows, std::vector<NValue>& decimals, std::vector<NValue>& bigints) {
+    srand(42);
+    for (int i = 0; i < rows; i++) {
+        int64_t cents = (static_cast<int64_t>(rand()) * rand()) % 100000000000LL;
+        if (rand() % 4 == 0) {
+            cents = -cents;
+        }
+        char text[32];
+        snprintf(text, sizeof(text), "%s%lld.%02lld", cents < 0 ? "-" : "",
+                 (long long)(std::abs(cents) / 100), (long long)(std::abs(cents) % 100));
+        decimals.push_back(ValueFactory::getDecimalValueFromString(text));
+        bigints.push_back(ValueFactory::getBigIntValue(cents));
+    }
+}
+
+void benchmarkSum(const std::vector<NValue>& decimals, const std::vector<NValue>& bigints) {
+    int rows = static_cast<int>(decimals.size());
+
+    int64_t start = getMicrosNow();
+    NValue sum = decimals[0];
+    for (int i = 1; i < rows; i++) {
+        sum = sum.op_add(decimals[i]);
+    }
+    report("SUM(DECIMAL) NValue", getMicrosNow() - start, rows, sum.debug());
+
+    const TTInt max = maxDecimal();
+    const TTInt min = -max;
+    start = getMicrosNow();
+    TTInt ttsum = ValuePeeker::peekDecimal(decimals[0]);
+    for (int i = 1; i < rows; i++) {
+        TTInt next(ttsum);
+        if (next.Add(ValuePeeker::peekDecimal(decimals[i])) || next > max || next < min) {
+            printf("unexpected overflow\n");
+            return;
+        }
+        ttsum = next;
+    }
+    report("SUM(DECIMAL) ttmath", getMicrosNow() - start, rows,
+           ttsum.ToString() + " (scaled)");
+
+    start = getMicrosNow();
+    NValue bigsum = bigints[0];
+    for (int i = 1; i < rows; i++) {
+        bigsum = bigsum.op_add(bigints[i]);
+    }
+    report("SUM(BIGINT) NValue", getMicrosNow() - start, rows, bigsum.debug());
+}
+
+void benchmarkMultiplyDivide(const std::vector<NValue>& decimals) {
+    int rows = static_cast<int>(decimals.size());
+    NValue rate = ValueFactory::getDecimalValueFromString("1.0725");
+    TTInt ttrate = ValuePeeker::peekDecimal(rate);
+
+    int64_t start = getMicrosNow();
+    NValue total = ValueFactory::getDecimalValueFromString("0");
+    for (int i = 0; i < rows; i++) {
+        total = total.op_add(decimals[i].op_multiply(rate).op_divide(rate));
+    }
+    report("DECIMAL * / NValue", getMicrosNow() - start, rows, total.debug());
+
+    start = getMicrosNow();
+    TTInt tttotal(0);
+    for (int i = 0; i < rows; i++) {
+        TTLInt calc;
+        calc.FromInt(ValuePeeker::peekDecimal(decimals[i]));
+        calc *= ttrate;
+        calc /= SCALE;
+        calc *= SCALE;
+        calc.Div(ttrate);
+        TTInt quotient;
+        quotient.FromInt(calc);
+        tttotal.Add(quotient);
+    }
+    report("DECIMAL * / ttmath", getMicrosNow() - start, rows,
+           tttotal.ToString() + " (scaled)");
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || *argv[1] == '-') {
+        printf("To run the benchmark, execute %s with the number of rows to aggregate, "
+               "e.g. %s 10000000\n", argv[0], argv[0]);
+        return 0;
+    }
+    int rows = std::atoi(argv[1]);
+    if (rows < 1) {
+        printf("row count must be positive\n");
+        return 0;
+    }
+    std::vector<NValue> decimals;
+    std::vector<NValue> bigints;
+    generate(rows, decimals, bigints);
+    benchmarkSum(decimals, bigints);
+    benchmarkMultiplyDivide(decimals);
+    return 0;
+}
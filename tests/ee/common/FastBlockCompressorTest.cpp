@@ -0,0 +1,113 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/FastBlockCompressor.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using voltdb::FastBlockCompressor;
+
+class FastBlockCompressorTest : public Test {
+public:
+    // Compress and decompress the input, returning the compressed length or 0.
+    size_t roundTrip(const std::string& input) {
+        // Literal runs cost an extra length byte per 255 bytes
+        std::vector<char> compressed(input.size() + input.size() / 255 + 16);
+        size_t compressedLength = FastBlockCompressor::compress(input.data(), input.size(),
+                                                                &compressed[0], compressed.size());
+        if (compressedLength == 0) {
+            return 0;
+        }
+        std::vector<char> output(input.size() + 1);
+        EXPECT_TRUE(FastBlockCompressor::decompress(&compressed[0], compressedLength,
+                                                    &output[0], input.size()));
+        EXPECT_EQ(0, memcmp(input.data(), &output[0], input.size()));
+        return compressedLength;
+    }
+};
+
+TEST_F(FastBlockCompressorTest, RepetitiveInputShrinks) {
+    std::string input;
+    for (int ii = 0; ii < 1000; ++ii) {
+        input += "INSERT INTO T VALUES (";
+        input += std::to_string(ii);
+        input += ", 'some text that repeats');";
+    }
+    size_t compressedLength = roundTrip(input);
+    ASSERT_TRUE(compressedLength > 0);
+    ASSERT_TRUE(compressedLength < input.size() / 4);
+}
+
+TEST_F(FastBlockCompressorTest, OverlappingMatches) {
+    // A run is encoded as a match overlapping its own output.
+    std::string input(100000, 'x');
+    size_t compressedLength = roundTrip(input);
+    ASSERT_TRUE(compressedLength > 0);
+    ASSERT_TRUE(compressedLength < 1000);
+}
+
+TEST_F(FastBlockCompressorTest, ShortAndEmptyInputs) {
+    EXPECT_TRUE(roundTrip("") > 0);
+    EXPECT_TRUE(roundTrip("abc") > 0);
+    EXPECT_TRUE(roundTrip("abcdabcdab") > 0);
+}
+
+TEST_F(FastBlockCompressorTest, IncompressibleInputDoesNotFit) {
+    srand(4242);
+    std::string input(65536, '\0');
+    for (size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<char>(rand());
+    }
+    std::vector<char> compressed(input.size() - 1);
+    EXPECT_EQ(0, FastBlockCompressor::compress(input.data(), input.size(), &compressed[0], compressed.size()));
+    // With room to spare random data still round trips.
+    EXPECT_TRUE(roundTrip(input) > 0);
+}
+
+TEST_F(FastBlockCompressorTest, CorruptInputIsRejected) {
+    std::string input(10000, 'y');
+    input += "some literal tail";
+    std::vector<char> compressed(input.size());
+    size_t compressedLength = FastBlockCompressor::compress(input.data(), input.size(),
+                                                            &compressed[0], compressed.size());
+    ASSERT_TRUE(compressedLength > 0);
+    std::vector<char> output(input.size());
+    // Wrong expected length
+    EXPECT_FALSE(FastBlockCompressor::decompress(&compressed[0], compressedLength, &output[0], input.size() - 1));
+    // Truncated block
+    EXPECT_FALSE(FastBlockCompressor::decompress(&compressed[0], compressedLength - 3, &output[0], input.size()));
+    // A match reaching back before the start of the output
+    char bogus[] = { 0x10, 'a', 0x05, 0x00 };
+    EXPECT_FALSE(FastBlockCompressor::decompress(bogus, sizeof(bogus), &output[0], 5));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,141 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/HugePageAllocator.h"
+#include "structures/ContiguousAllocator.h"
+
+#include <cstring>
+#include <thread>
+
+#ifdef LINUX
+#include <sched.h>
+#endif
+
+using voltdb::ContiguousAllocator;
+using voltdb::HugePageAllocator;
+
+class HugePageAllocatorTest : public Test {
+public:
+    ~HugePageAllocatorTest() {
+        HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_NONE, false);
+    }
+
+    // Touch both ends of the block to make sure all of it is usable.
+    void checkUsable(char* block, size_t size) {
+        ASSERT_TRUE(block != NULL);
+        memset(block, 0x5a, size);
+        EXPECT_EQ(0x5a, block[0]);
+        EXPECT_EQ(0x5a, block[size - 1]);
+    }
+};
+
+TEST_F(HugePageAllocatorTest, HeapWhenDisabled) {
+    HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_NONE, false);
+    size_t mappedSize = 1;
+    char* block = HugePageAllocator::allocate(HugePageAllocator::HUGE_PAGE_SIZE, mappedSize);
+    checkUsable(block, HugePageAllocator::HUGE_PAGE_SIZE);
+    EXPECT_EQ(0, mappedSize);
+    HugePageAllocator::release(block, mappedSize);
+}
+
+TEST_F(HugePageAllocatorTest, TransparentHugePages) {
+    HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_TRANSPARENT, false);
+    size_t size = HugePageAllocator::HUGE_PAGE_SIZE + 100;
+    size_t mappedSize = 0;
+    char* block = HugePageAllocator::allocate(size, mappedSize);
+    checkUsable(block, size);
+    // Rounded up to whole huge pages, on a huge page boundary.
+    EXPECT_EQ(2 * HugePageAllocator::HUGE_PAGE_SIZE, mappedSize);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(block) % HugePageAllocator::HUGE_PAGE_SIZE);
+    HugePageAllocator::release(block, mappedSize);
+
+    // Small blocks are not worth a huge page.
+    block = HugePageAllocator::allocate(4096, mappedSize);
+    checkUsable(block, 4096);
+    EXPECT_EQ(0, mappedSize);
+    HugePageAllocator::release(block, mappedSize);
+}
+
+// Whether or not the host has reserved huge pages, the block is usable.
+TEST_F(HugePageAllocatorTest, ExplicitHugePagesFallBack) {
+    HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_EXPLICIT, false);
+    size_t mappedSize = 0;
+    char* block = HugePageAllocator::allocate(HugePageAllocator::HUGE_PAGE_SIZE, mappedSize);
+    checkUsable(block, HugePageAllocator::HUGE_PAGE_SIZE);
+    EXPECT_EQ(HugePageAllocator::HUGE_PAGE_SIZE, mappedSize);
+    HugePageAllocator::release(block, mappedSize);
+}
+
+TEST_F(HugePageAllocatorTest, ContiguousAllocatorFillsHugePages) {
+    HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_TRANSPARENT, false);
+    // 40 * 20000 bytes is most of a huge page, so the block is stretched.
+    ContiguousAllocator stretched(40, 20000);
+    stretched.alloc();
+    EXPECT_TRUE(stretched.bytesAllocated() > 40 * 20000);
+    EXPECT_TRUE(stretched.bytesAllocated() <= HugePageAllocator::HUGE_PAGE_SIZE);
+    stretched.trim();
+
+    // Small chunks stay as requested.
+    ContiguousAllocator small(40, 100);
+    small.alloc();
+    EXPECT_EQ(40 * 100, small.bytesAllocated());
+    small.trim();
+}
+
+#ifdef LINUX
+// A site thread pinned to one CPU prefers memory from that CPU's node, and
+// one that is not configured to bind is left alone.  Each runs on its own
+// thread so that its affinity and memory policy go away with it.
+TEST_F(HugePageAllocatorTest, BindsToNodeOfPinnedCpus) {
+    voltdb::HugePageAllocationCounters counters;
+    int32_t node = -2;
+    std::thread unbound([&]() {
+        node = HugePageAllocator::bindCurrentThreadToLocalNode(&counters);
+    });
+    unbound.join();
+    EXPECT_EQ(-1, node);
+    EXPECT_EQ(-1, counters.numaNode);
+    EXPECT_EQ(0, counters.numaBindFailures);
+
+    HugePageAllocator::configure(voltdb::HUGE_PAGE_MODE_NONE, true);
+    std::thread pinned([&]() {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(sched_getcpu(), &cpus);
+        ASSERT_EQ(0, sched_setaffinity(0, sizeof(cpus), &cpus));
+        node = HugePageAllocator::bindCurrentThreadToLocalNode(&counters);
+    });
+    pinned.join();
+    EXPECT_TRUE(node >= 0);
+    EXPECT_EQ(node, counters.numaNode);
+    EXPECT_EQ(0, counters.numaBindFailures);
+}
+#endif
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
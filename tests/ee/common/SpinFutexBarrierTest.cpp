@@ -0,0 +1,93 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+#include "common/SpinFutexBarrier.h"
+
+#include <thread>
+#include <vector>
+
+using voltdb::SpinFutexBarrier;
+
+class SpinFutexBarrierTest : public Test {
+public:
+    /**
+     * Run the given number of rounds with one coordinator and
+     * (participants - 1) other threads.  In every round the coordinator
+     * runs alone and bumps a plain counter; everyone else checks on release
+     * that the counter already reflects the round they arrived for.
+     */
+    void runRounds(int32_t participants, int32_t rounds, int32_t spinIterations) {
+        SpinFutexBarrier barrier;
+        barrier.reset(participants, spinIterations);
+        int64_t protectedCounter = 0;
+        std::vector<int64_t> failures(participants, 0);
+
+        std::vector<std::thread> threads;
+        for (int32_t site = 1; site < participants; ++site) {
+            threads.emplace_back([&barrier, &protectedCounter, &failures, rounds, site]() {
+                for (int32_t round = 0; round < rounds; ++round) {
+                    barrier.arriveAndWaitForRelease();
+                    if (protectedCounter < round + 1) {
+                        ++failures[site];
+                    }
+                }
+            });
+        }
+        for (int32_t round = 0; round < rounds; ++round) {
+            barrier.arriveAndWaitForAll();
+            ++protectedCounter;
+            barrier.release();
+        }
+        for (size_t ii = 0; ii < threads.size(); ++ii) {
+            threads[ii].join();
+        }
+
+        EXPECT_EQ(rounds, protectedCounter);
+        for (int32_t site = 0; site < participants; ++site) {
+            EXPECT_EQ(0, failures[site]);
+        }
+    }
+};
+
+TEST_F(SpinFutexBarrierTest, SingleParticipant) {
+    runRounds(1, 100, SpinFutexBarrier::DEFAULT_SPIN_ITERATIONS);
+}
+
+TEST_F(SpinFutexBarrierTest, Spinning) {
+    runRounds(4, 2000, SpinFutexBarrier::DEFAULT_SPIN_ITERATIONS);
+}
+
+// With no spinning every wait goes straight to the futex, which
+// exercises the sleep and wake up paths.
+TEST_F(SpinFutexBarrierTest, Sleeping) {
+    runRounds(4, 2000, 0);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
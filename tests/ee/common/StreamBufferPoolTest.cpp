@@ -0,0 +1,139 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/StreamBufferPool.h"
+
+#include <cstring>
+#include <thread>
+
+using voltdb::StreamBufferPool;
+using voltdb::StreamBufferPoolCounters;
+
+static const size_t BUFFER_SIZE = 64 * 1024;
+
+class StreamBufferPoolTest : public Test {
+};
+
+TEST_F(StreamBufferPoolTest, ReleasedBuffersAreRecycled) {
+    StreamBufferPool pool;
+    char* first = pool.acquire(BUFFER_SIZE);
+    ASSERT_TRUE(first != NULL);
+    memset(first, 0x5a, BUFFER_SIZE);
+    EXPECT_EQ(1, pool.counters().outstandingBuffers);
+
+    StreamBufferPool::release(first);
+    StreamBufferPoolCounters counters = pool.counters();
+    EXPECT_EQ(0, counters.outstandingBuffers);
+    EXPECT_EQ(1, counters.idleBuffers);
+    EXPECT_EQ(BUFFER_SIZE, counters.idleBytes);
+
+    char* second = pool.acquire(BUFFER_SIZE);
+    EXPECT_EQ(first, second);
+    counters = pool.counters();
+    EXPECT_EQ(2, counters.acquires);
+    EXPECT_EQ(1, counters.poolHits);
+    EXPECT_EQ(1, counters.allocations);
+    EXPECT_EQ(1, counters.releases);
+
+    // Different sizes are kept apart.
+    char* other = pool.acquire(BUFFER_SIZE / 2);
+    EXPECT_NE(second, other);
+    StreamBufferPool::release(other);
+    StreamBufferPool::release(second);
+    EXPECT_EQ(2, pool.counters().idleBuffers);
+}
+
+TEST_F(StreamBufferPoolTest, ReserveFaultsInBuffers) {
+    StreamBufferPool pool;
+    pool.reserve(BUFFER_SIZE, 3);
+    StreamBufferPoolCounters counters = pool.counters();
+    EXPECT_EQ(3, counters.allocations);
+    EXPECT_EQ(3, counters.idleBuffers);
+
+    char* buffers[3];
+    for (int ii = 0; ii < 3; ++ii) {
+        buffers[ii] = pool.acquire(BUFFER_SIZE);
+    }
+    counters = pool.counters();
+    EXPECT_EQ(3, counters.poolHits);
+    EXPECT_EQ(3, counters.allocations);
+    EXPECT_EQ(3, counters.outstandingBuffers);
+    for (int ii = 0; ii < 3; ++ii) {
+        StreamBufferPool::release(buffers[ii]);
+    }
+}
+
+TEST_F(StreamBufferPoolTest, IdleBytesAreCapped) {
+    StreamBufferPool pool(2 * BUFFER_SIZE);
+    char* buffers[3];
+    for (int ii = 0; ii < 3; ++ii) {
+        buffers[ii] = pool.acquire(BUFFER_SIZE);
+    }
+    for (int ii = 0; ii < 3; ++ii) {
+        StreamBufferPool::release(buffers[ii]);
+    }
+    StreamBufferPoolCounters counters = pool.counters();
+    EXPECT_EQ(3, counters.releases);
+    EXPECT_EQ(2, counters.idleBuffers);
+    EXPECT_EQ(2 * BUFFER_SIZE, counters.idleBytes);
+}
+
+TEST_F(StreamBufferPoolTest, OversizedAndForeignBuffersAreNotPooled) {
+    StreamBufferPool pool;
+    char* large = pool.acquire(StreamBufferPool::MAX_POOLED_BUFFER_SIZE + 1);
+    EXPECT_EQ(0, pool.counters().acquires);
+    StreamBufferPool::release(large);
+    StreamBufferPool::release(new char[BUFFER_SIZE]);
+    StreamBufferPool::release(NULL);
+    StreamBufferPoolCounters counters = pool.counters();
+    EXPECT_EQ(0, counters.releases);
+    EXPECT_EQ(0, counters.idleBuffers);
+}
+
+TEST_F(StreamBufferPoolTest, ReleaseFromAnotherThread) {
+    StreamBufferPool pool;
+    char* buffer = pool.acquire(BUFFER_SIZE);
+    std::thread topend([buffer]() { StreamBufferPool::release(buffer); });
+    topend.join();
+    EXPECT_EQ(0, pool.counters().outstandingBuffers);
+    EXPECT_EQ(buffer, pool.acquire(BUFFER_SIZE));
+    StreamBufferPool::release(buffer);
+}
+
+TEST_F(StreamBufferPoolTest, BuffersOutliveTheirPool) {
+    char* buffer;
+    {
+        StreamBufferPool pool;
+        buffer = pool.acquire(BUFFER_SIZE);
+    }
+    // The pool is gone, so the buffer is simply freed.
+    StreamBufferPool::release(buffer);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
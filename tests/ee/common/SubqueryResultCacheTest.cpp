@@ -0,0 +1,189 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "common/SubqueryResultCache.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+#include "storage/TempTableLimits.h"
+
+#include "boost/scoped_ptr.hpp"
+
+#include <vector>
+#include <string>
+
+using namespace voltdb;
+
+class SubqueryResultCacheTest : public Test
+{
+public:
+    SubqueryResultCacheTest()
+        : m_limits(10 * 1024 * 1024)
+    {
+        std::vector<ValueType> types(1, VALUE_TYPE_BIGINT);
+        std::vector<int32_t> lengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        std::vector<bool> allowNull(1, true);
+        std::vector<std::string> names(1, "C0");
+        TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+        m_output.reset(TableFactory::buildTempTable("subquery output", schema, names, &m_limits));
+    }
+
+    // Make the output table look like a subquery produced the given rows.
+    void produce(int64_t first, int64_t count) {
+        m_output->deleteAllTempTuples();
+        TableTuple tuple = m_output->tempTuple();
+        for (int64_t i = 0; i < count; ++i) {
+            tuple.setNValue(0, ValueFactory::getBigIntValue(first + i));
+            m_output->insertTempTuple(tuple);
+        }
+        m_output->finishInserts();
+    }
+
+    // True if the output table holds exactly the rows first, first + 1, ...
+    bool holds(int64_t first, int64_t count) {
+        if (m_output->activeTupleCount() != count) {
+            return false;
+        }
+        TableTuple tuple(m_output->schema());
+        TableIterator iterator = m_output->iterator();
+        int64_t expected = first;
+        while (iterator.next(tuple)) {
+            if (ValuePeeker::peekBigInt(tuple.getNValue(0)) != expected++) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static std::vector<NValue> key(int64_t value) {
+        return std::vector<NValue>(1, ValueFactory::getBigIntValue(value));
+    }
+
+    TempTableLimits m_limits;
+    boost::scoped_ptr<TempTable> m_output;
+    SubqueryCacheCounters m_counters;
+};
+
+TEST_F(SubqueryResultCacheTest, RestoresRememberedResults)
+{
+    SubqueryResultCache cache(m_output.get(), &m_limits, &m_counters);
+    produce(10, 3);
+    cache.remember(key(1), m_output.get());
+    produce(20, 5);
+    cache.remember(key(2), m_output.get());
+    produce(0, 0);
+    cache.remember(key(3), m_output.get());
+    ASSERT_EQ(3, cache.size());
+
+    m_output->deleteAllTempTuples();
+    ASSERT_TRUE(cache.restore(key(1), m_output.get()));
+    EXPECT_TRUE(holds(10, 3));
+    m_output->deleteAllTempTuples();
+    ASSERT_TRUE(cache.restore(key(2), m_output.get()));
+    EXPECT_TRUE(holds(20, 5));
+    m_output->deleteAllTempTuples();
+    ASSERT_TRUE(cache.restore(key(3), m_output.get()));
+    EXPECT_TRUE(holds(0, 0));
+    EXPECT_FALSE(cache.restore(key(4), m_output.get()));
+    EXPECT_EQ(0, m_output->activeTupleCount());
+
+    EXPECT_EQ(3, m_counters.hits);
+    EXPECT_EQ(1, m_counters.misses);
+    EXPECT_EQ(0, m_counters.evictions);
+}
+
+TEST_F(SubqueryResultCacheTest, KeysOnAllParameters)
+{
+    SubqueryResultCache cache(m_output.get(), &m_limits, &m_counters);
+    std::vector<NValue> params;
+    params.push_back(ValueFactory::getBigIntValue(1));
+    params.push_back(ValueFactory::getBigIntValue(2));
+    produce(100, 1);
+    cache.remember(params, m_output.get());
+
+    m_output->deleteAllTempTuples();
+    params[1] = ValueFactory::getBigIntValue(3);
+    EXPECT_FALSE(cache.restore(params, m_output.get()));
+    params[1] = ValueFactory::getBigIntValue(2);
+    ASSERT_TRUE(cache.restore(params, m_output.get()));
+    EXPECT_TRUE(holds(100, 1));
+}
+
+TEST_F(SubqueryResultCacheTest, BoundsItsSize)
+{
+    SubqueryResultCache cache(m_output.get(), &m_limits, &m_counters);
+    // Large results are not cached.
+    produce(0, SubqueryResultCache::MAX_ROWS_PER_RESULT + 1);
+    cache.remember(key(0), m_output.get());
+    EXPECT_EQ(0, cache.size());
+
+    // The cache is emptied when it holds too many results.
+    produce(0, 1);
+    for (int64_t i = 0; i < SubqueryResultCache::MAX_RESULTS; ++i) {
+        cache.remember(key(i), m_output.get());
+    }
+    EXPECT_EQ(SubqueryResultCache::MAX_RESULTS, cache.size());
+    EXPECT_EQ(0, m_counters.evictions);
+    cache.remember(key(-1), m_output.get());
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(1, m_counters.evictions);
+    m_output->deleteAllTempTuples();
+    EXPECT_TRUE(cache.restore(key(-1), m_output.get()));
+    m_output->deleteAllTempTuples();
+    EXPECT_FALSE(cache.restore(key(0), m_output.get()));
+}
+
+TEST_F(SubqueryResultCacheTest, HonorsTempTableLimits)
+{
+    produce(0, 1);
+    int64_t before = m_limits.getAllocated();
+    {
+        SubqueryResultCache cache(m_output.get(), &m_limits, &m_counters);
+        cache.remember(key(1), m_output.get());
+        EXPECT_EQ(1, cache.size());
+        // The cached rows are charged to the fragment.
+        EXPECT_TRUE(m_limits.getAllocated() > before);
+
+        // Leave the cache no room for another block: it gives its
+        // memory back rather than make the query fail.
+        int64_t rest = m_limits.getMemoryLimit() - m_limits.getAllocated();
+        m_limits.increaseAllocated(static_cast<int>(rest));
+        cache.remember(key(2), m_output.get());
+        EXPECT_EQ(0, cache.size());
+        m_limits.reduceAllocated(static_cast<int>(rest));
+    }
+    // All of it is returned when the cache goes away.
+    EXPECT_EQ(before, m_limits.getAllocated());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -23,14 +23,21 @@
 #include "harness.h"
 #include "common/serializeio.h"
 #include "common/ElasticHashinator.h"
+#include "common/ThreadLocalPool.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cstdlib>
 #include <limits>
+#include <set>
+#include <vector>
 
 using namespace std;
 using namespace voltdb;
 
 class ElasticHashinatorTest : public Test {
+protected:
+    ThreadLocalPool m_pool;
 };
 
 TEST_F(ElasticHashinatorTest, TestMinMaxToken)
@@ -112,6 +119,86 @@ TEST_F(ElasticHashinatorTest, TestNValueHashToken)
     }
 }
 
+/*
+ * A 1000 token ring like a rebalanced cluster's, checked against a linear
+ * scan so that the lookup table's narrowed search can't drift.
+ */
+TEST_F(ElasticHashinatorTest, TestLookupTableMatchesSearch)
+{
+    const int tokenCount = 1000;
+    std::set<int32_t> unique;
+    unique.insert(std::numeric_limits<int32_t>::min());
+    srand(42);
+    while (unique.size() < tokenCount) {
+        unique.insert(static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand())));
+    }
+    std::vector<int32_t> tokens(unique.begin(), unique.end());
+
+    boost::scoped_array<char> config(new char[4 + (8 * tokenCount)]);
+    ReferenceSerializeOutput output(config.get(), 4 + (8 * tokenCount));
+    output.writeInt(tokenCount);
+    for (int i = 0; i < tokenCount; i++) {
+        output.writeInt(tokens[i]);
+        output.writeInt(i % 7);
+    }
+    boost::scoped_ptr<TheHashinator> hashinator(ElasticHashinator::newInstance(config.get(), NULL, 0));
+
+    std::vector<int32_t> hashes;
+    hashes.push_back(std::numeric_limits<int32_t>::min());
+    hashes.push_back(std::numeric_limits<int32_t>::max());
+    hashes.push_back(0);
+    for (int i = 0; i < tokenCount; i++) {
+        hashes.push_back(tokens[i]);
+        hashes.push_back(tokens[i] - 1);
+        hashes.push_back(tokens[i] + 1);
+    }
+    for (int i = 0; i < 100000; i++) {
+        hashes.push_back(static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand())));
+    }
+
+    for (size_t i = 0; i < hashes.size(); i++) {
+        int32_t hash = hashes[i];
+        int expected = static_cast<int>(std::upper_bound(tokens.begin(), tokens.end(), hash) - tokens.begin()) - 1;
+        ASSERT_EQ(expected % 7, hashinator->partitionForToken(hash));
+    }
+}
+
+TEST_F(ElasticHashinatorTest, TestBatchMatchesSingleValues)
+{
+    const int tokenCount = 64;
+    boost::scoped_array<char> config(new char[4 + (8 * tokenCount)]);
+    ReferenceSerializeOutput output(config.get(), 4 + (8 * tokenCount));
+    output.writeInt(tokenCount);
+    for (int i = 0; i < tokenCount; i++) {
+        output.writeInt(static_cast<int32_t>(std::numeric_limits<int32_t>::min() + static_cast<int64_t>(i) * 67108864));
+        output.writeInt(i % 5);
+    }
+    boost::scoped_ptr<TheHashinator> hashinator(ElasticHashinator::newInstance(config.get(), NULL, 0));
+
+    // Enough integers to fill several runs, mixed with values hashed one at a time
+    std::vector<NValue> values;
+    for (int i = -300; i < 300; i++) {
+        values.push_back(ValueFactory::getBigIntValue(i * 7919L));
+        if (i % 50 == 0) {
+            values.push_back(ValueFactory::getStringValue("partition key"));
+            values.push_back(NValue::getNullValue(VALUE_TYPE_BIGINT));
+            values.push_back(ValueFactory::getIntegerValue(i));
+        }
+    }
+    values.push_back(ValueFactory::getBigIntValue(std::numeric_limits<int64_t>::min()));
+    values.push_back(ValueFactory::getBigIntValue(std::numeric_limits<int64_t>::max()));
+
+    std::vector<int32_t> partitions(values.size());
+    hashinator->hashinateBatch(&values[0], static_cast<int32_t>(values.size()), &partitions[0]);
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(hashinator->hashinate(values[i]), partitions[i]);
+        if (ValuePeeker::peekValueType(values[i]) == VALUE_TYPE_VARCHAR) {
+            values[i].free();
+        }
+    }
+    EXPECT_EQ(0, partitions[values.size() - 2]);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -1950,6 +1950,98 @@ TEST_F(NValueTest, DecimalQuotients) {
    }
 }
 
+namespace {
+
+const int64_t kDecimalScale = 1000000000000LL;
+
+TTInt decimalBound() {
+    return ValuePeeker::peekDecimal(
+            ValueFactory::getDecimalValueFromString("99999999999999999999999999.999999999999"));
+}
+
+// Runs op and reports whether it agrees with a reference result, including
+// whether it throws.
+template<typename Op>
+bool decimalResultMatches(Op op, bool referenceOverflows, const TTInt& reference,
+                          const char* opName, const NValue& lhs, const NValue& rhs) {
+    bool thrown = false;
+    NValue result;
+    try {
+        result = op();
+    }
+    catch (const SQLException &) {
+        thrown = true;
+    }
+    if (thrown == referenceOverflows &&
+            (thrown || ValuePeeker::peekDecimal(result) == reference)) {
+        return true;
+    }
+    std::cout << opName << " of " << lhs.debug() << " and " << rhs.debug()
+              << " gave " << (thrown ? "an exception" : result.debug()) << std::endl;
+    return false;
+}
+
+}
+
+// DECIMAL arithmetic uses native 128 bit integers where it can; it must
+// agree exactly, overflow included, with the wide ttmath integers.
+TEST_F(NValueTest, DecimalArithmeticMatchesWideIntegers)
+{
+    const char* strings[] = {
+        "0", "1", "-1", "0.5", "0.000000000001", "-0.000000000001",
+        "3.333333333333", "-0.333333333333", "218772.7686110", "-437545.537222",
+        "9223372.036854775807", "-9223372.036854775808",
+        "100000000000000000000", "-100000000000000000000",
+        "12345678901234567890.123456789012", "50000000000000000000000000",
+        "99999999999999999999999999.999999999999", "-99999999999999999999999999.999999999999"
+    };
+    const TTInt max = decimalBound();
+    const TTInt min = -max;
+    std::vector<NValue> values;
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        values.push_back(ValueFactory::getDecimalValueFromString(strings[i]));
+    }
+
+    for (size_t i = 0; i < values.size(); i++) {
+        for (size_t j = 0; j < values.size(); j++) {
+            const NValue& lhs = values[i];
+            const NValue& rhs = values[j];
+            const TTInt l = ValuePeeker::peekDecimal(lhs);
+            const TTInt r = ValuePeeker::peekDecimal(rhs);
+
+            TTInt sum(l);
+            bool overflow = sum.Add(r) || sum > max || sum < min;
+            EXPECT_TRUE(decimalResultMatches([&]() { return lhs.op_add(rhs); }, overflow, sum,
+                                             "add", lhs, rhs));
+
+            TTInt difference(l);
+            overflow = difference.Sub(r) || difference > max || difference < min;
+            EXPECT_TRUE(decimalResultMatches([&]() { return lhs.op_subtract(rhs); }, overflow, difference,
+                                             "subtract", lhs, rhs));
+
+            TTLInt calc;
+            calc.FromInt(l);
+            calc *= r;
+            calc /= kDecimalScale;
+            TTInt product;
+            overflow = product.FromInt(calc) || product > max || product < min;
+            EXPECT_TRUE(decimalResultMatches([&]() { return lhs.op_multiply(rhs); }, overflow, product,
+                                             "multiply", lhs, rhs));
+
+            calc.FromInt(l);
+            calc *= kDecimalScale;
+            TTInt quotient;
+            overflow = r == 0 || calc.Div(r) || quotient.FromInt(calc) || quotient > max || quotient < min;
+            EXPECT_TRUE(decimalResultMatches([&]() { return lhs.op_divide(rhs); }, overflow, quotient,
+                                             "divide", lhs, rhs));
+
+            int expected = l < r ? VALUE_COMPARE_LESSTHAN :
+                    (l > r ? VALUE_COMPARE_GREATERTHAN : VALUE_COMPARE_EQUAL);
+            EXPECT_EQ(expected, lhs.compare(rhs));
+        }
+    }
+}
+
 TEST_F(NValueTest, SerializeToExport)
 {
     // test basic nvalue elt serialization. Note that
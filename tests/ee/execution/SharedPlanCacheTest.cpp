@@ -0,0 +1,139 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/PlannerDomBinary.h"
+#include "common/PlannerDomValue.h"
+#include "execution/SharedPlanCache.h"
+#include "plannodes/abstractplannode.h"
+#include "plannodes/plannodefragment.h"
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+
+using namespace voltdb;
+
+static const std::string plan =
+    "{\"PLAN_NODES\":["
+    "{\"ID\":1,\"PLAN_NODE_TYPE\":\"SEND\",\"CHILDREN_IDS\":[2]},"
+    "{\"ID\":2,\"PLAN_NODE_TYPE\":\"SEQSCAN\",\"TARGET_TABLE_NAME\":\"DTBL\","
+    "\"TARGET_TABLE_ALIAS\":\"DTBL\",\"SUBQUERY_INDICATOR\":\"TRUE\"}],"
+    "\"EXECUTE_LIST\":[2,1]}";
+
+/** Rewrite a DOM as compact JSON text. */
+static std::string toJson(const rapidjson::Value& value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+class SharedPlanCacheTest : public Test {
+};
+
+TEST_F(SharedPlanCacheTest, BinaryRoundTrip) {
+    const char* json =
+        "{\"NULL\":null,\"FLAGS\":[true,false],\"INT\":-7,\"BIG\":-9007199254740993,"
+        "\"HUGE\":18446744073709551615,\"DOUBLE\":-0.125,\"TEXT\":\"a \\\"quoted\\\"\\n\\u00e9 value\","
+        "\"NESTED\":[[],{},[{\"INT\":2147483647}]]}";
+    rapidjson::Document expected;
+    expected.Parse<0>(json);
+    ASSERT_FALSE(expected.HasParseError());
+
+    std::string binary = PlannerDomBinary::encode(json);
+    ASSERT_TRUE(PlannerDomBinary::isBinary(binary.data(), binary.size()));
+    ASSERT_FALSE(PlannerDomBinary::isBinary(json, strlen(json)));
+
+    PlannerDomRoot root(binary.data(), binary.size());
+    ASSERT_FALSE(root.hasParseError());
+    PlannerDomValue obj = root.rootObject();
+    EXPECT_EQ(-7, obj.valueForKey("INT").asInt());
+    EXPECT_EQ(-9007199254740993LL, obj.valueForKey("BIG").asInt64());
+    EXPECT_EQ(-0.125, obj.valueForKey("DOUBLE").asDouble());
+    EXPECT_FALSE(obj.hasNonNullKey("NULL"));
+
+    rapidjson::Document decoded;
+    PlannerDomBinary::decode(binary.data(), binary.size(), decoded);
+    EXPECT_EQ(toJson(expected), toJson(decoded));
+
+    // Repeated keys are stored once, so the binary plan is smaller.
+    std::string binaryPlan = PlannerDomBinary::encode(plan.c_str());
+    EXPECT_TRUE(binaryPlan.size() < plan.size());
+}
+
+TEST_F(SharedPlanCacheTest, MalformedBinaryThrows) {
+    std::string binary = PlannerDomBinary::encode(plan.c_str());
+    for (size_t length = 6; length < binary.size(); length++) {
+        bool thrown = false;
+        try {
+            PlannerDomRoot root(binary.data(), length);
+        }
+        catch (const SerializableEEException& e) {
+            thrown = true;
+        }
+        EXPECT_TRUE(thrown);
+    }
+}
+
+TEST_F(SharedPlanCacheTest, SharedAcrossLookups) {
+    SharedPlanCache cache(2);
+    boost::shared_ptr<PlannerDomRoot> first = cache.get(plan);
+    boost::shared_ptr<PlannerDomRoot> second = cache.get(plan);
+    EXPECT_EQ(first.get(), second.get());
+
+    // The binary form is a different key but loads the same fragment.
+    std::string binaryPlan = PlannerDomBinary::encode(plan.c_str());
+    boost::shared_ptr<PlannerDomRoot> binary = cache.get(binaryPlan);
+    EXPECT_NE(first.get(), binary.get());
+    boost::scoped_ptr<PlanNodeFragment> fromJson(PlanNodeFragment::createFromCatalog(plan));
+    boost::scoped_ptr<PlanNodeFragment> fromBinary(PlanNodeFragment::createFromCatalog(binaryPlan));
+    ASSERT_TRUE(fromBinary->getRootNode() != NULL);
+    EXPECT_EQ(fromJson->getRootNode()->getPlanNodeType(), fromBinary->getRootNode()->getPlanNodeType());
+    EXPECT_EQ(fromJson->getRootNode()->getChildren().size(), fromBinary->getRootNode()->getChildren().size());
+
+    // Plans that do not parse are not cached.
+    cache.get("{not json");
+    SharedPlanCacheCounters counters = cache.counters();
+    EXPECT_EQ(1, counters.hits);
+    EXPECT_EQ(3, counters.misses);
+    EXPECT_EQ(0, counters.evictions);
+    EXPECT_EQ(2, counters.plans);
+
+    // The least recently used plan goes first.
+    cache.get(plan);
+    cache.get("{\"PLAN_NODES\":[],\"EXECUTE_LIST\":[]}");
+    EXPECT_EQ(1, cache.counters().evictions);
+    EXPECT_EQ(first.get(), cache.get(plan).get());
+    EXPECT_NE(binary.get(), cache.get(binaryPlan).get());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -30,10 +30,12 @@
 
 #include "harness.h"
 
+#include "test_utils/LargeTempTableTopend.hpp"
 #include "test_utils/Tools.hpp"
 #include "test_utils/TupleComparingTest.hpp"
 #include "test_utils/UniqueEngine.hpp"
 
+#include "common/SQLException.h"
 #include "common/tabletuple.h"
 #include "execution/ExecutorVector.h"
 #include "executors/abstractexecutor.h"
@@ -627,6 +629,343 @@ const std::string jsonPlan =
     "   \"IS_LARGE_QUERY\":false\n"
     "}\n";
 
+// Plan for a recursive CTE that combines its queries with UNION, so
+// that it terminates even if the management chain has a cycle:
+//
+// WITH RECURSIVE REPORTS(EMP_ID) AS (
+//     SELECT EMP_ID FROM EMPLOYEES WHERE MANAGER_ID IS NULL
+//     UNION
+//     SELECT E.EMP_ID FROM EMPLOYEES E JOIN REPORTS R ON E.MANAGER_ID = R.EMP_ID
+// )
+// SELECT * FROM REPORTS ORDER BY EMP_ID;
+const std::string unionDistinctJsonPlan =
+    "{\n"
+    "   \"PLAN_NODES_LISTS\":[\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":0,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":2,\n"
+    "               \"PLAN_NODE_TYPE\":\"ORDERBY\",\n"
+    "               \"CHILDREN_IDS\":[3],\n"
+    "               \"SORT_COLUMNS\":[\n"
+    "                  {\n"
+    "                     \"SORT_EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0},\n"
+    "                     \"SORT_DIRECTION\":\"ASC\"\n"
+    "                  }\n"
+    "               ]\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":3,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":13,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                         \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"REPORTS\",\n"
+    "               \"IS_CTE_SCAN\":true,\n"
+    "               \"CTE_STMT_ID\":1\n"
+    "            }\n"
+    "         ]\n"
+    "      },\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":1,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":4,\n"
+    "               \"PLAN_NODE_TYPE\":\"COMMONTABLE\",\n"
+    "               \"CHILDREN_IDS\":[5],\n"
+    "               \"COMMON_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"RECURSIVE_STATEMENT_ID\":2,\n"
+    "               \"UNION_DISTINCT\":true\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":5,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":6,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                         \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"PREDICATE\":{\n"
+    "                  \"TYPE\":9,\n"
+    "                  \"VALUE_TYPE\":23,\n"
+    "                  \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}\n"
+    "               },\n"
+    "               \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"EMPLOYEES\"\n"
+    "            }\n"
+    "         ]\n"
+    "      },\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":2,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":7,\n"
+    "               \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "               \"CHILDREN_IDS\":[8],\n"
+    "               \"OUTPUT_SCHEMA\":[\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0}}\n"
+    "               ]\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":8,\n"
+    "               \"PLAN_NODE_TYPE\":\"NESTLOOP\",\n"
+    "               \"CHILDREN_IDS\":[9, 11],\n"
+    "               \"OUTPUT_SCHEMA\":[\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0}},\n"
+    "                  {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}},\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}}\n"
+    "               ],\n"
+    "               \"JOIN_TYPE\":\"INNER\",\n"
+    "               \"PRE_JOIN_PREDICATE\":null,\n"
+    "               \"JOIN_PREDICATE\":{\n"
+    "                  \"TYPE\":10,\n"
+    "                  \"VALUE_TYPE\":23,\n"
+    "                  \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0, \"TABLE_IDX\":1},\n"
+    "                  \"RIGHT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}\n"
+    "               },\n"
+    "               \"WHERE_PREDICATE\":null\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":9,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":10,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                         \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}},\n"
+    "                        {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+    "                         \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"E\"\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":11,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":12,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                         \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":0}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"R\",\n"
+    "               \"IS_CTE_SCAN\":true,\n"
+    "               \"CTE_STMT_ID\":1\n"
+    "            }\n"
+    "         ]\n"
+    "      }\n"
+    "   ],\n"
+    "   \"EXECUTE_LISTS\":[\n"
+    "      {\"EXECUTE_LIST\":[3, 2]},\n"
+    "      {\"EXECUTE_LIST\":[5, 4]},\n"
+    "      {\"EXECUTE_LIST\":[9, 11, 8, 7]}\n"
+    "   ],\n"
+    "   \"IS_LARGE_QUERY\":false\n"
+    "}\n";
+
+// The same query as unionDistinctJsonPlan, run as a large query and also
+// returning the VARCHAR LAST_NAME, whose data lives in the blocks of the
+// large temp tables rather than in the temp string pool:
+//
+// WITH RECURSIVE REPORTS(LAST_NAME, EMP_ID) AS (
+//     SELECT LAST_NAME, EMP_ID FROM EMPLOYEES WHERE MANAGER_ID IS NULL
+//     UNION
+//     SELECT E.LAST_NAME, E.EMP_ID FROM EMPLOYEES E JOIN REPORTS R ON E.MANAGER_ID = R.EMP_ID
+// )
+// SELECT * FROM REPORTS ORDER BY EMP_ID;
+const std::string largeUnionDistinctJsonPlan =
+    "{\n"
+    "   \"PLAN_NODES_LISTS\":[\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":0,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":2,\n"
+    "               \"PLAN_NODE_TYPE\":\"ORDERBY\",\n"
+    "               \"CHILDREN_IDS\":[3],\n"
+    "               \"SORT_COLUMNS\":[\n"
+    "                  {\n"
+    "                     \"SORT_EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1},\n"
+    "                     \"SORT_DIRECTION\":\"ASC\"\n"
+    "                  }\n"
+    "               ]\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":3,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":13,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"REPORTS\",\n"
+    "               \"IS_CTE_SCAN\":true,\n"
+    "               \"CTE_STMT_ID\":1\n"
+    "            }\n"
+    "         ]\n"
+    "      },\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":1,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":4,\n"
+    "               \"PLAN_NODE_TYPE\":\"COMMONTABLE\",\n"
+    "               \"CHILDREN_IDS\":[5],\n"
+    "               \"COMMON_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"RECURSIVE_STATEMENT_ID\":2,\n"
+    "               \"UNION_DISTINCT\":true\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":5,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":6,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"PREDICATE\":{\n"
+    "                  \"TYPE\":9,\n"
+    "                  \"VALUE_TYPE\":23,\n"
+    "                  \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}\n"
+    "               },\n"
+    "               \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"EMPLOYEES\"\n"
+    "            }\n"
+    "         ]\n"
+    "      },\n"
+    "      {\n"
+    "         \"STATEMENT_ID\":2,\n"
+    "         \"PLAN_NODES\":[\n"
+    "            {\n"
+    "               \"ID\":7,\n"
+    "               \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "               \"CHILDREN_IDS\":[8],\n"
+    "               \"OUTPUT_SCHEMA\":[\n"
+    "                  {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}}\n"
+    "               ]\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":8,\n"
+    "               \"PLAN_NODE_TYPE\":\"NESTLOOP\",\n"
+    "               \"CHILDREN_IDS\":[9, 11],\n"
+    "               \"OUTPUT_SCHEMA\":[\n"
+    "                  {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}},\n"
+    "                  {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}},\n"
+    "                  {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":3}},\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                    \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":4}}\n"
+    "               ],\n"
+    "               \"JOIN_TYPE\":\"INNER\",\n"
+    "               \"PRE_JOIN_PREDICATE\":null,\n"
+    "               \"JOIN_PREDICATE\":{\n"
+    "                  \"TYPE\":10,\n"
+    "                  \"VALUE_TYPE\":23,\n"
+    "                  \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1, \"TABLE_IDX\":1},\n"
+    "                  \"RIGHT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}\n"
+    "               },\n"
+    "               \"WHERE_PREDICATE\":null\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":9,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":10,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}},\n"
+    "                        {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"E\"\n"
+    "            },\n"
+    "            {\n"
+    "               \"ID\":11,\n"
+    "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+    "               \"INLINE_NODES\":[\n"
+    "                  {\n"
+    "                     \"ID\":12,\n"
+    "                     \"PLAN_NODE_TYPE\":\"PROJECTION\",\n"
+    "                     \"OUTPUT_SCHEMA\":[\n"
+    "                        {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                        {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                          \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}}\n"
+    "                     ]\n"
+    "                  }\n"
+    "               ],\n"
+    "               \"TARGET_TABLE_NAME\":\"REPORTS\",\n"
+    "               \"TARGET_TABLE_ALIAS\":\"R\",\n"
+    "               \"IS_CTE_SCAN\":true,\n"
+    "               \"CTE_STMT_ID\":1\n"
+    "            }\n"
+    "         ]\n"
+    "      }\n"
+    "   ],\n"
+    "   \"EXECUTE_LISTS\":[\n"
+    "      {\"EXECUTE_LIST\":[3, 2]},\n"
+    "      {\"EXECUTE_LIST\":[5, 4]},\n"
+    "      {\"EXECUTE_LIST\":[9, 11, 8, 7]}\n"
+    "   ],\n"
+    "   \"IS_LARGE_QUERY\":true\n"
+    "}\n";
+
 TEST_F(CommonTableExpressionTest, verifyPlan) {
     UniqueEngine engine = UniqueEngineBuilder().build();
     bool success = engine->loadCatalog(0, catalogPayload);
@@ -780,6 +1119,177 @@ TEST_F(CommonTableExpressionTest, execute) {
     }
 }
 
+TEST_F(CommonTableExpressionTest, executeUnionDistinctWithCycle) {
+    UniqueEngine engine = UniqueEngineBuilder().build();
+    bool success = engine->loadCatalog(0, catalogPayload);
+    ASSERT_TRUE(success);
+
+    // King manages Kochhar and De Haan, who both manage Hunold.
+    // Hunold in turn appears as King's manager, closing a cycle.
+    Table* employeesTable = engine->getTableByName("EMPLOYEES");
+    typedef std::tuple<std::string, int, boost::optional<int>> InRow;
+    std::vector<InRow> persistentTuples{
+        InRow{"King",      100, boost::none},
+        InRow{"Kochhar",   101, 100},
+        InRow{"De Haan",   102, 100},
+        InRow{"Hunold",    103, 101},
+        InRow{"Hunold",    103, 102},
+        InRow{"King",      100, 103},
+        InRow{"Ernst",     104, 103}
+    };
+
+    StandAloneTupleStorage storage{employeesTable->schema()};
+    TableTuple tupleToInsert = storage.tuple();
+    BOOST_FOREACH(auto initValues, persistentTuples) {
+        Tools::initTuple(&tupleToInsert, initValues);
+        employeesTable->insertTuple(tupleToInsert);
+    }
+
+    auto ev = ExecutorVector::fromJsonPlan(engine.get(), unionDistinctJsonPlan, 0);
+    ASSERT_NE(NULL, ev.get());
+    CommonTablePlanNode* ctPlanNode =
+        dynamic_cast<CommonTablePlanNode*>(ev->getExecutorList(1)[1]->getPlanNode());
+    ASSERT_NE(NULL, ctPlanNode);
+    ASSERT_TRUE(ctPlanNode->isUnionDistinct());
+    ASSERT_NE(std::string::npos, ctPlanNode->debugInfo("").find("union distinct"));
+
+    typedef std::tuple<int> OutRow;
+    std::vector<OutRow> expectedTuples{
+        OutRow{100}, OutRow{101}, OutRow{102}, OutRow{103}, OutRow{104}
+    };
+
+    // Run twice, to make sure the set of seen rows starts out empty.
+    for (int run = 0; run < 2; ++run) {
+        UniqueTempTableResult result = engine->executePlanFragment(ev.get(), NULL);
+        ASSERT_NE(NULL, result.get());
+        ASSERT_EQ(expectedTuples.size(), result->activeTupleCount());
+
+        int i = 0;
+        TableTuple iterTuple{result->schema()};
+        TableIterator iter = result->iterator();
+        while (iter.next(iterTuple)) {
+            ASSERT_TUPLES_EQ(expectedTuples[i], iterTuple);
+            ++i;
+        }
+        ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+    }
+}
+
+TEST_F(CommonTableExpressionTest, executeLargeUnionDistinctWithCycle) {
+    std::unique_ptr<Topend> topend{new LargeTempTableTopend()};
+    UniqueEngine engine = UniqueEngineBuilder()
+        .setTopend(std::move(topend))
+        .build();
+    bool success = engine->loadCatalog(0, catalogPayload);
+    ASSERT_TRUE(success);
+
+    // The same cycle as in executeUnionDistinctWithCycle.  Each name
+    // has to outlive the large temp table block it was first seen in
+    // for King and Hunold to be recognized when they come around again.
+    Table* employeesTable = engine->getTableByName("EMPLOYEES");
+    typedef std::tuple<std::string, int, boost::optional<int>> InRow;
+    std::vector<InRow> persistentTuples{
+        InRow{"King",      100, boost::none},
+        InRow{"Kochhar",   101, 100},
+        InRow{"De Haan",   102, 100},
+        InRow{"Hunold",    103, 101},
+        InRow{"Hunold",    103, 102},
+        InRow{"King",      100, 103},
+        InRow{"Ernst",     104, 103}
+    };
+
+    StandAloneTupleStorage storage{employeesTable->schema()};
+    TableTuple tupleToInsert = storage.tuple();
+    BOOST_FOREACH(auto initValues, persistentTuples) {
+        Tools::initTuple(&tupleToInsert, initValues);
+        employeesTable->insertTuple(tupleToInsert);
+    }
+
+    auto ev = ExecutorVector::fromJsonPlan(engine.get(), largeUnionDistinctJsonPlan, 0);
+    ASSERT_NE(NULL, ev.get());
+    ASSERT_TRUE(ev->isLargeQuery());
+
+    typedef std::tuple<std::string, int> OutRow;
+    std::vector<OutRow> expectedTuples{
+        OutRow{"King", 100},
+        OutRow{"Kochhar", 101},
+        OutRow{"De Haan", 102},
+        OutRow{"Hunold", 103},
+        OutRow{"Ernst", 104}
+    };
+
+    for (int run = 0; run < 2; ++run) {
+        UniqueTempTableResult result = engine->executePlanFragment(ev.get(), NULL);
+        ASSERT_NE(NULL, result.get());
+        ASSERT_EQ(expectedTuples.size(), result->activeTupleCount());
+
+        {
+            // The iterator unpins the result's blocks when it goes away,
+            // so it must go before the result releases them.
+            int i = 0;
+            TableTuple iterTuple{result->schema()};
+            TableIterator iter = result->iterator();
+            while (iter.next(iterTuple)) {
+                ASSERT_TUPLES_EQ(expectedTuples[i], iterTuple);
+                ++i;
+            }
+        }
+        result.reset();
+        ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+
+        // The copies of the rows seen so far are charged to the limits
+        // only until the CTE is done with them.
+        ASSERT_EQ(0, ev->limits()->getAllocated());
+    }
+}
+
+TEST_F(CommonTableExpressionTest, executeLargeUnionDistinctOverLimit) {
+    std::unique_ptr<Topend> topend{new LargeTempTableTopend()};
+    UniqueEngine engine = UniqueEngineBuilder()
+        .setTopend(std::move(topend))
+        .build();
+    bool success = engine->loadCatalog(0, catalogPayload);
+    ASSERT_TRUE(success);
+
+    Table* employeesTable = engine->getTableByName("EMPLOYEES");
+    typedef std::tuple<std::string, int, boost::optional<int>> InRow;
+    std::vector<InRow> persistentTuples{
+        InRow{"King",      100, boost::none},
+        InRow{"Kochhar",   101, 100},
+        InRow{"De Haan",   102, 100}
+    };
+
+    StandAloneTupleStorage storage{employeesTable->schema()};
+    TableTuple tupleToInsert = storage.tuple();
+    BOOST_FOREACH(auto initValues, persistentTuples) {
+        Tools::initTuple(&tupleToInsert, initValues);
+        employeesTable->insertTuple(tupleToInsert);
+    }
+
+    auto ev = ExecutorVector::fromJsonPlan(engine.get(), largeUnionDistinctJsonPlan, 0);
+    ASSERT_NE(NULL, ev.get());
+    ASSERT_TRUE(ev->isLargeQuery());
+
+    // Large temp tables are not charged to the limits, but the copies
+    // of the rows seen so far are, and they don't fit in the last 1KB.
+    // (The limit itself can't be lowered that far, because the large
+    // temp table block cache is sized from it.)
+    int headroom = 1024;
+    int used = static_cast<int>(engine->tempTableMemoryLimit()) - headroom;
+    ev->limits()->increaseAllocated(used);
+    std::string sqlState;
+    try {
+        engine->executePlanFragment(ev.get(), NULL);
+    }
+    catch (const SQLException& exc) {
+        sqlState = exc.getSqlState();
+    }
+    ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+    ASSERT_EQ(std::string(SQLException::volt_temp_table_memory_overflow), sqlState);
+    ASSERT_EQ(used, ev->limits()->getAllocated());
+    ev->limits()->reduceAllocated(used);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
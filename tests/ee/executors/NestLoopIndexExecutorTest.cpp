@@ -0,0 +1,313 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "harness.h"
+
+#include "test_utils/EmployeesTable.hpp"
+#include "test_utils/Tools.hpp"
+#include "test_utils/UniqueEngine.hpp"
+
+#include "common/ValuePeeker.hpp"
+#include "common/executorcontext.hpp"
+#include "common/tabletuple.h"
+#include "execution/ExecutorVector.h"
+#include "storage/AbstractTempTable.hpp"
+#include "storage/table.h"
+#include "storage/tableiterator.h"
+
+using namespace voltdb;
+
+class NestLoopIndexExecutorTest : public Test {
+};
+
+
+// The shared EMPLOYEES catalog, plus
+//
+// CREATE INDEX IDX_MANAGER_ID_HASH ON EMPLOYEES (MANAGER_ID); -- as a hash index
+// CREATE UNIQUE INDEX IDX_EMP_ID ON EMPLOYEES (EMP_ID);
+// CREATE UNIQUE INDEX IDX_EMP_ID_HASH ON EMPLOYEES (EMP_ID); -- as a hash index
+
+const std::string extraIndexes =
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES indexes IDX_MANAGER_ID_HASH\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_MANAGER_ID_HASH unique false\n"
+    "set $PREV assumeUnique false\n"
+    "set $PREV countable false\n"
+    "set $PREV type 2\n"
+    "set $PREV expressionsjson \"\"\n"
+    "set $PREV predicatejson \"\"\n"
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_MANAGER_ID_HASH columns MANAGER_ID\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_MANAGER_ID_HASH/columns#MANAGER_ID index 0\n"
+    "set $PREV column /clusters#cluster/databases#database/tables#EMPLOYEES/columns#MANAGER_ID\n"
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES indexes IDX_EMP_ID\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID unique true\n"
+    "set $PREV assumeUnique false\n"
+    "set $PREV countable true\n"
+    "set $PREV type 1\n"
+    "set $PREV expressionsjson \"\"\n"
+    "set $PREV predicatejson \"\"\n"
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID columns EMP_ID\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID/columns#EMP_ID index 0\n"
+    "set $PREV column /clusters#cluster/databases#database/tables#EMPLOYEES/columns#EMP_ID\n"
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES indexes IDX_EMP_ID_HASH\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID_HASH unique true\n"
+    "set $PREV assumeUnique false\n"
+    "set $PREV countable false\n"
+    "set $PREV type 2\n"
+    "set $PREV expressionsjson \"\"\n"
+    "set $PREV predicatejson \"\"\n"
+    "add /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID_HASH columns EMP_ID\n"
+    "set /clusters#cluster/databases#database/tables#EMPLOYEES/indexes#IDX_EMP_ID_HASH/columns#EMP_ID index 0\n"
+    "set $PREV column /clusters#cluster/databases#database/tables#EMPLOYEES/columns#EMP_ID\n";
+
+static const std::string employeesSchema =
+    "                  {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0}},\n"
+    "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1}},\n"
+    "                  {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+    "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2}}";
+
+// E.EMP_ID > 100
+static const std::string highEmpIdPredicate =
+    "{\"TYPE\":13, \"VALUE_TYPE\":23,"
+    " \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1},"
+    " \"RIGHT\":{\"TYPE\":30, \"VALUE_TYPE\":5, \"ISNULL\":false, \"VALUE\":100}}";
+
+// A plan for
+//
+// SELECT * FROM EMPLOYEES E <joinType> JOIN EMPLOYEES M
+//   ON E.<outerKey> = M.<column of indexName> [AND <preJoinPredicate>] [LIMIT <limit>];
+//
+// looking up the inner rows in the index for each outer row.  With
+// materializeOuter, the outer scan has a (trivially true) predicate, so
+// the outer rows come from a temp table rather than EMPLOYEES itself.
+static std::string nestLoopIndexPlan(const std::string& joinType,
+                                     int outerKeyIdx,
+                                     const std::string& indexName,
+                                     bool materializeOuter,
+                                     const std::string& preJoinPredicate = "null",
+                                     int limit = -1) {
+    std::ostringstream plan;
+    plan <<
+        "{\n"
+        "   \"PLAN_NODES_LISTS\":[\n"
+        "      {\n"
+        "         \"STATEMENT_ID\":0,\n"
+        "         \"PLAN_NODES\":[\n"
+        "            {\n"
+        "               \"ID\":1,\n"
+        "               \"PLAN_NODE_TYPE\":\"NESTLOOPINDEX\",\n"
+        "               \"CHILDREN_IDS\":[2],\n"
+        "               \"INLINE_NODES\":[\n"
+        "                  {\n"
+        "                     \"ID\":3,\n"
+        "                     \"PLAN_NODE_TYPE\":\"INDEXSCAN\",\n"
+        "                     \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+        "                     \"TARGET_TABLE_ALIAS\":\"M\",\n"
+        "                     \"OUTPUT_SCHEMA\":[\n" << employeesSchema << "\n"
+        "                     ],\n"
+        "                     \"TARGET_INDEX_NAME\":\"" << indexName << "\",\n"
+        "                     \"LOOKUP_TYPE\":\"EQ\",\n"
+        "                     \"SORT_DIRECTION\":\"INVALID\",\n"
+        "                     \"SEARCHKEY_EXPRESSIONS\":[{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":"
+                                                       << outerKeyIdx << "}],\n"
+        "                     \"COMPARE_NOTDISTINCT\":[false]\n"
+        "                  }";
+    if (limit >= 0) {
+        plan << ",\n"
+        "                  {\"ID\":4, \"PLAN_NODE_TYPE\":\"LIMIT\", \"LIMIT\":" << limit << ", \"OFFSET\":0}";
+    }
+    plan << "\n"
+        "               ],\n"
+        "               \"OUTPUT_SCHEMA\":[\n" << employeesSchema << ",\n"
+        "                  {\"COLUMN_NAME\":\"LAST_NAME\",\n"
+        "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":9, \"VALUE_SIZE\":20, \"COLUMN_IDX\":0, \"TABLE_IDX\":1}},\n"
+        "                  {\"COLUMN_NAME\":\"EMP_ID\",\n"
+        "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1, \"TABLE_IDX\":1}},\n"
+        "                  {\"COLUMN_NAME\":\"MANAGER_ID\",\n"
+        "                   \"EXPRESSION\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":2, \"TABLE_IDX\":1}}\n"
+        "               ],\n"
+        "               \"JOIN_TYPE\":\"" << joinType << "\",\n"
+        "               \"PRE_JOIN_PREDICATE\":" << preJoinPredicate << ",\n"
+        "               \"JOIN_PREDICATE\":null,\n"
+        "               \"WHERE_PREDICATE\":null\n"
+        "            },\n"
+        "            {\n"
+        "               \"ID\":2,\n"
+        "               \"PLAN_NODE_TYPE\":\"SEQSCAN\",\n"
+        "               \"OUTPUT_SCHEMA\":[\n" << employeesSchema << "\n"
+        "               ],\n";
+    if (materializeOuter) {
+        plan <<
+        "               \"PREDICATE\":{\"TYPE\":13, \"VALUE_TYPE\":23,"
+                                     " \"LEFT\":{\"TYPE\":32, \"VALUE_TYPE\":5, \"COLUMN_IDX\":1},"
+                                     " \"RIGHT\":{\"TYPE\":30, \"VALUE_TYPE\":5, \"ISNULL\":false, \"VALUE\":0}},\n";
+    }
+    plan <<
+        "               \"TARGET_TABLE_NAME\":\"EMPLOYEES\",\n"
+        "               \"TARGET_TABLE_ALIAS\":\"E\"\n"
+        "            }\n"
+        "         ]\n"
+        "      }\n"
+        "   ],\n"
+        "   \"EXECUTE_LISTS\":[\n"
+        "      {\"EXECUTE_LIST\":[2, 1]}\n"
+        "   ],\n"
+        "   \"IS_LARGE_QUERY\":false\n"
+        "}\n";
+    return plan.str();
+}
+
+// Enough employees to fill several batches of index probes.  Every
+// eleventh has no manager, and the first three's manager (0) is not an
+// employee.
+const int NUM_EMPLOYEES = 150;
+
+static boost::optional<int> managerOf(int empId) {
+    if (empId % 11 == 0) {
+        return boost::none;
+    }
+    return empId / 4;
+}
+
+// The (E.EMP_ID, M.EMP_ID) pairs for E.<outerKey> = M.<innerKey>, in
+// outer order, with -1 for the NULL padding of a left join and only the
+// outer rows with E.EMP_ID > minOuterEmpId eligible to match.
+static std::vector<EmpIdPair> expectedPairs(bool managersReports, bool leftJoin, int minOuterEmpId = 0) {
+    std::vector<EmpIdPair> expected;
+    for (int outer = 1; outer <= NUM_EMPLOYEES; ++outer) {
+        bool matched = false;
+        for (int inner = 1; outer > minOuterEmpId && inner <= NUM_EMPLOYEES; ++inner) {
+            boost::optional<int> manager = managersReports ? managerOf(inner) : managerOf(outer);
+            int managed = managersReports ? outer : inner;
+            if (manager && *manager == managed) {
+                expected.push_back(EmpIdPair(outer, inner));
+                matched = true;
+            }
+        }
+        if (leftJoin && ! matched) {
+            expected.push_back(EmpIdPair(outer, -1));
+        }
+    }
+    return expected;
+}
+
+// Run the plan and return the (E.EMP_ID, M.EMP_ID) pairs it produces,
+// with -1 for NULL, sorted within each outer row, and check that the
+// outer rows came out in the order they were scanned.
+static std::vector<EmpIdPair> runPlan(VoltDBEngine* engine, const std::string& jsonPlan, bool& inOuterOrder) {
+    std::vector<EmpIdPair> empIds;
+    auto ev = ExecutorVector::fromJsonPlan(engine, jsonPlan, 0);
+    UniqueTempTableResult result = engine->executePlanFragment(ev.get(), NULL);
+    TableTuple tuple{result->schema()};
+    TableIterator iter = result->iterator();
+    while (iter.next(tuple)) {
+        empIds.push_back(EmpIdPair(empIdOrNone(tuple.getNValue(1)), empIdOrNone(tuple.getNValue(4))));
+    }
+    result.reset();
+    ExecutorContext::getExecutorContext()->cleanupAllExecutors();
+    inOuterOrder = std::is_sorted(empIds.begin(), empIds.end(),
+                                  [](const EmpIdPair& lhs, const EmpIdPair& rhs) {
+                                      return lhs.first < rhs.first;
+                                  });
+    std::sort(empIds.begin(), empIds.end());
+    return empIds;
+}
+
+TEST_F(NestLoopIndexExecutorTest, multiMapLookups) {
+    UniqueEngine engine = UniqueEngineBuilder().build();
+    ASSERT_TRUE(engine->loadCatalog(0, employeesCatalogPayload(extraIndexes)));
+    loadNumberedEmployees(engine.get(), NUM_EMPLOYEES, managerOf);
+
+    // Each employee with their reports
+    for (std::string index : {"IDX_MANAGER_ID", "IDX_MANAGER_ID_HASH"}) {
+        for (bool materializeOuter : {false, true}) {
+            bool inOuterOrder = false;
+            EXPECT_EQ(expectedPairs(true, false),
+                      runPlan(engine.get(), nestLoopIndexPlan("INNER", 1, index, materializeOuter), inOuterOrder));
+            EXPECT_TRUE(inOuterOrder);
+            EXPECT_EQ(expectedPairs(true, true),
+                      runPlan(engine.get(), nestLoopIndexPlan("LEFT", 1, index, materializeOuter), inOuterOrder));
+            EXPECT_TRUE(inOuterOrder);
+        }
+    }
+}
+
+TEST_F(NestLoopIndexExecutorTest, uniqueLookups) {
+    UniqueEngine engine = UniqueEngineBuilder().build();
+    ASSERT_TRUE(engine->loadCatalog(0, employeesCatalogPayload(extraIndexes)));
+    loadNumberedEmployees(engine.get(), NUM_EMPLOYEES, managerOf);
+
+    // Each employee with their manager.  A NULL manager id is never
+    // looked up, and manager 0 is not found.
+    for (std::string index : {"IDX_EMP_ID", "IDX_EMP_ID_HASH"}) {
+        for (bool materializeOuter : {false, true}) {
+            bool inOuterOrder = false;
+            EXPECT_EQ(expectedPairs(false, false),
+                      runPlan(engine.get(), nestLoopIndexPlan("INNER", 2, index, materializeOuter), inOuterOrder));
+            EXPECT_TRUE(inOuterOrder);
+            EXPECT_EQ(expectedPairs(false, true),
+                      runPlan(engine.get(), nestLoopIndexPlan("LEFT", 2, index, materializeOuter), inOuterOrder));
+            EXPECT_TRUE(inOuterOrder);
+        }
+    }
+}
+
+TEST_F(NestLoopIndexExecutorTest, preJoinPredicateAndLimit) {
+    UniqueEngine engine = UniqueEngineBuilder().build();
+    ASSERT_TRUE(engine->loadCatalog(0, employeesCatalogPayload(extraIndexes)));
+    loadNumberedEmployees(engine.get(), NUM_EMPLOYEES, managerOf);
+
+    // Outer rows failing the pre-join predicate are not looked up but are
+    // still padded by a left join.
+    bool inOuterOrder = false;
+    EXPECT_EQ(expectedPairs(true, true, 100),
+              runPlan(engine.get(),
+                      nestLoopIndexPlan("LEFT", 1, "IDX_MANAGER_ID", true, highEmpIdPredicate), inOuterOrder));
+    EXPECT_TRUE(inOuterOrder);
+
+    // A limit stops the join after the first outer rows' matches.
+    std::vector<EmpIdPair> expected = expectedPairs(true, false);
+    expected.resize(7);
+    EXPECT_EQ(expected,
+              runPlan(engine.get(),
+                      nestLoopIndexPlan("INNER", 1, "IDX_MANAGER_ID", false, "null", 7), inOuterOrder));
+    EXPECT_TRUE(inOuterOrder);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
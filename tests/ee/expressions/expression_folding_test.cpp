@@ -0,0 +1,177 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2019 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "common/executorcontext.hpp"
+#include "common/PlannerDomValue.h"
+#include "common/Pool.hpp"
+#include "common/SQLException.h"
+#include "common/TupleSchemaBuilder.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "expressions/abstractexpression.h"
+#include "expressions/commonsubexpression.h"
+#include "plannodes/abstractscannode.h"
+#include "plannodes/projectionnode.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+
+using namespace voltdb;
+
+namespace {
+
+std::string constant(int64_t value) {
+    return "{\"TYPE\":30,\"VALUE_TYPE\":6,\"ISNULL\":false,\"VALUE\":" + std::to_string(value) + "}";
+}
+
+std::string parameter(int index) {
+    return "{\"TYPE\":31,\"VALUE_TYPE\":6,\"PARAM_IDX\":" + std::to_string(index) + "}";
+}
+
+std::string column(int index) {
+    return "{\"TYPE\":32,\"VALUE_TYPE\":6,\"COLUMN_IDX\":" + std::to_string(index) + "}";
+}
+
+std::string binary(ExpressionType type, ValueType valueType,
+                   const std::string &left, const std::string &right) {
+    return "{\"TYPE\":" + std::to_string(type) + ",\"VALUE_TYPE\":" + std::to_string(valueType) +
+        ",\"LEFT\":" + left + ",\"RIGHT\":" + right + "}";
+}
+
+AbstractExpression* build(const std::string &json) {
+    PlannerDomRoot root(json.c_str());
+    return AbstractExpression::buildExpressionTree(root.rootObject());
+}
+
+}
+
+class ExpressionFoldingTest : public Test {
+public:
+    ExpressionFoldingTest() {
+        m_context.reset(newContext());
+    }
+
+    ExecutorContext* newContext() {
+        return new ExecutorContext(0, 0, NULL, NULL, &m_pool, (VoltDBEngine*)NULL,
+                                   "", 0, NULL, NULL, 0);
+    }
+
+protected:
+    Pool m_pool;
+    boost::scoped_ptr<ExecutorContext> m_context;
+};
+
+TEST_F(ExpressionFoldingTest, ConstantSubtreeBecomesConstant) {
+    boost::scoped_ptr<AbstractExpression> expr(
+        build(binary(EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT, constant(1), constant(4))));
+
+    EXPECT_EQ(EXPRESSION_TYPE_VALUE_CONSTANT, expr->getExpressionType());
+    EXPECT_EQ(VALUE_TYPE_BIGINT, expr->getValueType());
+    EXPECT_EQ(5, ValuePeeker::peekAsBigInt(expr->eval(NULL, NULL)));
+}
+
+TEST_F(ExpressionFoldingTest, FailingConstantSubtreeFailsOnlyWhenEvaluated) {
+    boost::scoped_ptr<AbstractExpression> expr(
+        build(binary(EXPRESSION_TYPE_OPERATOR_DIVIDE, VALUE_TYPE_BIGINT, constant(1), constant(0))));
+
+    EXPECT_EQ(EXPRESSION_TYPE_OPERATOR_DIVIDE, expr->getExpressionType());
+    bool thrown = false;
+    try {
+        expr->eval(NULL, NULL);
+    }
+    catch (const SQLException &) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+}
+
+TEST_F(ExpressionFoldingTest, ParameterSubtreeIsEvaluatedOncePerExecution) {
+    NValueArray &params = m_context->getParameterContainer();
+    params[0] = ValueFactory::getBigIntValue(3);
+    boost::scoped_ptr<AbstractExpression> expr(
+        build(binary(EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT, parameter(0), constant(1))));
+
+    EXPECT_EQ(EXPRESSION_TYPE_OPERATOR_PLUS, expr->getExpressionType());
+    EXPECT_EQ(4, ValuePeeker::peekAsBigInt(expr->eval(NULL, NULL)));
+
+    // Parameters only change between executions, so a change within one is not seen.
+    params[0] = ValueFactory::getBigIntValue(10);
+    EXPECT_EQ(4, ValuePeeker::peekAsBigInt(expr->eval(NULL, NULL)));
+
+    // Running under another site's context does not reuse the cached value.
+    boost::scoped_ptr<ExecutorContext> other(newContext());
+    EXPECT_EQ(11, ValuePeeker::peekAsBigInt(expr->eval(NULL, NULL)));
+}
+
+TEST_F(ExpressionFoldingTest, ScanPredicateSharesWithInlineProjection) {
+    std::string sum = binary(EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT, column(0), column(1));
+    std::string plan =
+        "{\"ID\":1,\"PLAN_NODE_TYPE\":\"SEQSCAN\",\"TARGET_TABLE_NAME\":\"T\",\"SUBQUERY_INDICATOR\":true,"
+        "\"PREDICATE\":" + binary(EXPRESSION_TYPE_COMPARE_GREATERTHAN, VALUE_TYPE_BOOLEAN, sum, constant(5)) + ","
+        "\"INLINE_NODES\":[{\"ID\":2,\"PLAN_NODE_TYPE\":\"PROJECTION\","
+        "\"OUTPUT_SCHEMA\":[{\"COLUMN_NAME\":\"S\",\"EXPRESSION\":" + sum + "}]}]}";
+    PlannerDomRoot root(plan.c_str());
+    boost::scoped_ptr<AbstractPlanNode> node(AbstractPlanNode::fromJSONObject(root.rootObject()));
+
+    AbstractExpression *predicate = static_cast<AbstractScanPlanNode*>(node.get())->getPredicate();
+    ProjectionPlanNode *projection =
+        static_cast<ProjectionPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
+    AbstractExpression *projected = projection->getOutputColumnExpressions()[0];
+    ASSERT_NE(NULL, dynamic_cast<CommonSubexpressionRowStart*>(predicate));
+    ASSERT_NE(NULL, dynamic_cast<CommonSubexpression*>(projected));
+    EXPECT_EQ(EXPRESSION_TYPE_COMPARE_GREATERTHAN, predicate->getExpressionType());
+    EXPECT_EQ(EXPRESSION_TYPE_OPERATOR_PLUS, projected->getExpressionType());
+
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    TupleSchema *schema = builder.build();
+    StandAloneTupleStorage storage(schema);
+    TupleSchema::freeTupleSchema(schema);
+    TableTuple &tuple = storage.tuple();
+
+    tuple.setNValue(0, ValueFactory::getBigIntValue(2));
+    tuple.setNValue(1, ValueFactory::getBigIntValue(4));
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isTrue());
+    // The projection reuses the sum computed by the predicate for this row.
+    tuple.setNValue(1, ValueFactory::getBigIntValue(40));
+    EXPECT_EQ(6, ValuePeeker::peekAsBigInt(projected->eval(&tuple, NULL)));
+
+    // The next row starts with the predicate and recomputes it.
+    tuple.setNValue(0, ValueFactory::getBigIntValue(1));
+    tuple.setNValue(1, ValueFactory::getBigIntValue(2));
+    EXPECT_FALSE(predicate->eval(&tuple, NULL).isTrue());
+    EXPECT_EQ(3, ValuePeeker::peekAsBigInt(projected->eval(&tuple, NULL)));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
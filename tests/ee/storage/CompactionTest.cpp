@@ -34,6 +34,7 @@
 #include "execution/VoltDBEngine.h"
 #include "indexes/tableindex.h"
 #include "indexes/tableindexfactory.h"
+#include "storage/CompactionScheduler.h"
 #include "storage/DRTupleStream.h"
 #include "storage/persistenttable.h"
 #include "storage/tableiterator.h"
@@ -381,6 +382,71 @@ TEST_F(CompactionTest, BasicCompaction) {
     ASSERT_EQ( m_table->activeTupleCount(), 0);
 }
 
+/*
+ * The tick driven scheduler must never move more tuples per call than its
+ * budget allows, and repeated calls must reach the same end state as a
+ * forced compaction.
+ */
+TEST_F(CompactionTest, IncrementalCompactionWithinBudget) {
+    initTable();
+#ifdef MEMCHECK
+    int tupleCount = 1000;
+#else
+    int tupleCount = 645260;
+#endif
+    addRandomUniqueTuples(m_table, tupleCount);
+    size_t blocksBefore = m_table->m_data.size();
+
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+    for (int ii = 0; ii < tupleCount; ii += 2) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        m_table->deleteTuple(tuple, true);
+    }
+    ASSERT_TRUE(m_table->compactionPredicate());
+
+    const int32_t tuplesPerTick = 5000;
+    CompactionScheduler scheduler(tuplesPerTick, INT64_MAX);
+    std::vector<PersistentTable*> tables(1, m_table);
+    int ticks = 0;
+    int32_t moved;
+    do {
+        moved = scheduler.compact(tables);
+        ASSERT_TRUE(moved <= tuplesPerTick);
+        ticks++;
+    } while (moved > 0);
+    ASSERT_TRUE(ticks > 2);
+    ASSERT_FALSE(m_table->compactionPredicate());
+
+    const CompactionSchedulerCounters& counters = scheduler.counters();
+    PersistentTableStats* stats = m_table->getPersistentTableStats();
+    ASSERT_EQ(0, counters.tablesPending);
+    ASSERT_EQ(stats->getCompactedTuples(), counters.tuplesMoved);
+    ASSERT_EQ(blocksBefore - m_table->m_data.size(), counters.blocksReclaimed);
+    ASSERT_EQ(counters.blocksReclaimed * m_table->getTableAllocationSize(), counters.bytesReclaimed);
+    ASSERT_TRUE(counters.blocksReclaimed > 0);
+
+    // Every surviving tuple is still reachable through every index.
+    int found = 0;
+    TableIterator iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        key.setNValue(0, tuple.getNValue(0));
+        for (int ii = 0; ii < 4; ii++) {
+            ASSERT_TRUE(m_table->m_indexes[ii]->moveToKey(&key, indexCursor));
+            TableTuple indexTuple = m_table->m_indexes[ii]->nextValueAtKey(indexCursor);
+            ASSERT_EQ(indexTuple.address(), tuple.address());
+        }
+        found++;
+    }
+    ASSERT_EQ(tupleCount / 2, found);
+}
+
 TEST_F(CompactionTest, CompactionWithCopyOnWrite) {
     initTable();
 #ifdef MEMCHECK
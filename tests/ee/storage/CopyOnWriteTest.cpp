@@ -1990,6 +1990,91 @@ TEST_F(CopyOnWriteTest, SnapshotAndIndex) {
     }
 }
 
+/**
+ * Tests that materializing an elastic index range copes with tuples being
+ * deleted and moved by compaction between streamMore() calls.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexReadWithDeleteAndCompaction) {
+    const int NUM_PARTITIONS = 1;
+    const int TUPLES_PER_BLOCK = 50;
+    const int NUM_INITIAL = 1000;
+    const int DELETES_PER_CHUNK = 30;
+    const size_t CHUNK_SIZE = 4096;
+
+    ElasticTableScrambler tableScrambler(*this,
+                                         NUM_PARTITIONS, TUPLES_PER_BLOCK, NUM_INITIAL,
+                                         0, 0, 0, 0);
+    tableScrambler.initialize();
+
+    T_HashRange range(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+    std::vector<std::string> predicateStrings;
+    predicateStrings.push_back(generateHashRangePredicate(range));
+    streamElasticIndex(predicateStrings, true);
+
+    T_ValueSet originalTuples;
+    getTableValueSet(originalTuples);
+    size_t allocatedBefore = m_table->allocatedTupleCount();
+
+    boost::shared_ptr<ReferenceSerializeInputBE> predicateInput = getHashRangePredicateInput(range);
+    m_engine->setUndoToken(m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                 0, 0, 0, 0, false);
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_ELASTIC_INDEX_READ, 0, m_tableId, *predicateInput));
+
+    T_ValueSet streamedTuples;
+    T_ValueSet deletedTuples;
+    size_t nChunks = 0;
+    bool compacted = false;
+    while (true) {
+        TupleOutputStreamProcessor outputStreams(m_serializationBuffer, CHUNK_SIZE);
+        TupleOutputStream &outputStream = outputStreams.at(0);
+        std::vector<int> retPositions;
+        int64_t remaining = m_table->streamMore(outputStreams, TABLE_STREAM_ELASTIC_INDEX_READ, retPositions);
+        ASSERT_LE(0, remaining);
+        const int serialized = static_cast<int>(outputStream.position());
+        if (serialized == 0) {
+            break;
+        }
+        nChunks++;
+        for (size_t ii = sizeof(int32_t)*3; // skip partition id, row count, and first tuple length
+             ii + sizeof(int64_t) <= serialized;
+             ii += m_tupleWidth + sizeof(int32_t)) {
+            int values[2];
+            values[0] = ntohl(*reinterpret_cast<const int32_t*>(&m_serializationBuffer[ii]));
+            values[1] = ntohl(*reinterpret_cast<const int32_t*>(&m_serializationBuffer[ii + 4]));
+            void *valuesVoid = reinterpret_cast<void*>(values);
+            const int64_t *values64 = reinterpret_cast<const int64_t*>(valuesVoid);
+            ASSERT_TRUE(originalTuples.find(*values64) != originalTuples.end());
+            ASSERT_TRUE(deletedTuples.find(*values64) == deletedTuples.end());
+            ASSERT_TRUE(streamedTuples.insert(*values64).second);
+        }
+        if (remaining == 0) {
+            break;
+        }
+
+        // Delete some tuples, streamed or not, and compact what is left.
+        for (int jj = 0; jj < DELETES_PER_CHUNK; jj++) {
+            doRandomDelete(m_table, &deletedTuples);
+        }
+        m_engine->releaseUndoToken(m_undoToken, false);
+        m_engine->setUndoToken(++m_undoToken);
+        ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                     0, 0, 0, 0, false);
+        doForcedCompaction(m_table);
+        compacted = compacted || m_table->allocatedTupleCount() < allocatedBefore;
+    }
+    m_engine->releaseUndoToken(m_undoToken, false);
+    m_undoToken++;
+
+    ASSERT_LE(2, nChunks);
+    ASSERT_TRUE(compacted);
+    // Every tuple was either streamed or deleted first, and the streamed ones are gone.
+    T_ValueSet accounted(streamedTuples);
+    accounted.insert(deletedTuples.begin(), deletedTuples.end());
+    ASSERT_TRUE(originalTuples == accounted);
+    ASSERT_EQ(0, m_table->activeTupleCount());
+}
+
 TEST_F(CopyOnWriteTest, ElasticIndexLowerUpperBounds) {
     ElasticIndex index;
     ElasticIndexKey key1(1, (char *)&index);
@@ -1168,6 +1168,44 @@ TEST_F(DRBinaryLogTest, PartitionedTableNoRollbacks) {
     EXPECT_EQ(0, committed.seqNum);
 }
 
+TEST_F(DRBinaryLogTest, CompressedBuffers) {
+    m_drStream.setCompressBuffers(true);
+
+    // One transaction big enough to spill into a large, compressible buffer
+    const int rowCount = 60;
+    beginTxn(m_engine, 99, 99, 98, 70);
+    for (int i = 0; i < rowCount; ++i) {
+        insertTuple(m_table, prepareTempTuple(m_table, 42, i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    }
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    EXPECT_EQ(rowCount, m_tableReplica->activeTupleCount());
+    ASSERT_TRUE(m_drStream.bytesBeforeCompression() > 0);
+    ASSERT_TRUE(m_drStream.bytesAfterCompression() < m_drStream.bytesBeforeCompression());
+    m_drStream.setCompressBuffers(false);
+}
+
+TEST_F(DRBinaryLogTest, NoCompressionForOlderProtocol) {
+    // A consumer that negotiated an older protocol cannot read compressed logs
+    m_drStream.setDrProtocolVersion(DRTupleStream::ELASTICADD_PROTOCOL_VERSION);
+    m_drStream.setCompressBuffers(true);
+
+    const int rowCount = 60;
+    beginTxn(m_engine, 99, 99, 98, 70);
+    for (int i = 0; i < rowCount; ++i) {
+        insertTuple(m_table, prepareTempTuple(m_table, 42, i, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    }
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    EXPECT_EQ(rowCount, m_tableReplica->activeTupleCount());
+    EXPECT_EQ(0, m_drStream.bytesBeforeCompression());
+    m_drStream.setCompressBuffers(false);
+}
+
 TEST_F(DRBinaryLogTest, PartitionedTableRollbacks) {
     m_singleColumnTable->setDR(false);
 
@@ -1384,6 +1422,55 @@ TEST_F(DRBinaryLogTest, DeleteWithUniqueIndexMultipleTables) {
     EXPECT_EQ(0, m_otherTableWithoutIndexReplica->activeTupleCount());
 }
 
+TEST_F(DRBinaryLogTest, BatchedApplyKeepsPerTableOrder) {
+    createIndexes();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        // The second pass applies in log order, which must give the same result
+        m_sinkWrapper.setBatchedApply(pass == 0);
+        int64_t txnId = 99 + 2 * pass;
+
+        // Interleave the tables, and insert, delete and re-insert the same key so that
+        // reordering records within a table would fail the apply
+        beginTxn(m_engine, txnId, txnId, txnId - 1, 70 + 2 * pass);
+        TableTuple temp_tuple = m_otherTableWithIndex->tempTuple();
+        temp_tuple.setNValue(0, ValueFactory::getTinyIntValue(0));
+        temp_tuple.setNValue(1, ValueFactory::getBigIntValue(1));
+        TableTuple first_tuple = insertTuple(m_otherTableWithIndex, temp_tuple);
+        TableTuple second_tuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+        deleteTuple(m_otherTableWithIndex, first_tuple);
+        temp_tuple = m_otherTableWithoutIndex->tempTuple();
+        temp_tuple.setNValue(0, ValueFactory::getTinyIntValue(2));
+        temp_tuple.setNValue(1, ValueFactory::getBigIntValue(3));
+        TableTuple third_tuple = insertTuple(m_otherTableWithoutIndex, temp_tuple);
+        temp_tuple = m_otherTableWithIndex->tempTuple();
+        temp_tuple.setNValue(0, ValueFactory::getTinyIntValue(0));
+        temp_tuple.setNValue(1, ValueFactory::getBigIntValue(1));
+        TableTuple fourth_tuple = insertTuple(m_otherTableWithIndex, temp_tuple);
+        endTxn(m_engine, true);
+
+        flushAndApply(txnId);
+
+        EXPECT_EQ(1, m_tableReplica->activeTupleCount());
+        EXPECT_EQ(1, m_otherTableWithIndexReplica->activeTupleCount());
+        EXPECT_EQ(1, m_otherTableWithoutIndexReplica->activeTupleCount());
+        ASSERT_FALSE(m_otherTableWithIndexReplica->lookupTupleForDR(fourth_tuple).isNullTuple());
+
+        // Empty all the tables again in one transaction
+        beginTxn(m_engine, txnId + 1, txnId + 1, txnId, 71 + 2 * pass);
+        deleteTuple(m_otherTableWithIndex, fourth_tuple);
+        deleteTuple(m_table, second_tuple);
+        deleteTuple(m_otherTableWithoutIndex, third_tuple);
+        endTxn(m_engine, true);
+
+        flushAndApply(txnId + 1);
+
+        EXPECT_EQ(0, m_tableReplica->activeTupleCount());
+        EXPECT_EQ(0, m_otherTableWithIndexReplica->activeTupleCount());
+        EXPECT_EQ(0, m_otherTableWithoutIndexReplica->activeTupleCount());
+    }
+}
+
 TEST_F(DRBinaryLogTest, DeleteWithUniqueIndexNullColumn) {
     createIndexes();
 
@@ -715,6 +715,88 @@ TEST_F(ExportTupleStreamTest, PartialRollback)
     EXPECT_EQ(results->getRowCount(), 1);
 }
 
+/**
+ * Append a batch spanning several buffers with appendTuples and check that
+ * the buffers are identical to the ones built by appending row by row.
+ */
+TEST_F(ExportTupleStreamTest, BatchedAppendMatchesRowByRow)
+{
+    const int rowCount = m_tuplesToFill * 2 + 3;
+    std::vector<char> storage(rowCount * m_schema->tupleLength() + TUPLE_HEADER_SIZE * rowCount, 0);
+    std::vector<TableTuple> tuples;
+    for (int i = 0; i < rowCount; i++) {
+        TableTuple tuple(&storage[i * (m_schema->tupleLength() + TUPLE_HEADER_SIZE)], m_schema);
+        for (int col = 0; col < COLUMN_COUNT; col++) {
+            tuple.setNValue(col, ValueFactory::getIntegerValue(rand()));
+        }
+        tuples.push_back(tuple);
+    }
+    int64_t uniqueId = UniqueId::makeIdFromComponents(1 + VOLT_EPOCH_IN_MILLIS, 0, 0);
+
+    for (int i = 0; i < rowCount; i++) {
+        m_wrapper->appendTuple(m_engine, 1, i + 1, uniqueId, tuples[i], 1, ExportTupleStream::INSERT);
+    }
+    m_wrapper->commit(m_engine, 1, uniqueId);
+    periodicFlush(-1, 1);
+    std::deque<boost::shared_ptr<ExportStreamBlock> > rowByRow;
+    rowByRow.swap(m_topend.exportBlocks);
+
+    ExportTupleStream batched(1, 1, 0, "sign", m_tableName, m_columnNames);
+    batched.setDefaultCapacityForTest(BUFFER_SIZE);
+    EXPECT_EQ(0, batched.appendTuples(m_engine, 1, 1, uniqueId, tuples, 1, ExportTupleStream::INSERT));
+    EXPECT_EQ(rowCount + 1, batched.getSequenceNumber());
+    EXPECT_EQ(m_wrapper->bytesUsed(), batched.bytesUsed());
+    batched.commit(m_engine, 1, uniqueId);
+    batched.periodicFlush(-1, 1);
+    *m_engine->getNewestExportStreamWithPendingRowsForAssignment() = NULL;
+    *m_engine->getOldestExportStreamWithPendingRowsForAssignment() = NULL;
+
+    ASSERT_EQ(3, rowByRow.size());
+    ASSERT_EQ(rowByRow.size(), m_topend.exportBlocks.size());
+    for (int i = 0; i < rowByRow.size(); i++) {
+        boost::shared_ptr<ExportStreamBlock> expected = rowByRow[i];
+        boost::shared_ptr<ExportStreamBlock> actual = m_topend.exportBlocks[i];
+        EXPECT_EQ(expected->uso(), actual->uso());
+        EXPECT_EQ(expected->getRowCount(), actual->getRowCount());
+        EXPECT_EQ(expected->startSequenceNumber(), actual->startSequenceNumber());
+        // Each block of the batch carries the transaction's uniqueId
+        EXPECT_EQ(uniqueId, expected->lastSpUniqueId());
+        EXPECT_EQ(uniqueId, actual->lastSpUniqueId());
+        ASSERT_EQ(expected->offset(), actual->offset());
+        EXPECT_EQ(0, ::memcmp(expected->rawPtr() + expected->headerSize(),
+                              actual->rawPtr() + actual->headerSize(), expected->offset()));
+    }
+}
+
+/**
+ * A batch spanning several buffers rolls back as a unit.
+ */
+TEST_F(ExportTupleStreamTest, RollbackBatchedAppend)
+{
+    for (int i = 1; i <= 3; i++) {
+        appendTuple(i-1, i, i);
+        commit(i);
+    }
+    std::vector<TableTuple> tuples(m_tuplesToFill * 2, *m_tuple);
+    size_t mark = m_wrapper->appendTuples(m_engine, 4, 4,
+                                          UniqueId::makeIdFromComponents(4 + VOLT_EPOCH_IN_MILLIS, 0, 0),
+                                          tuples, 1, ExportTupleStream::INSERT);
+    EXPECT_EQ(m_tupleSize * 3, mark);
+    EXPECT_EQ(4 + m_tuplesToFill * 2, m_wrapper->getSequenceNumber());
+    m_wrapper->rollbackExportTo(mark, 4);
+    EXPECT_EQ(4, m_wrapper->getSequenceNumber());
+
+    appendTuple(3, 4, 4);
+    commit(4);
+    periodicFlush(-1, 4);
+    ASSERT_TRUE(m_topend.receivedExportBuffer);
+    boost::shared_ptr<ExportStreamBlock> results = m_topend.exportBlocks.front();
+    m_topend.exportBlocks.pop_front();
+    EXPECT_EQ(results->uso(), 0);
+    EXPECT_EQ(results->offset(), (m_tupleSize * 4));
+    EXPECT_EQ(results->getRowCount(), 4);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -33,11 +33,13 @@
 #include "common/TupleSchemaBuilder.h"
 #include "common/types.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 
 #include "execution/VoltDBEngine.h"
 
 #include "indexes/tableindex.h"
 
+#include "storage/ConstraintFailureException.h"
 #include "storage/persistenttable.h"
 #include "storage/TableCatalogDelegate.hpp"
 #include "storage/tablefactory.h"
@@ -794,6 +796,107 @@ TEST_F(PersistentTableTest, SwapTablesTest) {
     rollback();
 }
 
+TEST_F(PersistentTableTest, BatchInsertTest) {
+    VoltDBEngine* engine = getEngine();
+    engine->loadCatalog(0, catalogPayload());
+    PersistentTable *table = dynamic_cast<PersistentTable*>(engine->getTableByName("T"));
+    ASSERT_NE(NULL, table);
+
+    // Rows arrive in descending key order and are inserted in ascending order.
+    const int batchSize = 100;
+    Pool pool;
+    std::vector<TableTuple> batch;
+    for (int i = batchSize; i > 0; --i) {
+        TableTuple tuple(static_cast<char*>(pool.allocateZeroes(table->schema()->tupleLength() + TUPLE_HEADER_SIZE)),
+                         table->schema());
+        tuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        tuple.setNValue(1, ValueFactory::getNullStringValue());
+        batch.push_back(tuple);
+    }
+    beginWork();
+    table->insertPersistentTuples(batch);
+    commit();
+    validateCounts(table, batchSize, 1);
+    ASSERT_EQ(1, ValuePeeker::peekAsBigInt(batch.front().getNValue(0)));
+    for (int i = 1; i <= batchSize; ++i) {
+        ASSERT_FALSE(findTuple(table, ValueFactory::getBigIntValue(i)).isNullTuple());
+    }
+
+    // A key repeated within the batch fails the batch before anything is inserted.
+    std::vector<TableTuple> duplicates;
+    for (int i = 0; i < 3; ++i) {
+        TableTuple tuple(static_cast<char*>(pool.allocateZeroes(table->schema()->tupleLength() + TUPLE_HEADER_SIZE)),
+                         table->schema());
+        tuple.setNValue(0, ValueFactory::getBigIntValue(batchSize + 1 + (i % 2)));
+        tuple.setNValue(1, ValueFactory::getNullStringValue());
+        duplicates.push_back(tuple);
+    }
+    beginWork();
+    bool threw = false;
+    try {
+        table->insertPersistentTuples(duplicates);
+    }
+    catch (ConstraintFailureException& e) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    rollback();
+    validateCounts(table, batchSize, 1);
+}
+
+TEST_F(PersistentTableTest, ContentDigestTest) {
+    VoltDBEngine* engine = getEngine();
+    engine->loadCatalog(0, catalogPayload());
+    PersistentTable *table = dynamic_cast<PersistentTable*>(engine->getTableByName("T"));
+    PersistentTable *other = dynamic_cast<PersistentTable*>(engine->getTableByName("X"));
+    ASSERT_NE(NULL, table);
+    ASSERT_NE(NULL, other);
+    ASSERT_EQ(0, table->hashCode());
+
+    // The same rows inserted in opposite orders give the same digest.
+    const int tupleCount = 50;
+    beginWork();
+    for (int i = 1; i <= tupleCount; ++i) {
+        TableTuple& tuple = table->tempTuple();
+        tuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("row" + std::to_string(i)));
+        table->insertTuple(tuple);
+    }
+    for (int i = tupleCount; i >= 1; --i) {
+        TableTuple& tuple = other->tempTuple();
+        tuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("row" + std::to_string(i)));
+        other->insertTuple(tuple);
+    }
+    commit();
+    size_t digest = table->hashCode();
+    ASSERT_NE(0, digest);
+    ASSERT_EQ(digest, table->recomputeHashCode());
+    ASSERT_EQ(digest, other->hashCode());
+
+    // Deletes and updates change the digest, and undoing them restores it.
+    beginWork();
+    TableTuple deleted = findTuple(table, ValueFactory::getBigIntValue(10));
+    table->deleteTuple(deleted, true);
+    ASSERT_EQ(table->recomputeHashCode(), table->hashCode());
+    TableTuple updated = findTuple(table, ValueFactory::getBigIntValue(20));
+    TableTuple& newValues = table->copyIntoTempTuple(updated);
+    newValues.setNValue(1, ValueFactory::getTempStringValue("updated"));
+    table->updateTuple(updated, newValues);
+    ASSERT_EQ(table->recomputeHashCode(), table->hashCode());
+    ASSERT_NE(digest, table->hashCode());
+    rollback();
+    ASSERT_EQ(digest, table->hashCode());
+    ASSERT_EQ(digest, table->recomputeHashCode());
+
+    beginWork();
+    deleted = findTuple(table, ValueFactory::getBigIntValue(10));
+    table->deleteTuple(deleted, true);
+    commit();
+    ASSERT_EQ(table->recomputeHashCode(), table->hashCode());
+    ASSERT_NE(digest, table->hashCode());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
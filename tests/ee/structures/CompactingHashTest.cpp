@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <cstdlib>
 #include <cmath>
@@ -249,6 +250,33 @@ TEST_F(CompactingHashTest, MissingByKey) {
     assert(erased);
 }
 
+TEST_F(CompactingHashTest, BatchedFind) {
+    typedef voltdb::CompactingHashTable<int64_t,int64_t> Table;
+    Table volt(false);
+
+    // Even keys only, with a second entry for each multiple of 4
+    for (int64_t i = 0; i < 1000; i += 2) {
+        volt.insert(i, i);
+        if (i % 4 == 0) {
+            volt.insert(i, -i);
+        }
+    }
+
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 1000; ++i) {
+        keys.push_back((i * 7) % 1000);
+    }
+    int count = static_cast<int>(keys.size());
+    std::vector<Table::iterator> found(count);
+    volt.find(keys.data(), found.data(), count);
+
+    for (int i = 0; i < count; ++i) {
+        Table::iterator expected = volt.find(keys[i]);
+        ASSERT_TRUE(found[i].equals(expected));
+        ASSERT_EQ(keys[i] % 2 == 0, !found[i].isEnd());
+    }
+}
+
 TEST_F(CompactingHashTest, ShrinkAndGrowUnique) {
     const int ITERATIONS = 10000;
 
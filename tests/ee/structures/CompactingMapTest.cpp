@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <cstdlib>
 #include <cstdio>
@@ -400,6 +401,48 @@ TEST_F(CompactingMapTest, Bounds) {
     ASSERT_TRUE(p.second.value() == 888);
 }
 
+TEST_F(CompactingMapTest, BatchedBounds) {
+    typedef voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator> Map;
+    Map volt(false, IntComparator());
+
+    // Odd keys 1 to 199, with three entries for each multiple of 5
+    for (int i = 1; i < 200; i += 2) {
+        volt.insert(std::pair<int,int>(i, i));
+        if (i % 5 == 0) {
+            volt.insert(std::pair<int,int>(i, -i));
+            volt.insert(std::pair<int,int>(i, i * 1000));
+        }
+    }
+
+    // More keys than one interleaved group, in no particular order
+    std::vector<int> keys;
+    for (int i = 0; i <= 201; ++i) {
+        keys.push_back((i * 37) % 202);
+    }
+    int count = static_cast<int>(keys.size());
+    std::vector<Map::iterator> found(count);
+    std::vector<Map::iterator> lowers(count);
+    std::vector<Map::iterator> uppers(count);
+    volt.find(keys.data(), found.data(), count);
+    volt.lowerBound(keys.data(), lowers.data(), count);
+    volt.upperBound(keys.data(), uppers.data(), count);
+
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(found[i].equals(volt.find(keys[i])));
+        ASSERT_TRUE(lowers[i].equals(volt.lowerBound(keys[i])));
+        ASSERT_TRUE(uppers[i].equals(volt.upperBound(keys[i])));
+        ASSERT_EQ(keys[i] % 2 == 1 && keys[i] < 200, !found[i].isEnd());
+    }
+
+    Map empty(true, IntComparator());
+    empty.lowerBound(keys.data(), lowers.data(), count);
+    empty.find(keys.data(), found.data(), count);
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(lowers[i].isEnd());
+        ASSERT_TRUE(found[i].isEnd());
+    }
+}
+
 TEST_F(CompactingMapTest, BenchmarkMulti) {
     const int ITERATIONS = 2000;
     const int BATCH_SIZE = 50;
@@ -115,6 +115,73 @@ TEST_F(CompactingPoolTest, bytes_allocated_test)
     }
 }
 
+TEST_F(CompactingPoolTest, deferred_compaction)
+{
+    const int32_t ELEMENT_SIZE = 17;
+    const int32_t ELEMENTS_PER_BUFFER = 7;
+    const int32_t BUFFER_BYTES = (ELEMENT_SIZE + CompactingPool::FIXED_OVERHEAD_PER_ENTRY()) * ELEMENTS_PER_BUFFER;
+    CompactingPool dut(ELEMENT_SIZE, ELEMENTS_PER_BUFFER, true);
+
+    // Fill two buffers and a bit.
+    const int32_t COUNT = ELEMENTS_PER_BUFFER * 2 + 1;
+    char* elems[COUNT];
+    for (int i = 0; i < COUNT; i++) {
+        elems[i] = reinterpret_cast<char*>(dut.malloc(&(elems[i])));
+        memset(elems[i], i, ELEMENT_SIZE);
+    }
+    EXPECT_EQ(BUFFER_BYTES * 3, dut.getBytesAllocated());
+
+    // Freeing in the middle leaves holes and moves nothing.
+    for (int i = 0; i < ELEMENTS_PER_BUFFER; i++) {
+        dut.free(elems[i]);
+    }
+    EXPECT_EQ(ELEMENTS_PER_BUFFER, dut.getHoleCount());
+    EXPECT_EQ(0, dut.getRelocationCount());
+    EXPECT_EQ(BUFFER_BYTES * 3, dut.getBytesAllocated());
+
+    // A new allocation reuses a hole.
+    char* reused = reinterpret_cast<char*>(dut.malloc(&reused));
+    EXPECT_EQ(ELEMENTS_PER_BUFFER - 1, dut.getHoleCount());
+    dut.free(reused);
+    EXPECT_EQ(ELEMENTS_PER_BUFFER, dut.getHoleCount());
+
+    // Compaction is incremental and keeps the referring pointers current.
+    EXPECT_EQ(2, dut.compact(2));
+    EXPECT_EQ(ELEMENTS_PER_BUFFER - 2, dut.getHoleCount());
+    EXPECT_EQ(BUFFER_BYTES * 2, dut.getBytesAllocated());
+    EXPECT_EQ(ELEMENTS_PER_BUFFER - 2, dut.compact(COUNT));
+    EXPECT_EQ(0, dut.getHoleCount());
+    EXPECT_EQ(ELEMENTS_PER_BUFFER, dut.getRelocationCount());
+    EXPECT_EQ(COUNT - ELEMENTS_PER_BUFFER, dut.getSlotCount());
+    for (int i = ELEMENTS_PER_BUFFER; i < COUNT; i++) {
+        EXPECT_EQ(i, *reinterpret_cast<int8_t*>(elems[i]));
+    }
+
+    for (int i = ELEMENTS_PER_BUFFER; i < COUNT; i++) {
+        dut.free(elems[i]);
+    }
+    dut.compact(COUNT);
+    EXPECT_EQ(0, dut.getSlotCount());
+    EXPECT_EQ(0, dut.getBytesAllocated());
+}
+
+TEST_F(CompactingPoolTest, deferred_compaction_trims_trailing_holes)
+{
+    CompactingPool dut(17, 7, true);
+    char* elems[3];
+    for (int i = 0; i < 3; i++) {
+        elems[i] = reinterpret_cast<char*>(dut.malloc(&(elems[i])));
+    }
+    dut.free(elems[1]);
+    EXPECT_EQ(1, dut.getHoleCount());
+    // Freeing the last entry also retires the hole just before it.
+    dut.free(elems[2]);
+    EXPECT_EQ(0, dut.getHoleCount());
+    EXPECT_EQ(1, dut.getSlotCount());
+    dut.free(elems[0]);
+    EXPECT_EQ(0, dut.getSlotCount());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
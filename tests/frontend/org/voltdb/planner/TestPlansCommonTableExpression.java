@@ -216,6 +216,55 @@ public class TestPlansCommonTableExpression extends PlannerTestCase {
         }
     }
 
+    public void testRecursiveUnionDistinct() throws Exception {
+        String format = "WITH RECURSIVE RT(ID, NAME) AS "
+                        + "("
+                        + "  SELECT ID, NAME FROM CTE_TABLE WHERE ID = ?"
+                        + "    %s "
+                        + "  SELECT CTE_TABLE.ID, CTE_TABLE.NAME "
+                        + "  FROM RT JOIN CTE_TABLE "
+                        + "          ON RT.ID IN (CTE_TABLE.LEFT_RENT, CTE_TABLE.RIGHT_RENT)"
+                        + ") "
+                        + "SELECT * FROM RT;";
+        String[] setOps = {"UNION", "UNION DISTINCT", "UNION ALL"};
+        for (String setOp : setOps) {
+            String SQL = String.format(format, setOp);
+            boolean unionDistinct = ! setOp.equals("UNION ALL");
+            try {
+                VoltXMLElement xml = compileToXML(SQL);
+                if (unionDistinct) {
+                    assertXPaths(xml,
+                            "/select/withClause[@recursive='true']/withList/withListElement[@uniondistinct='true']");
+                }
+                else {
+                    assertXPaths(xml,
+                            "/select/withClause[@recursive='true']/withList/withListElement[not(@uniondistinct)]");
+                }
+                CompiledPlan plan = compileAdHocPlanThrowing(SQL, false, true, DeterminismMode.SAFER);
+                assertNull(plan.subPlanGraph);
+                PlanNodeList pt = new PlanNodeList(plan.rootPlanGraph, false);
+                String planStr = pt.toJSONString();
+                assertEquals(setOp, unionDistinct, planStr.contains("\"UNION_DISTINCT\":true"));
+                JSONObject jsonPlan = new JSONObject(planStr);
+                JSONArray elists = jsonPlan.getJSONArray("EXECUTE_LISTS");
+                assertEquals(3, elists.length());
+
+                String explain = plan.rootPlanGraph.toExplainPlanString();
+                if (unionDistinct) {
+                    assertTrue(explain, explain.contains("ITERATE UNTIL NO NEW ROWS "));
+                    assertFalse(explain, explain.contains("ITERATE UNTIL EMPTY "));
+                }
+                else {
+                    assertTrue(explain, explain.contains("ITERATE UNTIL EMPTY "));
+                    assertFalse(explain, explain.contains("ITERATE UNTIL NO NEW ROWS "));
+                }
+            } catch (HSQLParseException e) {
+                e.printStackTrace();
+                fail();
+            }
+        }
+    }
+
     public void testCTEPartitioning() {
         CompiledPlan plan;
         String SQL;
@@ -431,15 +480,11 @@ public class TestPlansCommonTableExpression extends PlannerTestCase {
                 + "%s "
                 + "select * from the_cte) "
                 + "select * from the_cte";
-        String[] setOps = {"UNION", "INTERSECT", "EXCEPT"};
+        // UNION and UNION DISTINCT are allowed; see testRecursiveUnionDistinct.
+        String[] setOps = {"INTERSECT", "EXCEPT"};
         for (String setOp : setOps) {
             sql = String.format(format, setOp);
-            if (setOp.equals("UNION")) {
-                failToCompile(sql, "unexpected token: SELECT required: ALL");
-            }
-            else {
-                failToCompile(sql, "unexpected token: " + setOp + " required: UNION");
-            }
+            failToCompile(sql, "unexpected token: " + setOp + " required: UNION");
         }
 
         sql = "with recursive the_cte as ( "
@@ -430,6 +430,59 @@ public class TestCommonTableExpressionsSuite extends RegressionSuite {
         assertContentOfTable(EMPLOYEES_EXPECTED_RECURSIVE_RESULT, vt);
     }
 
+    public void testEmployeesRecursiveUnion() throws Exception {
+        Client client = getClient();
+        insertEmployees(client, "R_EMPLOYEES");
+
+        // Hunold also manages De Haan, and King reports to Austin, closing
+        // two cycles that UNION ALL would follow forever.
+        ClientResponse cr;
+        cr = client.callProcedure("R_EMPLOYEES.insert", "De Haan", 102, 103);
+        assertEquals(ClientResponse.SUCCESS, cr.getStatus());
+        cr = client.callProcedure("R_EMPLOYEES.insert", "King", 100, 105);
+        assertEquals(ClientResponse.SUCCESS, cr.getStatus());
+
+        final Object[][] expected = new Object[][] {
+            {"King",      100},
+            {"De Haan",   102},
+            {"Hunold",    103},
+            {"Ernst",     104},
+            {"Austin",    105},
+            {"Pataballa", 106},
+            {"Lorentz",   107},
+            {"Errazuriz", 147},
+            {"Cambrault", 148},
+            {"Ande",      166},
+            {"Banda",     167},
+            {"Ozer",      168},
+            {"Bloom",     169},
+            {"Fox",       170},
+            {"Smith",     171},
+            {"Bates",     172},
+            {"Kumar",     173}
+        };
+
+        String format = "WITH RECURSIVE EMP_TREE(LAST_NAME, EMP_ID) AS ( "
+                + "  SELECT LAST_NAME, EMP_ID "
+                + "  FROM R_EMPLOYEES "
+                + "  WHERE MANAGER_ID IS NULL "
+                + "%s "
+                + "  SELECT E.LAST_NAME, E.EMP_ID "
+                + "  FROM R_EMPLOYEES AS E JOIN EMP_TREE AS ET ON E.MANAGER_ID = ET.EMP_ID "
+                + ") "
+                + "SELECT * FROM EMP_TREE ORDER BY EMP_ID; ";
+        for (String setOp : new String[] {"UNION", "UNION DISTINCT"}) {
+            cr = client.callProcedure("@AdHoc", String.format(format, setOp));
+            assertEquals(ClientResponse.SUCCESS, cr.getStatus());
+            assertContentOfTable(expected, cr.getResults()[0]);
+
+            VoltTable vt = client.callProcedure("@Explain", String.format(format, setOp)).getResults()[0];
+            assertTrue(vt.advanceRow());
+            String plan = vt.getString("EXECUTION_PLAN");
+            assertTrue(plan, plan.contains("ITERATE UNTIL NO NEW ROWS "));
+        }
+    }
+
     public void testEmployeesNonRecursive() throws Exception {
         Client client = getClient();
         insertEmployees(client, "EMPLOYEES");
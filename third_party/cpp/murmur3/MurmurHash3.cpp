@@ -191,6 +191,34 @@ int32_t MurmurHash3_x64_128 ( const void * key, const int len,
   return static_cast<int32_t>(h1 >> 32);
 }
 
+void MurmurHash3_x64_128_int64s ( const int64_t * values, const int count,
+                                  int32_t * hashes )
+{
+  const uint64_t c1 = BIG_CONSTANT(0x87c37b91114253d5);
+  const uint64_t c2 = BIG_CONSTANT(0x4cf5ad432745937f);
+
+  for(int i = 0; i < count; i++)
+  {
+    // An 8 byte key with seed 0 is a single tail block in k1.  Reading the
+    // value as one word matches the byte wise tail on little endian hosts.
+    uint64_t k1 = static_cast<uint64_t>(values[i]);
+    k1 *= c1; k1  = ROTL64(k1,31); k1 *= c2;
+
+    uint64_t h1 = k1 ^ 8;
+    uint64_t h2 = 8;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+
+    h1 += h2;
+
+    hashes[i] = static_cast<int32_t>(h1 >> 32);
+  }
+}
+
 uint32_t MurmurHash3_x86_32 ( const void * key, uint32_t len,
                           uint32_t seed )
 {
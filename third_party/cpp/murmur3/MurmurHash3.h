@@ -45,6 +45,10 @@ inline int32_t MurmurHash3_x64_128 ( int64_t value) {
     return MurmurHash3_x64_128(value, 0);
 }
 
+// Same as MurmurHash3_x64_128(value) for each of count values, with the
+// 8 byte case unrolled so that independent values can be hashed in parallel
+void MurmurHash3_x64_128_int64s ( const int64_t * values, int count, int32_t * hashes );
+
 uint32_t MurmurHash3_x86_32(const void* key, uint32_t len, uint32_t seed);
 
 //-----------------------------------------------------------------------------